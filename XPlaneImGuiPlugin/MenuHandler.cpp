@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 
+#include "XPlaneMetrics.h"
+
 class MenuItem
 {
 public:
@@ -50,6 +52,10 @@ void MenuItem::menuHandler(void *mRef, void *iRef)
     auto it = menu->m_actions.find(static_cast<int>(item_id));
     if (it != menu->m_actions.end())
     {
+        static XPlaneMetrics::Counter &actions = XPlaneMetrics::counter("menu.actions", "Plugin menu items selected");
+        static XPlaneMetrics::Histogram &actionTime = XPlaneMetrics::histogram("menu.action_time", "ns", "Time spent in menu item actions");
+        actions.add();
+        XPlaneMetrics::ScopedTimer timer(actionTime);
         it->second();
     }
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef XPLANEFLIGHTRECORDER_H
+#define XPLANEFLIGHTRECORDER_H
+
+// Standard Library Headers
+#include <atomic>  // For std::atomic
+#include <cstddef> // For size_t
+#include <cstdint> // For fixed-width integers
+
+// On-disk layout of the crash flight recorder (<plugin>.flight).
+// The file is a header followed by a ring of fixed-size slots; each slot holds one binary
+// log record. This header has no dependencies so the offline decoder can share it.
+namespace XPlaneFlightRecorderFormat
+{
+    constexpr uint32_t kMagic = 0x52465058; // "XPFR"
+    constexpr uint32_t kVersion = 1;
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotSize;  // Bytes per slot, including the RecordHeader
+        uint32_t slotCount; // Number of slots in the ring
+        // Sequence number handed to the next record; slot index is sequence % slotCount
+        std::atomic<uint64_t> nextSequence;
+        uint8_t reserved[40];
+    };
+
+    struct RecordHeader
+    {
+        // Sequence number + 1 once the record is complete; 0 while it is being written.
+        // A crash mid-write therefore leaves a record the decoder can recognize and skip.
+        std::atomic<uint64_t> committed;
+        int64_t timestampNs; // Nanoseconds since the Unix epoch
+        uint64_t threadId;
+        uint8_t level; // spdlog::level::level_enum
+        uint8_t reserved;
+        uint16_t length; // Payload bytes that follow this header
+        uint32_t reserved2;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Flight recorder requires lock-free 64-bit atomics");
+    static_assert(sizeof(FileHeader) == 64, "FileHeader layout changed");
+    static_assert(sizeof(RecordHeader) == 32, "RecordHeader layout changed");
+} // namespace XPlaneFlightRecorderFormat
+
+#endif // XPLANEFLIGHTRECORDER_H
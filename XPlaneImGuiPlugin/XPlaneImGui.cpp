@@ -1,4 +1,5 @@
 // Standard Library Headers
+#include <chrono>
 #include <string.h>
 
 // Third-Party Library Headers
@@ -7,8 +8,14 @@
 
 // Project-Specific Headers
 #include "imgui_impl_xplane.h"
+#include "imgui_impl_xplane_hud.h"
+#include "imgui_impl_xplane_throttle.h"
 #include "MenuHandler.h"
 #include "XPlaneLog.h"
+#include "XPlaneLogViewer.h"
+#include "XPlaneMetrics.h"
+#include "XPlaneProfiler.h"
+#include "XPlaneTelemetryPublisher.h"
 #include "../third_party/fonts/fontawesome/fa-solid-900.inc"
 
 // X-Plane SDK Headers
@@ -32,6 +39,9 @@ struct WindowStates
     bool showPluginIntro = false;
     bool showPluginFeatures = false;
     bool showImGuiStandaloneExample = false;
+    bool showLogViewer = false;
+    bool showMetrics = false;
+    bool showPerformanceHUD = false;
     // Add more window states as needed
 };
 
@@ -62,6 +72,21 @@ void createMenu()
 
     g_menu->addSubItem("Toggle ImGui Standalone Example", []()
                        { g_windowStates.showImGuiStandaloneExample = !g_windowStates.showImGuiStandaloneExample; });
+
+    g_menu->addSubItem("Toggle Log Viewer", []()
+                       { g_windowStates.showLogViewer = !g_windowStates.showLogViewer; });
+
+    g_menu->addSubItem("Toggle Metrics", []()
+                       { g_windowStates.showMetrics = !g_windowStates.showMetrics; });
+
+    g_menu->addSubItem("Toggle Performance HUD", []()
+                       { g_windowStates.showPerformanceHUD = !g_windowStates.showPerformanceHUD; });
+    g_menu->addSubItem("Toggle Native Windows", []()
+                       { ImGui::XP::SetWindowMode(ImGui::XP::GetWindowMode() == ImGui::XP::WindowMode::NativeWindows ? ImGui::XP::WindowMode::FullScreenOverlay : ImGui::XP::WindowMode::NativeWindows); });
+
+    // Writes the last XPlaneProfiler::getDumpFrames() frames to a Chrome trace in the plugin folder
+    g_menu->addSubItem("Dump Profile", []()
+                       { XPlaneProfiler::dump(); });
     // Add more menu items as needed
 }
 
@@ -226,6 +251,27 @@ auto RenderPluginFeatures = []()
 };
 // clang-format on
 
+// Built-in log window fed by XPlaneLog
+void RenderLogViewer()
+{
+    if (XPlaneLogViewer *viewer = XPlaneLog::getViewer())
+    {
+        viewer->render(&g_windowStates.showLogViewer);
+    }
+}
+
+// Built-in metrics window fed by XPlaneMetrics
+void RenderMetrics()
+{
+    XPlaneMetrics::renderPanel(&g_windowStates.showMetrics);
+}
+
+// Built-in performance HUD: sim frame time against the overlay's own cost
+void RenderPerformanceHUD()
+{
+    ImGui::XP::RenderPerformanceHUD(&g_windowStates.showPerformanceHUD);
+}
+
 // Use to add selected glyphs to the default font
 static void AddGlyphsToFontDefault()
 {
@@ -310,9 +356,13 @@ static void LoadFonts()
 }
 
 // Use ImGuiRenderCallbackWrapper to wrap render callbacks, optionally passing a flag to enable/disable the callback
-auto XPlanePluginIntroRenderCallback = ImGui::XP::ImGuiRenderCallbackWrapper(XPlanePluginIntroRender);
-auto RenderPluginFeaturesCallback = ImGui::XP::ImGuiRenderCallbackWrapper(RenderPluginFeatures, &g_windowStates.showPluginFeatures);
-auto ImGuiStandaloneExampleCallback = ImGui::XP::ImGuiRenderCallbackWrapper(ImGuiStandaloneExample, &g_windowStates.showImGuiStandaloneExample);
+// and a name for the callback's zone in profiler traces
+auto XPlanePluginIntroRenderCallback = ImGui::XP::ImGuiRenderCallbackWrapper(XPlanePluginIntroRender, &g_windowStates.showPluginIntro, "Plugin Intro");
+auto RenderPluginFeaturesCallback = ImGui::XP::ImGuiRenderCallbackWrapper(RenderPluginFeatures, &g_windowStates.showPluginFeatures, "Plugin Features");
+auto ImGuiStandaloneExampleCallback = ImGui::XP::ImGuiRenderCallbackWrapper(ImGuiStandaloneExample, &g_windowStates.showImGuiStandaloneExample, "ImGui Standalone Example");
+auto LogViewerCallback = ImGui::XP::ImGuiRenderCallbackWrapper(RenderLogViewer, &g_windowStates.showLogViewer, "Log Viewer");
+auto MetricsCallback = ImGui::XP::ImGuiRenderCallbackWrapper(RenderMetrics, &g_windowStates.showMetrics, "Metrics");
+auto PerformanceHUDCallback = ImGui::XP::ImGuiRenderCallbackWrapper(RenderPerformanceHUD, &g_windowStates.showPerformanceHUD, "Performance HUD");
 
 PLUGIN_API int XPluginStart(char *out_name, char *out_signature, char *out_description)
 {
@@ -320,30 +370,54 @@ PLUGIN_API int XPluginStart(char *out_name, char *out_signature, char *out_descr
     strcpy(out_signature, "GitHub.1090MHz.XPlaneImGui");
     strcpy(out_description, "XPlane ImGui Plugin");
 
-    // Initialize the logger
-    XPlaneLog::init(out_name);
+    auto startTime = std::chrono::steady_clock::now();
 
-    ImGui::XP::Init();
+    // Initialize the logger
+    // Async mode keeps file I/O and XPLMDebugString off the calling thread, so logging is also safe from worker threads
+    XPlaneLog::Options logOptions;
+    logOptions.async = true;
+    logOptions.overflowPolicy = XPlaneLog::OverflowPolicy::Drop;
+    XPlaneLog::init(out_name, logOptions);
+
+    // Record timeline zones from the start, so "Dump Profile" can capture a stutter after it happened
+    XPlaneProfiler::init();
+
+    // Staged: the ImGui context, GL objects and fonts are created after the sim has loaded,
+    // or when a window is first shown, instead of adding to the sim's load time
+    ImGui::XP::InitOptions imguiOptions;
+    imguiOptions.mode = ImGui::XP::InitMode::Staged;
+    imguiOptions.loadFonts = []()
+    {
+        // Add FontAwesome icons to the default font
+        // AddFontAwesomeIcons();
+        AddGlyphsToFontDefault();
 
-    // Add FontAwesome icons to the default font
-    // AddFontAwesomeIcons();
-    AddGlyphsToFontDefault();
+        // Load additional fonts
+        LoadFonts();
+    };
+    ImGui::XP::Init(imguiOptions);
 
-    // Load additional fonts
-    LoadFonts();
+    // Expose the metrics to external monitors (see tools/TelemetryReader)
+    XPlaneTelemetryPublisher::init(out_name);
 
     // Initialize the menu
     createMenu(); // Assuming create_menu() is the function you've defined to set up the menu
 
-    XPlaneLog::info("Plugin started");
+    auto startMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    XPlaneLog::info("Plugin started in {:.2f} ms", startMs);
 
     return 1;
 }
 
 PLUGIN_API void XPluginStop(void)
 {
+    XPlaneTelemetryPublisher::shutdown();
     ImGui::XP::Shutdown();
+    XPlaneProfiler::shutdown();
     XPlaneLog::info("Plugin stopped");
+
+    // Stop the logger last so the messages above are written before the plugin is unloaded
+    XPlaneLog::shutdown();
 }
 
 PLUGIN_API void XPluginDisable(void)
@@ -352,6 +426,12 @@ PLUGIN_API void XPluginDisable(void)
     ImGui::XP::UnregisterImGuiRenderCallback(XPlanePluginIntroRenderCallback);
     ImGui::XP::UnregisterImGuiRenderCallback(RenderPluginFeaturesCallback);
     ImGui::XP::UnregisterImGuiRenderCallback(ImGuiStandaloneExampleCallback);
+    ImGui::XP::UnregisterImGuiRenderCallback(LogViewerCallback);
+    ImGui::XP::UnregisterImGuiRenderCallback(MetricsCallback);
+    ImGui::XP::UnregisterImGuiRenderCallback(PerformanceHUDCallback);
+
+    // Nothing can be shown while disabled, so don't hold GL objects and buffers meanwhile
+    ImGui::XP::TrimMemory();
 
     XPlaneLog::info("Plugin disabled");
 }
@@ -362,6 +442,9 @@ PLUGIN_API int XPluginEnable(void)
     ImGui::XP::RegisterImGuiRenderCallback(XPlanePluginIntroRenderCallback);
     ImGui::XP::RegisterImGuiRenderCallback(RenderPluginFeaturesCallback);
     ImGui::XP::RegisterImGuiRenderCallback(ImGuiStandaloneExampleCallback);
+    ImGui::XP::RegisterImGuiRenderCallback(LogViewerCallback);
+    ImGui::XP::RegisterImGuiRenderCallback(MetricsCallback);
+    ImGui::XP::RegisterImGuiRenderCallback(PerformanceHUDCallback);
 
     XPlaneLog::info("Plugin enabled");
 
@@ -370,4 +453,6 @@ PLUGIN_API int XPluginEnable(void)
 
 PLUGIN_API void XPluginReceiveMessage(XPLMPluginID in_from, int in_msg, void *in_param)
 {
+    // Aircraft and scenery loads throttle or suspend the ImGui frames
+    ImGui::XP::HandleSimMessage(in_from, in_msg, in_param);
 }
@@ -1,14 +1,21 @@
 #include "XPlaneLog.h"
+#include "XPlaneLogAsync.h"
+#include "XPlaneLogFlightRecorder.h"
+#include "XPlaneLogStructured.h"
+#include "XPlaneLogThrottle.h"
+#include "XPlaneLogViewer.h"
+#include "XPlaneMetrics.h"
+#include "XPlaneProfiler.h"
 
 // Standard Library Headers
 #include <filesystem> // For handling file system paths
 #include <memory>     // For std::shared_ptr and std::make_shared
 #include <mutex>      // For std::mutex used in custom sink
 #include <string>     // For std::string
+#include <vector>     // For std::vector
 
 // Third-Party Library Headers
 #include <spdlog/details/log_msg.h>          // For spdlog::details::log_msg
-#include <spdlog/pattern_formatter.h>        // For spdlog::pattern_formatter
 #include <spdlog/sinks/basic_file_sink.h>    // For spdlog::sinks::basic_file_sink_mt
 #include <spdlog/sinks/stdout_color_sinks.h> // For spdlog::sinks::stdout_color_sink_mt
 #include <spdlog/spdlog.h>                   // For spdlog logging functions
@@ -18,8 +25,17 @@
 #include "XPLMPlugin.h"    // For XPLMGetMyID
 
 std::shared_ptr<spdlog::logger> XPlaneLog::logger = nullptr;
+std::unique_ptr<XPlaneLogAsync> XPlaneLog::async_pipeline = nullptr;
+std::shared_ptr<XPlaneLogThrottleSink> XPlaneLog::throttle_sink = nullptr;
+std::unique_ptr<XPlaneLogViewer> XPlaneLog::log_viewer = nullptr;
+int XPlaneLog::metrics_collector = 0;
 
 void XPlaneLog::init(const std::string &plugin_name)
+{
+    init(plugin_name, Options());
+}
+
+void XPlaneLog::init(const std::string &plugin_name, const Options &options)
 {
 
     // Ensure the logger is not already initialized
@@ -28,9 +44,6 @@ void XPlaneLog::init(const std::string &plugin_name)
         return;
     }
 
-    // Create an XPlaneLog::Sink instance
-    auto xplane_sink = std::make_shared<Sink>();
-
     // Optionally, create other sinks (e.g., console and file sinks)
     auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
 
@@ -49,14 +62,48 @@ void XPlaneLog::init(const std::string &plugin_name)
 
     std::filesystem::path logFileName = sanitized_plugin_name + ".log";
     std::filesystem::path logFilePath = path.parent_path() / logFileName;
+    std::filesystem::path flightRecorderPath = path.parent_path() / (sanitized_plugin_name + ".flight");
 
     auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logFilePath.string(), true);
 
-    spdlog::sinks_init_list sink_list = {console_sink, file_sink, xplane_sink};
-    logger = std::make_shared<spdlog::logger>(plugin_name, sink_list.begin(), sink_list.end());
+    // Sinks that receive messages after throttling
+    std::vector<spdlog::sink_ptr> sinks{console_sink, file_sink};
+    if (options.viewerLines > 0)
+    {
+        log_viewer = std::make_unique<XPlaneLogViewer>(options.viewerLines, options.viewerTextBytes);
+        sinks.push_back(log_viewer->sink());
+    }
+
+    if (options.async)
+    {
+        // The worker thread writes the console, file and viewer sinks and batches XPLMDebugString output
+        // for the main thread, so the logger itself only has the queueing front sink
+        console_sink->set_formatter(std::make_unique<XPlaneLog::Formatter>());
+        file_sink->set_formatter(std::make_unique<XPlaneLog::Formatter>());
+
+        async_pipeline = std::make_unique<XPlaneLogAsync>(plugin_name, options);
+        sinks.push_back(async_pipeline->debugSink());
+
+        // Throttle on the worker, behind the queue: producers only touch the lock-free ring, and
+        // the throttle's lock and dedup copy stay off their threads
+        throttle_sink = std::make_shared<XPlaneLogThrottleSink>(options, sinks);
+        async_pipeline->setFlushLevel(spdlog::level::info);
+        async_pipeline->start({throttle_sink});
+
+        logger = std::make_shared<spdlog::logger>(plugin_name, async_pipeline->frontSink());
+    }
+    else
+    {
+        // Create an XPlaneLog::Sink instance
+        auto xplane_sink = std::make_shared<Sink>();
+        sinks.push_back(xplane_sink);
+
+        throttle_sink = std::make_shared<XPlaneLogThrottleSink>(options, sinks);
+        logger = std::make_shared<spdlog::logger>(plugin_name, throttle_sink);
 
-    // Set a custom formatter for the logger
-    logger->set_formatter(std::make_unique<XPlaneLog::Formatter>());
+        // Set a custom formatter for the logger (the throttle sink passes it on to the sinks behind it)
+        logger->set_formatter(std::make_unique<XPlaneLog::Formatter>());
+    }
 
     // Register the logger with spdlog registry for future extensibility:
     // - Allows retrieval by name using spdlog::get("plugin_name")
@@ -67,16 +114,62 @@ void XPlaneLog::init(const std::string &plugin_name)
     spdlog::set_default_logger(logger);
     spdlog::set_level(spdlog::level::debug); // Set global log level to debug
     spdlog::flush_on(spdlog::level::info);   // Flush logs on info level and higher
+
+    if (options.flightRecorderSlots > 0)
+    {
+        // The recorder sits beside the throttle (or the queue in front of it) so it sees every
+        // record, including trace
+        auto recorder_sink = std::make_shared<XPlaneLogFlightRecorderSink>(flightRecorderPath.string(), options.flightRecorderSlots, options.flightRecorderSlotSize);
+        if (recorder_sink->isOpen())
+        {
+            // The throttle or the front sink: trace stays out of the other sinks
+            logger->sinks().front()->set_level(spdlog::level::debug);
+            logger->sinks().push_back(recorder_sink);
+            logger->set_level(spdlog::level::trace);
+        }
+        else
+        {
+            warn("Could not create flight recorder at {}", flightRecorderPath.string());
+        }
+    }
+
+    metrics_collector = XPlaneMetrics::addCollector(collectMetrics);
+
+    if (options.structuredLog)
+    {
+        std::filesystem::path structuredLogPath = path.parent_path() / (sanitized_plugin_name + ".binlog");
+        if (!XPlaneLogStructured::start(structuredLogPath.string()))
+        {
+            warn("Could not create structured log at {}", structuredLogPath.string());
+        }
+    }
 }
 
 void XPlaneLog::shutdown()
 {
+    XPlaneMetrics::removeCollector(metrics_collector);
+    metrics_collector = 0;
+
+    // No-op unless Options::structuredLog started it
+    XPlaneLogStructured::stop();
+
     if (logger)
     {
         logger->flush();
         spdlog::drop_all(); // Drops all registered loggers
         logger = nullptr;
+        throttle_sink = nullptr;
     }
+
+    if (async_pipeline)
+    {
+        // Write out everything still queued before the plugin is unloaded
+        async_pipeline->stop();
+        async_pipeline = nullptr;
+    }
+
+    // Only after the worker that feeds it has stopped
+    log_viewer = nullptr;
 }
 
 void XPlaneLog::trace(const std::string &message)
@@ -109,49 +202,65 @@ void XPlaneLog::critical(const std::string &message)
     logger->critical(message);
 }
 
-// Implementation of the custom sink for X-Plane
-void XPlaneLog::Sink::sink_it_(const spdlog::details::log_msg &msg)
+XPlaneLog::AsyncStats XPlaneLog::getAsyncStats()
 {
-    // Format the message
-    spdlog::memory_buf_t formatted;
-    base_sink<std::mutex>::formatter_->format(msg, formatted);
-
-    // Write the message to X-Plane Log.txt using XPLMDebugString
-    XPLMDebugString(fmt::to_string(formatted).c_str());
+    if (async_pipeline)
+    {
+        return async_pipeline->stats();
+    }
+    return AsyncStats();
 }
 
-void XPlaneLog::Sink::flush_()
+XPlaneLog::ThrottleStats XPlaneLog::getThrottleStats()
 {
-    // Flush function can be empty as XPLMDebugString doesn't have a corresponding flush function
+    if (throttle_sink)
+    {
+        return throttle_sink->stats();
+    }
+    return ThrottleStats();
 }
 
-void XPlaneLog::Formatter::format(const spdlog::details::log_msg &msg, spdlog::memory_buf_t &dest)
+XPlaneLogViewer *XPlaneLog::getViewer()
 {
-    // Extract and convert log level to uppercase
-    std::string log_level = spdlog::level::to_string_view(msg.level).data();
-    std::transform(log_level.begin(), log_level.end(), log_level.begin(), ::toupper);
+    return log_viewer.get();
+}
 
-    // Create a custom pattern that includes the uppercase log level
-    std::string pattern = "[%Y-%m-%d %H:%M:%S.%e] [%n] [" + log_level + "] %v";
+void XPlaneLog::collectMetrics()
+{
+    static XPlaneMetrics::Counter &enqueued = XPlaneMetrics::counter("log.enqueued", "Messages queued for the async worker");
+    static XPlaneMetrics::Counter &dropped = XPlaneMetrics::counter("log.dropped", "Messages dropped because the async queue was full");
+    static XPlaneMetrics::Gauge &queueDepth = XPlaneMetrics::gauge("log.queue_depth", "Messages waiting in the async queue");
+    static XPlaneMetrics::Gauge &maxQueueDepth = XPlaneMetrics::gauge("log.max_queue_depth", "Highest async queue depth seen");
+    static XPlaneMetrics::Counter &duplicates = XPlaneMetrics::counter("log.suppressed_duplicates", "Repeated messages collapsed by the throttle");
+    static XPlaneMetrics::Counter &rateLimited = XPlaneMetrics::counter("log.suppressed_rate_limited", "Messages dropped by the per call-site rate limit");
+
+    AsyncStats async = getAsyncStats();
+    enqueued.syncTotal(async.enqueued);
+    dropped.syncTotal(async.dropped);
+    queueDepth.set(static_cast<double>(async.queueDepth));
+    maxQueueDepth.set(static_cast<double>(async.maxQueueDepth));
+
+    ThrottleStats throttle = getThrottleStats();
+    duplicates.syncTotal(throttle.suppressedDuplicates);
+    rateLimited.syncTotal(throttle.suppressedRateLimited);
+}
 
-    // Use the pattern formatter with the custom pattern to format the message
-    spdlog::pattern_formatter formatter(pattern);
-    formatter.format(msg, dest);
+// Implementation of the custom sink for X-Plane
+void XPlaneLog::Sink::sink_it_(const spdlog::details::log_msg &msg)
+{
+    XP_PROFILE_SCOPE("XPlaneLog::Sink");
+    // Format the message into a stack buffer
+    spdlog::memory_buf_t formatted;
+    base_sink<std::mutex>::formatter_->format(msg, formatted);
 
-    // Convert to string
-    std::string formatted_str = fmt::to_string(dest);
+    // Null-terminate in place instead of copying into a std::string
+    formatted.push_back('\0');
 
-    // Ensure it ends with a single newline
-    if (!formatted_str.empty())
-    {
-        // Remove any existing CR or LF characters
-        formatted_str.erase(std::remove(formatted_str.begin(), formatted_str.end(), '\r'), formatted_str.end());
-        formatted_str.erase(std::remove(formatted_str.begin(), formatted_str.end(), '\n'), formatted_str.end());
-        // Add a single newline character
-        formatted_str += '\n';
-    }
+    // Write the message to X-Plane Log.txt using XPLMDebugString
+    XPLMDebugString(formatted.data());
+}
 
-    // Clear the destination buffer and append the formatted string
-    dest.clear();
-    fmt::format_to(std::back_inserter(dest), "{}", formatted_str);
+void XPlaneLog::Sink::flush_()
+{
+    // Flush function can be empty as XPLMDebugString doesn't have a corresponding flush function
 }
@@ -2,20 +2,96 @@
 #define XPLANELOG_H
 
 // Standard Library Headers
-#include <string> // For std::string
-#include <memory> // For std::shared_ptr
-#include <mutex>  // For std::mutex
+#include <array>   // For std::array
+#include <chrono>  // For std::chrono::milliseconds
+#include <cstdint> // For uint64_t
+#include <string>  // For std::string
+#include <memory>  // For std::shared_ptr
+#include <mutex>   // For std::mutex
+#include <utility> // For std::forward
 
 // Third-Party Library Headers
 #include <spdlog/spdlog.h>          // For spdlog logging functions
 #include <spdlog/sinks/base_sink.h> // For spdlog::sinks::base_sink
 #include <spdlog/details/log_msg.h> // For spdlog::details::log_msg
 
+// Compile-time minimum log level, using spdlog's numbering (0 = trace, 1 = debug, 2 = info, ...).
+// XPLOG_* macros below this level expand to nothing, so their arguments are never evaluated.
+// Release builds drop trace and debug by default; define XPLANELOG_ACTIVE_LEVEL to override.
+#ifndef XPLANELOG_ACTIVE_LEVEL
+#ifdef NDEBUG
+#define XPLANELOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
+#else
+#define XPLANELOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+#endif
+
+class XPlaneLogAsync;
+class XPlaneLogThrottleSink;
+class XPlaneLogViewer;
+
 class XPlaneLog
 {
 public:
+    // What an async logger does when its queue is full
+    enum class OverflowPolicy
+    {
+        Drop,           // Discard the new message
+        Block,          // Wait for the worker thread to make room
+        OverwriteOldest // Discard the oldest queued message to make room
+    };
+
+    // Logger configuration
+    struct Options
+    {
+        // Queue messages and write them from a worker thread; XPLMDebugString output is drained on the main thread
+        bool async = false;
+        // Capacity of the async queue in messages (rounded up to a power of two)
+        size_t queueCapacity = 8192;
+        OverflowPolicy overflowPolicy = OverflowPolicy::Drop;
+
+        // Collapse identical consecutive messages within this window into one "repeated N times" line (0 disables)
+        std::chrono::milliseconds dedupWindow{1000};
+        // Per call-site token bucket: sustained messages per second and burst size (rate 0 disables)
+        double rateLimitPerSecond = 20.0;
+        double rateLimitBurst = 50.0;
+
+        // Crash flight recorder: a memory-mapped ring of the most recent records, written to
+        // <plugin>.flight next to the .log at trace level. Off by default: enabling it lowers the
+        // logger level to trace, so every trace statement is formatted; the other sinks stay at
+        // debug. 16384 slots of 256 bytes (4 MB) keep a few minutes of a busy plugin.
+        size_t flightRecorderSlots = 0;
+        size_t flightRecorderSlotSize = 256;
+
+        // Binary structured log for XPLOG_STRUCTURED records, written to <plugin>.binlog next to the
+        // .log and decoded offline with the StructuredLogDecode tool
+        bool structuredLog = false;
+
+        // In-sim log viewer: the most recent lines kept in memory for XPlaneLogViewer, from the first
+        // time its window is drawn (about 5.5 MB by default). Set viewerLines to 0 to disable.
+        size_t viewerLines = 1 << 16;
+        size_t viewerTextBytes = 4 * 1024 * 1024;
+    };
+
+    // Counters for the async pipeline (all zero in synchronous mode)
+    struct AsyncStats
+    {
+        uint64_t enqueued = 0;
+        uint64_t dropped = 0;
+        size_t queueDepth = 0;
+        size_t maxQueueDepth = 0;
+    };
+
+    // Counters for the throttling layer in front of the sinks
+    struct ThrottleStats
+    {
+        uint64_t suppressedDuplicates = 0;
+        uint64_t suppressedRateLimited = 0;
+    };
+
     // Initialize the logger
     static void init(const std::string &plugin_name);
+    static void init(const std::string &plugin_name, const Options &options);
 
     // Shutdown the logger and clean up resources
     static void shutdown();
@@ -38,19 +114,95 @@ public:
     // Log a critical message
     static void critical(const std::string &message);
 
-private:
-    // Custom sink for X-Plane
-    class Sink : public spdlog::sinks::base_sink<std::mutex>
+    // Formatting overloads: the level is checked before any argument is formatted, so a disabled
+    // statement costs a branch rather than a string allocation. Trace and debug compile to nothing
+    // below XPLANELOG_ACTIVE_LEVEL.
+    template <typename Arg, typename... Args>
+    static void trace(spdlog::format_string_t<Arg, Args...> fmt, Arg &&arg, Args &&...args)
     {
-    protected:
-        void sink_it_(const spdlog::details::log_msg &msg) override;
-        void flush_() override;
-    };
+        if constexpr (XPLANELOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE)
+        {
+            log(formatSite<Arg, Args...>(fmt), spdlog::level::trace, fmt, std::forward<Arg>(arg), std::forward<Args>(args)...);
+        }
+    }
+
+    template <typename Arg, typename... Args>
+    static void debug(spdlog::format_string_t<Arg, Args...> fmt, Arg &&arg, Args &&...args)
+    {
+        if constexpr (XPLANELOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG)
+        {
+            log(formatSite<Arg, Args...>(fmt), spdlog::level::debug, fmt, std::forward<Arg>(arg), std::forward<Args>(args)...);
+        }
+    }
+
+    template <typename Arg, typename... Args>
+    static void info(spdlog::format_string_t<Arg, Args...> fmt, Arg &&arg, Args &&...args)
+    {
+        log(formatSite<Arg, Args...>(fmt), spdlog::level::info, fmt, std::forward<Arg>(arg), std::forward<Args>(args)...);
+    }
+
+    template <typename Arg, typename... Args>
+    static void warn(spdlog::format_string_t<Arg, Args...> fmt, Arg &&arg, Args &&...args)
+    {
+        log(formatSite<Arg, Args...>(fmt), spdlog::level::warn, fmt, std::forward<Arg>(arg), std::forward<Args>(args)...);
+    }
+
+    template <typename Arg, typename... Args>
+    static void error(spdlog::format_string_t<Arg, Args...> fmt, Arg &&arg, Args &&...args)
+    {
+        log(formatSite<Arg, Args...>(fmt), spdlog::level::err, fmt, std::forward<Arg>(arg), std::forward<Args>(args)...);
+    }
+
+    template <typename Arg, typename... Args>
+    static void critical(spdlog::format_string_t<Arg, Args...> fmt, Arg &&arg, Args &&...args)
+    {
+        log(formatSite<Arg, Args...>(fmt), spdlog::level::critical, fmt, std::forward<Arg>(arg), std::forward<Args>(args)...);
+    }
+
+    // Log at an explicit level and call site; used by the XPLOG_* macros
+    template <typename... Args>
+    static void log(spdlog::source_loc source, spdlog::level::level_enum level, spdlog::format_string_t<Args...> fmt, Args &&...args)
+    {
+        if (should_log(level))
+        {
+            logger->log(source, level, fmt, std::forward<Args>(args)...);
+        }
+    }
+
+    // Call site of a formatting overload, which has no source location: the address of its format
+    // string, carried in funcname with line 0 so formatters still treat the location as empty.
+    // The throttle keys its rate limit on it.
+    template <typename... Args>
+    static spdlog::source_loc formatSite(spdlog::format_string_t<Args...> fmt)
+    {
+        return spdlog::source_loc(nullptr, 0, spdlog::string_view_t(fmt).data());
+    }
+
+    // True if a message at this level would be written
+    static bool should_log(spdlog::level::level_enum level)
+    {
+        return logger && logger->should_log(level);
+    }
+
+    // Snapshot of the async pipeline counters
+    static AsyncStats getAsyncStats();
+
+    // Snapshot of the dedup and rate limit counters
+    static ThrottleStats getThrottleStats();
+
+    // In-sim log viewer, or nullptr if disabled
+    static XPlaneLogViewer *getViewer();
 
     // Custom formatter for X-Plane
+    // One pattern formatter is compiled per log level at construction, so formatting a message
+    // writes straight into the destination buffer without building patterns or strings.
+    // Public so the logging benchmark can exercise it without the X-Plane SDK.
     class Formatter : public spdlog::formatter
     {
     public:
+        Formatter();
+        Formatter(const Formatter &other);
+
         void format(const spdlog::details::log_msg &msg, spdlog::memory_buf_t &dest) override;
         std::unique_ptr<spdlog::formatter> clone() const override
         {
@@ -58,9 +210,75 @@ private:
         }
 
         virtual ~Formatter() {} // Required for abstract class
+
+    private:
+        // Precompiled "[time] [name] [LEVEL] message" formatters, indexed by spdlog::level::level_enum
+        std::array<std::unique_ptr<spdlog::formatter>, spdlog::level::n_levels> m_levelFormatters;
+    };
+
+private:
+    // Custom sink for X-Plane
+    class Sink : public spdlog::sinks::base_sink<std::mutex>
+    {
+    protected:
+        void sink_it_(const spdlog::details::log_msg &msg) override;
+        void flush_() override;
     };
 
     static std::shared_ptr<spdlog::logger> logger;
+
+    // Async pipeline, only present when initialized with Options::async
+    static std::unique_ptr<XPlaneLogAsync> async_pipeline;
+
+    // Dedup and rate limit layer between the logger and its sinks
+    static std::shared_ptr<XPlaneLogThrottleSink> throttle_sink;
+
+    // Recent lines for the in-sim viewer
+    static std::unique_ptr<XPlaneLogViewer> log_viewer;
+
+    // Publishes the async and throttle stats as XPlaneMetrics counters and gauges
+    static void collectMetrics();
+    static int metrics_collector;
 };
 
+// Level-gated logging macros that record the call site.
+// Statements below XPLANELOG_ACTIVE_LEVEL are removed entirely, including their arguments.
+#define XPLOG_CALL(level, ...) XPlaneLog::log(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, level, __VA_ARGS__)
+
+#if XPLANELOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define XPLOG_TRACE(...) XPLOG_CALL(spdlog::level::trace, __VA_ARGS__)
+#else
+#define XPLOG_TRACE(...) (void)0
+#endif
+
+#if XPLANELOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define XPLOG_DEBUG(...) XPLOG_CALL(spdlog::level::debug, __VA_ARGS__)
+#else
+#define XPLOG_DEBUG(...) (void)0
+#endif
+
+#if XPLANELOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define XPLOG_INFO(...) XPLOG_CALL(spdlog::level::info, __VA_ARGS__)
+#else
+#define XPLOG_INFO(...) (void)0
+#endif
+
+#if XPLANELOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define XPLOG_WARN(...) XPLOG_CALL(spdlog::level::warn, __VA_ARGS__)
+#else
+#define XPLOG_WARN(...) (void)0
+#endif
+
+#if XPLANELOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define XPLOG_ERROR(...) XPLOG_CALL(spdlog::level::err, __VA_ARGS__)
+#else
+#define XPLOG_ERROR(...) (void)0
+#endif
+
+#if XPLANELOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+#define XPLOG_CRITICAL(...) XPLOG_CALL(spdlog::level::critical, __VA_ARGS__)
+#else
+#define XPLOG_CRITICAL(...) (void)0
+#endif
+
 #endif // XPLANELOG_H
\ No newline at end of file
@@ -0,0 +1,368 @@
+#include "XPlaneLogAsync.h"
+
+// Standard Library Headers
+#include <chrono>  // For std::chrono::milliseconds
+#include <cstring> // For std::memcpy
+
+// X-Plane SDK Headers
+#include "XPLMProcessing.h" // For XPLMRegisterFlightLoopCallback
+#include "XPLMUtilities.h"  // For XPLMDebugString
+
+// Project-Specific Headers
+#include "XPlaneProfiler.h"
+
+// XPlaneLogRecord
+
+void XPlaneLogRecord::assign(const spdlog::details::log_msg &msg)
+{
+    level = msg.level;
+    time = msg.time;
+    threadId = msg.thread_id;
+    source = msg.source;
+    length = msg.payload.size();
+    if (length <= kInlinePayload)
+    {
+        std::memcpy(inlinePayload, msg.payload.data(), length);
+    }
+    else
+    {
+        overflowPayload.assign(msg.payload.data(), length);
+    }
+}
+
+void XPlaneLogRecord::assign(const XPlaneLogRecord &other)
+{
+    level = other.level;
+    time = other.time;
+    threadId = other.threadId;
+    source = other.source;
+    length = other.length;
+    if (length <= kInlinePayload)
+    {
+        std::memcpy(inlinePayload, other.inlinePayload, length);
+    }
+    else
+    {
+        overflowPayload.assign(other.overflowPayload);
+    }
+}
+
+spdlog::string_view_t XPlaneLogRecord::text() const
+{
+    if (length <= kInlinePayload)
+    {
+        return spdlog::string_view_t(inlinePayload, length);
+    }
+    return spdlog::string_view_t(overflowPayload.data(), length);
+}
+
+// XPlaneLogRing
+
+XPlaneLogRing::XPlaneLogRing(size_t capacity)
+{
+    size_t roundedCapacity = 2;
+    while (roundedCapacity < capacity)
+    {
+        roundedCapacity <<= 1;
+    }
+
+    m_slots.reset(new Slot[roundedCapacity]);
+    m_mask = roundedCapacity - 1;
+
+    for (size_t i = 0; i < roundedCapacity; ++i)
+    {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool XPlaneLogRing::tryPush(const spdlog::details::log_msg &msg)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot &slot = m_slots[pos & m_mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+        if (difference == 0)
+        {
+            // The slot is free for this position; claim it
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                slot.record.assign(msg);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The consumer has not released this slot yet: the queue is full
+            return false;
+        }
+        else
+        {
+            // Another producer claimed this position first
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool XPlaneLogRing::tryPop(XPlaneLogRecord &record)
+{
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot &slot = m_slots[pos & m_mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+        if (difference == 0)
+        {
+            // The slot holds a published record for this position; claim it
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                record.assign(slot.record);
+                slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Nothing published at this position: the queue is empty
+            return false;
+        }
+        else
+        {
+            // Another consumer claimed this position first
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t XPlaneLogRing::size() const
+{
+    size_t enqueuePos = m_enqueuePos.load(std::memory_order_relaxed);
+    size_t dequeuePos = m_dequeuePos.load(std::memory_order_relaxed);
+    return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+}
+
+// XPlaneLogAsync
+
+XPlaneLogAsync::XPlaneLogAsync(const std::string &loggerName, const XPlaneLog::Options &options)
+    : m_loggerName(loggerName),
+      m_overflowPolicy(options.overflowPolicy),
+      m_ring(options.queueCapacity)
+{
+    m_frontSink = std::make_shared<FrontSink>(*this);
+    m_debugSink = std::make_shared<DebugSink>(*this);
+    m_pendingDebugText.reserve(64 * 1024);
+    m_drainingDebugText.reserve(64 * 1024);
+}
+
+XPlaneLogAsync::~XPlaneLogAsync()
+{
+    stop();
+}
+
+void XPlaneLogAsync::start(std::vector<spdlog::sink_ptr> workerSinks)
+{
+    if (m_running)
+    {
+        return;
+    }
+
+    m_workerSinks = std::move(workerSinks);
+
+    m_stopping.store(false);
+    m_worker = std::thread(&XPlaneLogAsync::workerLoop, this);
+
+    // Drain XPLMDebugString output once per frame on the main thread
+    XPLMRegisterFlightLoopCallback(DrainFlightLoopCallback, -1.0f, this);
+    m_running = true;
+}
+
+void XPlaneLogAsync::stop()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    XPLMUnregisterFlightLoopCallback(DrainFlightLoopCallback, this);
+
+    // The worker empties the queue before it exits
+    m_stopping.store(true);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.notify_one();
+    }
+    m_worker.join();
+    m_running = false;
+
+    // We are on the main thread, so whatever is left can go straight to X-Plane
+    drainDebugText();
+}
+
+XPlaneLog::AsyncStats XPlaneLogAsync::stats() const
+{
+    XPlaneLog::AsyncStats stats;
+    stats.enqueued = m_enqueued.load(std::memory_order_relaxed);
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    stats.queueDepth = m_ring.size();
+    stats.maxQueueDepth = m_maxQueueDepth.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void XPlaneLogAsync::enqueue(const spdlog::details::log_msg &msg)
+{
+    XP_PROFILE_SCOPE("XPlaneLogAsync::enqueue");
+    while (!m_ring.tryPush(msg))
+    {
+        // Blocking on a stopped worker would never return, so fall back to dropping
+        if (m_overflowPolicy == XPlaneLog::OverflowPolicy::Drop || m_stopping.load(std::memory_order_relaxed))
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (m_overflowPolicy == XPlaneLog::OverflowPolicy::OverwriteOldest)
+        {
+            // Make room by discarding the oldest record, then retry
+            static thread_local XPlaneLogRecord discarded;
+            if (m_ring.tryPop(discarded))
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        else
+        {
+            // OverflowPolicy::Block: let the worker catch up
+            wakeWorker();
+            std::this_thread::yield();
+        }
+    }
+
+    m_enqueued.fetch_add(1, std::memory_order_relaxed);
+
+    // Track the high-water mark of the queue
+    size_t depth = m_ring.size();
+    size_t maxDepth = m_maxQueueDepth.load(std::memory_order_relaxed);
+    while (depth > maxDepth && !m_maxQueueDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed))
+    {
+    }
+
+    wakeWorker();
+}
+
+void XPlaneLogAsync::wakeWorker()
+{
+    // Only pay for the mutex and notify when the worker is actually asleep
+    if (m_workerWaiting.load())
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.notify_one();
+    }
+}
+
+void XPlaneLogAsync::workerLoop()
+{
+    XPlaneProfiler::setThreadName("Log worker");
+    XPlaneLogRecord record;
+
+    for (;;)
+    {
+        bool needsFlush = false;
+        while (m_ring.tryPop(record))
+        {
+            writeRecord(record, needsFlush);
+        }
+
+        if (needsFlush)
+        {
+            for (auto &sink : m_workerSinks)
+            {
+                sink->flush();
+            }
+        }
+
+        if (m_stopping.load() && m_ring.size() == 0)
+        {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_workerWaiting.store(true);
+        // The timeout bounds the latency of a missed wake-up
+        m_wakeCondition.wait_for(lock, std::chrono::milliseconds(50), [this]
+                                 { return m_stopping.load() || m_ring.size() > 0; });
+        m_workerWaiting.store(false);
+    }
+
+    for (auto &sink : m_workerSinks)
+    {
+        sink->flush();
+    }
+}
+
+void XPlaneLogAsync::writeRecord(const XPlaneLogRecord &record, bool &needsFlush)
+{
+    XP_PROFILE_SCOPE("XPlaneLogAsync::writeRecord");
+    // Rebuild the message as the logger produced it
+    spdlog::details::log_msg msg(record.source, m_loggerName, record.level, record.text());
+    msg.time = record.time;
+    msg.thread_id = record.threadId;
+
+    for (auto &sink : m_workerSinks)
+    {
+        if (sink->should_log(msg.level))
+        {
+            sink->log(msg);
+        }
+    }
+
+    if (msg.level >= m_flushLevel.load(std::memory_order_relaxed))
+    {
+        needsFlush = true;
+    }
+}
+
+void XPlaneLogAsync::appendDebugText(const spdlog::details::log_msg &msg)
+{
+    // Format the XPLMDebugString line here so the main thread only has to write it
+    m_debugFormatBuffer.clear();
+    m_debugFormatter.format(msg, m_debugFormatBuffer);
+
+    std::lock_guard<std::mutex> lock(m_debugTextMutex);
+    if (m_pendingDebugText.size() + m_debugFormatBuffer.size() > kMaxPendingDebugText)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_pendingDebugText.append(m_debugFormatBuffer.data(), m_debugFormatBuffer.size());
+}
+
+void XPlaneLogAsync::drainDebugText()
+{
+    XP_PROFILE_SCOPE("XPlaneLogAsync::drainDebugText");
+    {
+        // Swap buffers so the worker is only blocked for the swap, not the write
+        std::lock_guard<std::mutex> lock(m_debugTextMutex);
+        if (m_pendingDebugText.empty())
+        {
+            return;
+        }
+        m_pendingDebugText.swap(m_drainingDebugText);
+    }
+
+    // One XPLMDebugString call for the whole batch
+    XPLMDebugString(m_drainingDebugText.c_str());
+    m_drainingDebugText.clear();
+}
+
+float XPlaneLogAsync::DrainFlightLoopCallback(float elapsedSinceLastCall, float elapsedSinceLastFlightLoop, int counter, void *refcon)
+{
+    static_cast<XPlaneLogAsync *>(refcon)->drainDebugText();
+
+    // Call again next frame
+    return -1.0f;
+}
@@ -0,0 +1,175 @@
+#ifndef XPLANELOGASYNC_H
+#define XPLANELOGASYNC_H
+
+// Standard Library Headers
+#include <atomic>             // For std::atomic
+#include <condition_variable> // For std::condition_variable
+#include <cstddef>            // For size_t
+#include <memory>             // For std::unique_ptr and std::shared_ptr
+#include <mutex>              // For std::mutex
+#include <string>             // For std::string
+#include <thread>             // For std::thread
+#include <vector>             // For std::vector
+
+// Third-Party Library Headers
+#include <spdlog/details/log_msg.h>    // For spdlog::details::log_msg
+#include <spdlog/details/null_mutex.h> // For spdlog::details::null_mutex
+#include <spdlog/sinks/base_sink.h>    // For spdlog::sinks::base_sink
+
+// Project-Specific Headers
+#include "XPlaneLog.h"
+
+// A log message captured by value so it can outlive the caller's buffers
+struct XPlaneLogRecord
+{
+    // Messages up to this length are stored inline without touching the heap
+    static constexpr size_t kInlinePayload = 256;
+
+    spdlog::level::level_enum level = spdlog::level::off;
+    spdlog::log_clock::time_point time;
+    size_t threadId = 0;
+    spdlog::source_loc source;
+    size_t length = 0;
+    char inlinePayload[kInlinePayload];
+    std::string overflowPayload; // Only used for messages longer than kInlinePayload
+
+    void assign(const spdlog::details::log_msg &msg);
+    void assign(const XPlaneLogRecord &other);
+    spdlog::string_view_t text() const;
+};
+
+// Bounded multi-producer/multi-consumer lock-free queue of log records.
+// Each slot carries a sequence number that tells producers and consumers whose turn it is,
+// so neither side ever takes a lock.
+class XPlaneLogRing
+{
+public:
+    // Capacity is rounded up to a power of two
+    explicit XPlaneLogRing(size_t capacity);
+
+    // Returns false if the queue is full
+    bool tryPush(const spdlog::details::log_msg &msg);
+
+    // Returns false if the queue is empty
+    bool tryPop(XPlaneLogRecord &record);
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // Approximate number of queued records
+    size_t size() const;
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        XPlaneLogRecord record;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+
+    // Producer and consumer positions live on separate cache lines
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+};
+
+// Asynchronous logging pipeline.
+// The front sink copies each message into the ring and returns. A worker thread drains the
+// ring into the worker sinks (the throttle, and behind it the file and console sinks). The
+// debug sink among them formats XPLMDebugString output into a batch that the main thread
+// writes from a flight loop callback, since XPLM must not be called off it.
+class XPlaneLogAsync
+{
+public:
+    XPlaneLogAsync(const std::string &loggerName, const XPlaneLog::Options &options);
+    ~XPlaneLogAsync();
+
+    // Sink to attach to the spdlog logger
+    spdlog::sink_ptr frontSink() const { return m_frontSink; }
+
+    // Sink that batches XPLMDebugString output; place it among the worker sinks
+    spdlog::sink_ptr debugSink() const { return m_debugSink; }
+
+    // Flush records at or above this level to the worker sinks as soon as they are written
+    void setFlushLevel(spdlog::level::level_enum level) { m_flushLevel.store(level, std::memory_order_relaxed); }
+
+    // Register the XPLMDebugString drain and start the worker thread, which writes every
+    // record to workerSinks
+    void start(std::vector<spdlog::sink_ptr> workerSinks);
+
+    // Stop the worker after it has emptied the queue, then write what is left to XPLMDebugString.
+    // Must be called from the main thread.
+    void stop();
+
+    XPlaneLog::AsyncStats stats() const;
+
+private:
+    class FrontSink : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+    {
+    public:
+        explicit FrontSink(XPlaneLogAsync &pipeline) : m_pipeline(pipeline) {}
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg &msg) override { m_pipeline.enqueue(msg); }
+        void flush_() override { m_pipeline.wakeWorker(); }
+
+    private:
+        XPlaneLogAsync &m_pipeline;
+    };
+
+    // Only called from the worker thread
+    class DebugSink : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+    {
+    public:
+        explicit DebugSink(XPlaneLogAsync &pipeline) : m_pipeline(pipeline) {}
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg &msg) override { m_pipeline.appendDebugText(msg); }
+        void flush_() override {}
+
+    private:
+        XPlaneLogAsync &m_pipeline;
+    };
+
+    // Upper bound on XPLMDebugString text waiting for the main thread, e.g. while the sim is loading
+    static constexpr size_t kMaxPendingDebugText = 1024 * 1024;
+
+    void enqueue(const spdlog::details::log_msg &msg);
+    void wakeWorker();
+    void workerLoop();
+    void writeRecord(const XPlaneLogRecord &record, bool &needsFlush);
+    void appendDebugText(const spdlog::details::log_msg &msg);
+    void drainDebugText();
+
+    static float DrainFlightLoopCallback(float elapsedSinceLastCall, float elapsedSinceLastFlightLoop, int counter, void *refcon);
+
+    std::string m_loggerName;
+    XPlaneLog::OverflowPolicy m_overflowPolicy;
+    XPlaneLogRing m_ring;
+    std::vector<spdlog::sink_ptr> m_workerSinks;
+    spdlog::sink_ptr m_frontSink;
+    spdlog::sink_ptr m_debugSink;
+    std::atomic<spdlog::level::level_enum> m_flushLevel{spdlog::level::info};
+
+    // Worker thread and its wake-up signal
+    std::thread m_worker;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<bool> m_workerWaiting{false};
+    std::atomic<bool> m_stopping{false};
+    bool m_running = false;
+
+    // XPLMDebugString batch: filled by the worker, swapped out and written by the main thread
+    XPlaneLog::Formatter m_debugFormatter;
+    spdlog::memory_buf_t m_debugFormatBuffer;
+    std::mutex m_debugTextMutex;
+    std::string m_pendingDebugText;
+    std::string m_drainingDebugText;
+
+    // Counters
+    std::atomic<uint64_t> m_enqueued{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<size_t> m_maxQueueDepth{0};
+};
+
+#endif // XPLANELOGASYNC_H
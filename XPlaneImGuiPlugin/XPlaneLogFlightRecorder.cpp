@@ -0,0 +1,72 @@
+#include "XPlaneLogFlightRecorder.h"
+
+// Standard Library Headers
+#include <algorithm>    // For std::min
+#include <chrono>       // For std::chrono::duration_cast
+#include <cstring>      // For std::memcpy
+#include <filesystem>   // For std::filesystem::rename
+#include <system_error> // For std::error_code
+
+// Project-Specific Headers
+#include "XPlaneProfiler.h"
+
+using namespace XPlaneFlightRecorderFormat;
+
+XPlaneLogFlightRecorderSink::XPlaneLogFlightRecorderSink(const std::string &path, size_t slotCount, size_t slotSize)
+{
+    // Keep the previous session's recording: it is the one that matters after a crash
+    std::error_code error;
+    if (std::filesystem::exists(path, error))
+    {
+        std::filesystem::rename(path, path + ".prev", error);
+    }
+
+    // Slots must hold a header and stay 8-byte aligned for the atomic sequence
+    slotSize = (slotSize < sizeof(RecordHeader) * 2 ? sizeof(RecordHeader) * 2 : slotSize + 7) & ~static_cast<size_t>(7);
+    if (slotCount == 0 || !m_file.open(path, sizeof(FileHeader) + slotCount * slotSize))
+    {
+        return;
+    }
+
+    // A freshly truncated file is zero-filled, so every slot starts out uncommitted
+    m_header = static_cast<FileHeader *>(m_file.data());
+    m_header->magic = kMagic;
+    m_header->version = kVersion;
+    m_header->slotSize = static_cast<uint32_t>(slotSize);
+    m_header->slotCount = static_cast<uint32_t>(slotCount);
+    m_header->nextSequence.store(0, std::memory_order_relaxed);
+
+    m_slots = static_cast<char *>(m_file.data()) + sizeof(FileHeader);
+    m_slotSize = slotSize;
+    m_slotCount = slotCount;
+}
+
+void XPlaneLogFlightRecorderSink::log(const spdlog::details::log_msg &msg)
+{
+    XP_PROFILE_SCOPE("XPlaneLogFlightRecorderSink");
+    if (!m_header || !should_log(msg.level))
+    {
+        return;
+    }
+
+    // Claim the next slot; concurrent writers get distinct slots
+    const uint64_t sequence = m_header->nextSequence.fetch_add(1, std::memory_order_relaxed);
+    char *slot = m_slots + (sequence % m_slotCount) * m_slotSize;
+    RecordHeader *record = reinterpret_cast<RecordHeader *>(slot);
+
+    // Mark the slot as in progress before overwriting it
+    record->committed.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const size_t capacity = std::min<size_t>(m_slotSize - sizeof(RecordHeader), UINT16_MAX);
+    const size_t length = msg.payload.size() < capacity ? msg.payload.size() : capacity;
+
+    record->timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+    record->threadId = msg.thread_id;
+    record->level = static_cast<uint8_t>(msg.level);
+    record->length = static_cast<uint16_t>(length);
+    std::memcpy(slot + sizeof(RecordHeader), msg.payload.data(), length);
+
+    // Publish
+    record->committed.store(sequence + 1, std::memory_order_release);
+}
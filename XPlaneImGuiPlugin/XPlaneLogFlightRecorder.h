@@ -0,0 +1,42 @@
+#ifndef XPLANELOGFLIGHTRECORDER_H
+#define XPLANELOGFLIGHTRECORDER_H
+
+// Standard Library Headers
+#include <memory> // For std::unique_ptr
+#include <string> // For std::string
+
+// Third-Party Library Headers
+#include <spdlog/details/log_msg.h> // For spdlog::details::log_msg
+#include <spdlog/sinks/sink.h>      // For spdlog::sinks::sink
+
+// Project-Specific Headers
+#include "XPlaneFlightRecorder.h"
+#include "XPlaneMappedFile.h"
+
+// Sink that appends binary records to a memory-mapped ring file.
+// Appending is lock-free: writers claim a slot with one atomic increment and copy the message
+// into it, with no formatting and no system call. The kernel writes the mapping back to disk,
+// so the last records survive a crash of the sim. Decode with the FlightRecorderDecode tool.
+class XPlaneLogFlightRecorderSink : public spdlog::sinks::sink
+{
+public:
+    // Map a ring of slotCount records of slotSize bytes at path.
+    // A recording left over from the previous session is kept as <path>.prev.
+    XPlaneLogFlightRecorderSink(const std::string &path, size_t slotCount, size_t slotSize);
+
+    bool isOpen() const { return m_file.isOpen(); }
+
+    void log(const spdlog::details::log_msg &msg) override;
+    void flush() override {} // The mapping is written back by the OS
+    void set_pattern(const std::string &) override {}
+    void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+
+private:
+    XPlaneMappedFile m_file;
+    XPlaneFlightRecorderFormat::FileHeader *m_header = nullptr;
+    char *m_slots = nullptr;
+    size_t m_slotSize = 0;
+    size_t m_slotCount = 0;
+};
+
+#endif // XPLANELOGFLIGHTRECORDER_H
@@ -0,0 +1,54 @@
+#include "XPlaneLog.h"
+
+// Standard Library Headers
+#include <algorithm> // For std::remove_if
+#include <cctype>    // For std::toupper
+#include <string>    // For std::string
+
+// Third-Party Library Headers
+#include <spdlog/details/log_msg.h>   // For spdlog::details::log_msg
+#include <spdlog/pattern_formatter.h> // For spdlog::pattern_formatter
+
+// Kept free of X-Plane SDK headers so it can be built into the logging benchmark
+
+XPlaneLog::Formatter::Formatter()
+{
+    for (int level = 0; level < spdlog::level::n_levels; ++level)
+    {
+        // Extract and convert log level to uppercase once, when the pattern is compiled
+        spdlog::string_view_t level_name = spdlog::level::to_string_view(static_cast<spdlog::level::level_enum>(level));
+        std::string log_level(level_name.data(), level_name.size());
+        std::transform(log_level.begin(), log_level.end(), log_level.begin(), ::toupper);
+
+        // No end-of-line in the pattern: format() strips CR/LF and appends a single newline itself
+        std::string pattern = "[%Y-%m-%d %H:%M:%S.%e] [%n] [" + log_level + "] %v";
+        m_levelFormatters[level] = std::make_unique<spdlog::pattern_formatter>(pattern, spdlog::pattern_time_type::local, "");
+    }
+}
+
+XPlaneLog::Formatter::Formatter(const Formatter &other)
+{
+    for (size_t level = 0; level < m_levelFormatters.size(); ++level)
+    {
+        m_levelFormatters[level] = other.m_levelFormatters[level]->clone();
+    }
+}
+
+void XPlaneLog::Formatter::format(const spdlog::details::log_msg &msg, spdlog::memory_buf_t &dest)
+{
+    // Format with the precompiled pattern for this level, directly into the destination buffer
+    const size_t start = dest.size();
+    m_levelFormatters[msg.level]->format(msg, dest);
+
+    // Remove any CR or LF characters in a single in-place pass over what was just written
+    char *begin = dest.data() + start;
+    char *end = std::remove_if(begin, dest.data() + dest.size(), [](char c)
+                               { return c == '\r' || c == '\n'; });
+    dest.resize(static_cast<size_t>(end - dest.data()));
+
+    // End a non-empty record with a single newline; an empty one stays empty
+    if (dest.size() > start)
+    {
+        dest.push_back('\n');
+    }
+}
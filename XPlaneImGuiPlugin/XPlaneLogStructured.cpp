@@ -0,0 +1,310 @@
+#include "XPlaneLogStructured.h"
+
+// Standard Library Headers
+#include <chrono>             // For std::chrono::system_clock
+#include <condition_variable> // For std::condition_variable
+#include <cstdio>             // For std::FILE
+#include <deque>              // For std::deque
+#include <functional>         // For std::hash
+#include <memory>             // For std::unique_ptr
+#include <mutex>              // For std::mutex
+#include <thread>             // For std::thread
+#include <vector>             // For std::vector
+
+// Project-Specific Headers
+#include "XPlaneProfiler.h"
+
+using namespace XPlaneStructuredLogFormat;
+
+std::atomic<bool> XPlaneLogStructured::s_enabled{false};
+
+namespace
+{
+    // Per-thread buffers are handed to the writer whole, so records are never split
+    constexpr size_t kChunkSize = 64 * 1024;
+
+    // If the writer falls this far behind, new chunks are dropped rather than growing memory without bound
+    constexpr size_t kMaxPendingBlocks = 256;
+
+    struct Block
+    {
+        BlockType type;
+        uint64_t threadId;
+        std::vector<char> data;
+        size_t size;
+    };
+
+    struct ThreadBuffer;
+
+    // Writer state shared by all threads
+    std::mutex g_Mutex;
+    std::condition_variable g_Condition;
+    std::deque<Block> g_PendingBlocks;
+    std::vector<std::vector<char>> g_FreeChunks;
+    std::vector<std::unique_ptr<ThreadBuffer>> g_ThreadBuffers;
+    std::vector<std::pair<std::string, std::string>> g_Formats; // Format string and argument types, index = id - 1
+    std::thread g_Writer;
+    std::FILE *g_File = nullptr;
+    bool g_Stopping = false;
+    std::atomic<uint64_t> g_DroppedChunks{0};
+
+    void QueueBlock(Block block)
+    {
+        g_PendingBlocks.push_back(std::move(block));
+        g_Condition.notify_one();
+    }
+
+    Block MakeDefinitionBlock(uint32_t id, const std::string &format, const std::string &argTypes)
+    {
+        Block block{Block_FormatDefinition, 0, {}, 0};
+        uint32_t argCount = static_cast<uint32_t>(argTypes.size());
+        uint32_t formatLength = static_cast<uint32_t>(format.size());
+        block.data.resize(sizeof(id) + sizeof(argCount) + argCount + sizeof(formatLength) + formatLength);
+
+        char *out = block.data.data();
+        std::memcpy(out, &id, sizeof(id));
+        out += sizeof(id);
+        std::memcpy(out, &argCount, sizeof(argCount));
+        out += sizeof(argCount);
+        std::memcpy(out, argTypes.data(), argCount);
+        out += argCount;
+        std::memcpy(out, &formatLength, sizeof(formatLength));
+        out += sizeof(formatLength);
+        std::memcpy(out, format.data(), formatLength);
+
+        block.size = block.data.size();
+        return block;
+    }
+
+    // Owned by g_ThreadBuffers, not by the thread: a thread_local with a destructor would run it on
+    // threads that outlive the plugin after X-Plane has unloaded it. A buffer left by a thread that
+    // exited is handed off by stop(), which also frees every chunk; the small records themselves live
+    // until unload, so a thread's pointer to its buffer never dangles.
+    struct ThreadBuffer
+    {
+        std::vector<char> chunk;
+        size_t used = 0;
+        uint64_t threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+        std::atomic<bool> writing{false}; // Between reserve() and commit(); stop() waits for it to clear
+
+        // Queue the filled part of the chunk and continue in a recycled one
+        void handOffLocked()
+        {
+            if (used == 0)
+            {
+                return;
+            }
+
+            if (g_PendingBlocks.size() >= kMaxPendingBlocks)
+            {
+                g_DroppedChunks.fetch_add(1, std::memory_order_relaxed);
+                used = 0;
+                return;
+            }
+
+            QueueBlock({Block_Records, threadId, std::move(chunk), used});
+
+            if (!g_FreeChunks.empty())
+            {
+                chunk = std::move(g_FreeChunks.back());
+                g_FreeChunks.pop_back();
+            }
+            else
+            {
+                chunk = std::vector<char>();
+            }
+            used = 0;
+        }
+    };
+
+    thread_local ThreadBuffer *t_ThreadBuffer = nullptr;
+
+    ThreadBuffer &GetThreadBuffer()
+    {
+        if (!t_ThreadBuffer)
+        {
+            auto buffer = std::make_unique<ThreadBuffer>();
+            t_ThreadBuffer = buffer.get();
+            std::lock_guard<std::mutex> lock(g_Mutex);
+            g_ThreadBuffers.push_back(std::move(buffer));
+        }
+        return *t_ThreadBuffer;
+    }
+
+    void WriterLoop()
+    {
+        XPlaneProfiler::setThreadName("Structured log writer");
+        std::unique_lock<std::mutex> lock(g_Mutex);
+        for (;;)
+        {
+            g_Condition.wait(lock, []
+                             { return g_Stopping || !g_PendingBlocks.empty(); });
+
+            while (!g_PendingBlocks.empty())
+            {
+                Block block = std::move(g_PendingBlocks.front());
+                g_PendingBlocks.pop_front();
+
+                // Write without holding the lock so producers can keep handing off chunks
+                lock.unlock();
+                BlockHeader header{block.type, static_cast<uint32_t>(block.size), block.threadId};
+                std::fwrite(&header, sizeof(header), 1, g_File);
+                std::fwrite(block.data.data(), 1, block.size, g_File);
+                lock.lock();
+
+                if (block.type == Block_Records)
+                {
+                    g_FreeChunks.push_back(std::move(block.data));
+                }
+            }
+
+            if (g_Stopping)
+            {
+                std::fflush(g_File);
+                return;
+            }
+        }
+    }
+} // namespace
+
+bool XPlaneLogStructured::start(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(g_Mutex);
+    if (g_File)
+    {
+        return true;
+    }
+
+    g_File = std::fopen(path.c_str(), "wb");
+    if (!g_File)
+    {
+        return false;
+    }
+
+    FileHeader header{kMagic, kVersion};
+    std::fwrite(&header, sizeof(header), 1, g_File);
+
+    // Call sites may have registered their formats before logging was started
+    for (size_t i = 0; i < g_Formats.size(); ++i)
+    {
+        QueueBlock(MakeDefinitionBlock(static_cast<uint32_t>(i + 1), g_Formats[i].first, g_Formats[i].second));
+    }
+
+    g_Stopping = false;
+    g_Writer = std::thread(WriterLoop);
+    s_enabled.store(true);
+    return true;
+}
+
+void XPlaneLogStructured::stop()
+{
+    if (!s_enabled.exchange(false))
+    {
+        return;
+    }
+
+    // A thread sets its writing flag before checking s_enabled, and we clear s_enabled before
+    // reading the flags, so once a flag reads false its thread has finished its last record.
+    // Wait without the lock: a record in progress may need it to hand off a full chunk.
+    std::vector<ThreadBuffer *> buffers;
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        for (const std::unique_ptr<ThreadBuffer> &buffer : g_ThreadBuffers)
+        {
+            buffers.push_back(buffer.get());
+        }
+    }
+    for (ThreadBuffer *buffer : buffers)
+    {
+        while (buffer->writing.load())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        for (const std::unique_ptr<ThreadBuffer> &buffer : g_ThreadBuffers)
+        {
+            buffer->handOffLocked();
+        }
+        g_Stopping = true;
+        g_Condition.notify_one();
+    }
+
+    g_Writer.join();
+
+    std::lock_guard<std::mutex> lock(g_Mutex);
+    std::fclose(g_File);
+    g_File = nullptr;
+    g_FreeChunks.clear();
+    for (const std::unique_ptr<ThreadBuffer> &buffer : g_ThreadBuffers)
+    {
+        buffer->chunk = std::vector<char>();
+    }
+}
+
+void XPlaneLogStructured::flushThread()
+{
+    ThreadBuffer &buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(g_Mutex);
+    buffer.handOffLocked();
+}
+
+uint64_t XPlaneLogStructured::droppedChunks()
+{
+    return g_DroppedChunks.load(std::memory_order_relaxed);
+}
+
+uint32_t XPlaneLogStructured::registerFormat(const char *format, const char *argTypes, size_t argCount)
+{
+    std::lock_guard<std::mutex> lock(g_Mutex);
+    g_Formats.emplace_back(format, std::string(argTypes, argCount));
+    uint32_t id = static_cast<uint32_t>(g_Formats.size());
+
+    if (g_File)
+    {
+        QueueBlock(MakeDefinitionBlock(id, g_Formats.back().first, g_Formats.back().second));
+    }
+    return id;
+}
+
+char *XPlaneLogStructured::reserve(size_t size)
+{
+    if (size > kChunkSize)
+    {
+        return nullptr;
+    }
+
+    ThreadBuffer &buffer = GetThreadBuffer();
+    buffer.writing.store(true);
+    if (!s_enabled.load())
+    {
+        // stop() has started and may be handing off this buffer
+        buffer.writing.store(false, std::memory_order_release);
+        return nullptr;
+    }
+    if (buffer.used + size > buffer.chunk.size())
+    {
+        // Only a full buffer takes the lock
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        buffer.handOffLocked();
+        if (buffer.chunk.size() < kChunkSize)
+        {
+            buffer.chunk.resize(kChunkSize);
+        }
+    }
+    return buffer.chunk.data() + buffer.used;
+}
+
+void XPlaneLogStructured::commit(size_t size)
+{
+    ThreadBuffer &buffer = GetThreadBuffer();
+    buffer.used += size;
+    buffer.writing.store(false, std::memory_order_release);
+}
+
+int64_t XPlaneLogStructured::timestampNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,208 @@
+#ifndef XPLANELOGSTRUCTURED_H
+#define XPLANELOGSTRUCTURED_H
+
+// Standard Library Headers
+#include <atomic>      // For std::atomic
+#include <cstdint>     // For fixed-width integers
+#include <cstring>     // For std::memcpy and std::strlen
+#include <string>      // For std::string
+#include <string_view> // For std::string_view
+#include <type_traits> // For std::decay_t and type traits
+
+// Project-Specific Headers
+#include "XPlaneStructuredLog.h"
+
+// Binary structured logging for high-rate telemetry.
+// A format string is registered once per call site and gets an id. Each log call then only copies
+// the id, a timestamp and the raw argument bytes into a per-thread buffer; no text is formatted.
+// Full buffers are handed to a writer thread that appends them to <plugin>.binlog, and the
+// StructuredLogDecode tool turns the file back into text offline.
+//
+// Usage:
+//     XPLOG_STRUCTURED("frame {} took {:.3f} ms", frameNumber, frameMs);
+//
+// Arguments may be integers, enums, floating point, bool, char and strings.
+class XPlaneLogStructured
+{
+public:
+    // Open the output file and start the writer thread
+    static bool start(const std::string &path);
+
+    // Flush every thread buffer, stop the writer and close the file. Records other threads are
+    // writing are waited for; later ones are discarded. Call from the main thread.
+    static void stop();
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Hand the calling thread's partially filled buffer to the writer
+    static void flushThread();
+
+    // Buffers discarded because the writer could not keep up
+    static uint64_t droppedChunks();
+
+    // Type list used to register a call site's argument types without evaluating the arguments
+    template <typename... Args>
+    struct Signature
+    {
+    };
+
+    // Only used inside decltype(), never called
+    template <typename... Args>
+    static Signature<std::decay_t<Args>...> signature(const Args &...);
+
+    template <typename... Args>
+    static uint32_t registerFormat(const char *format, Signature<Args...>)
+    {
+        static constexpr char argTypes[] = {argType<Args>()..., '\0'};
+        return registerFormat(format, argTypes, sizeof...(Args));
+    }
+
+    static uint32_t registerFormat(const char *format, const char *argTypes, size_t argCount);
+
+    template <typename... Args>
+    static void write(uint32_t formatId, const Args &...args)
+    {
+        if (!isEnabled())
+        {
+            return;
+        }
+
+        const size_t size = sizeof(XPlaneStructuredLogFormat::RecordHeader) + (size_t(0) + ... + argSize(args));
+        char *out = reserve(size);
+        if (!out)
+        {
+            return;
+        }
+
+        XPlaneStructuredLogFormat::RecordHeader header{formatId, static_cast<uint32_t>(size), timestampNs()};
+        std::memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        ((out = writeArg(out, args)), ...);
+
+        commit(size);
+    }
+
+private:
+    template <typename T>
+    static constexpr bool isString()
+    {
+        return std::is_same_v<T, const char *> || std::is_same_v<T, char *> ||
+               std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+    }
+
+    template <typename T>
+    static constexpr char argType()
+    {
+        using namespace XPlaneStructuredLogFormat;
+        if constexpr (std::is_same_v<T, bool>)
+            return Arg_Bool;
+        else if constexpr (std::is_same_v<T, char>)
+            return Arg_Char;
+        else if constexpr (std::is_enum_v<T>)
+            return argType<std::underlying_type_t<T>>();
+        else if constexpr (std::is_integral_v<T>)
+            return sizeof(T) <= 4 ? (std::is_signed_v<T> ? Arg_Int32 : Arg_UInt32) : (std::is_signed_v<T> ? Arg_Int64 : Arg_UInt64);
+        else if constexpr (std::is_same_v<T, float>)
+            return Arg_Float;
+        else if constexpr (std::is_floating_point_v<T>)
+            return Arg_Double;
+        else
+        {
+            static_assert(isString<T>(), "XPLOG_STRUCTURED arguments must be numbers, bool, char or strings");
+            return Arg_String;
+        }
+    }
+
+    template <typename T>
+    static size_t argSize(const T &value)
+    {
+        using Type = std::decay_t<T>;
+        if constexpr (isString<Type>())
+            return sizeof(uint16_t) + stringView(value).size();
+        else if constexpr (std::is_same_v<Type, bool> || std::is_same_v<Type, char>)
+            return 1;
+        else if constexpr (std::is_enum_v<Type> || std::is_integral_v<Type>)
+            return sizeof(Type) <= 4 ? 4 : 8;
+        else if constexpr (std::is_same_v<Type, float>)
+            return 4;
+        else
+            return 8;
+    }
+
+    template <typename T>
+    static char *writeArg(char *out, const T &value)
+    {
+        using Type = std::decay_t<T>;
+        if constexpr (isString<Type>())
+        {
+            std::string_view text = stringView(value);
+            uint16_t length = static_cast<uint16_t>(text.size());
+            std::memcpy(out, &length, sizeof(length));
+            std::memcpy(out + sizeof(length), text.data(), length);
+            return out + sizeof(length) + length;
+        }
+        else if constexpr (std::is_same_v<Type, bool> || std::is_same_v<Type, char>)
+        {
+            *out = static_cast<char>(value);
+            return out + 1;
+        }
+        else if constexpr (std::is_enum_v<Type>)
+        {
+            return writeArg(out, static_cast<std::underlying_type_t<Type>>(value));
+        }
+        else if constexpr (std::is_integral_v<Type>)
+        {
+            // Widen to the 32- or 64-bit type named by argType()
+            using Wide = std::conditional_t<sizeof(Type) <= 4,
+                                            std::conditional_t<std::is_signed_v<Type>, int32_t, uint32_t>,
+                                            std::conditional_t<std::is_signed_v<Type>, int64_t, uint64_t>>;
+            Wide wide = static_cast<Wide>(value);
+            std::memcpy(out, &wide, sizeof(wide));
+            return out + sizeof(wide);
+        }
+        else if constexpr (std::is_same_v<Type, float>)
+        {
+            std::memcpy(out, &value, sizeof(float));
+            return out + sizeof(float);
+        }
+        else
+        {
+            double wide = static_cast<double>(value);
+            std::memcpy(out, &wide, sizeof(wide));
+            return out + sizeof(wide);
+        }
+    }
+
+    // Strings longer than a uint16 length are truncated
+    template <typename T>
+    static std::string_view stringView(const T &value)
+    {
+        std::string_view text;
+        if constexpr (std::is_array_v<T>)
+            text = std::string_view(value);
+        else if constexpr (std::is_same_v<T, const char *> || std::is_same_v<T, char *>)
+            text = value ? std::string_view(value) : std::string_view();
+        else
+            text = std::string_view(value);
+        return text.substr(0, UINT16_MAX);
+    }
+
+    // Space for one record in the calling thread's buffer, or nullptr if the record is too large or
+    // logging is stopping. A non-null result must be followed by commit().
+    static char *reserve(size_t size);
+    static void commit(size_t size);
+    static int64_t timestampNs();
+
+    static std::atomic<bool> s_enabled;
+};
+
+// Log a structured record. The format string is registered on first use at this call site.
+#define XPLOG_STRUCTURED(format, ...)                                                                   \
+    do                                                                                                  \
+    {                                                                                                   \
+        static const uint32_t xplog_structured_id = XPlaneLogStructured::registerFormat(                \
+            format, decltype(XPlaneLogStructured::signature(__VA_ARGS__))());                           \
+        XPlaneLogStructured::write(xplog_structured_id, ##__VA_ARGS__);                                 \
+    } while (0)
+
+#endif // XPLANELOGSTRUCTURED_H
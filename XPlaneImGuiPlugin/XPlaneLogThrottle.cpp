@@ -0,0 +1,208 @@
+#include "XPlaneLogThrottle.h"
+
+// Standard Library Headers
+#include <algorithm>   // For std::min and std::equal
+#include <functional>  // For std::hash
+#include <iterator>    // For std::back_inserter and std::prev
+
+// Project-Specific Headers
+#include "XPlaneProfiler.h"
+
+XPlaneLogThrottleSink::XPlaneLogThrottleSink(const XPlaneLog::Options &options, std::vector<spdlog::sink_ptr> sinks)
+    : m_sinks(std::move(sinks)),
+      m_dedupWindow(options.dedupWindow),
+      m_ratePerSecond(options.rateLimitPerSecond),
+      m_burst(options.rateLimitBurst)
+{
+}
+
+XPlaneLog::ThrottleStats XPlaneLogThrottleSink::stats() const
+{
+    XPlaneLog::ThrottleStats stats;
+    stats.suppressedDuplicates = m_suppressedDuplicates.load(std::memory_order_relaxed);
+    stats.suppressedRateLimited = m_suppressedRateLimited.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void XPlaneLogThrottleSink::sink_it_(const spdlog::details::log_msg &msg)
+{
+    XP_PROFILE_SCOPE("XPlaneLogThrottleSink");
+    // Duplicates are collapsed first so a flood of one message does not drain its call site's bucket
+    if (isDuplicate(msg))
+    {
+        ++m_repeatCount;
+        m_suppressedDuplicates.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!allowByRate(msg))
+    {
+        m_suppressedRateLimited.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // A different message (or the window has passed): report what was collapsed, then forward
+    emitRepeatSummary();
+    forward(msg);
+
+    m_lastPayload.assign(msg.payload.data(), msg.payload.size());
+    m_lastLoggerName.assign(msg.logger_name.data(), msg.logger_name.size());
+    m_lastLevel = msg.level;
+    m_lastTime = msg.time;
+}
+
+void XPlaneLogThrottleSink::flush_()
+{
+    // Report collapsed repeats once their window has passed, so a flood that stops is still accounted for
+    if (m_repeatCount > 0 && spdlog::log_clock::now() - m_lastTime >= m_dedupWindow)
+    {
+        emitRepeatSummary();
+    }
+
+    for (auto &sink : m_sinks)
+    {
+        sink->flush();
+    }
+}
+
+void XPlaneLogThrottleSink::set_pattern_(const std::string &pattern)
+{
+    for (auto &sink : m_sinks)
+    {
+        sink->set_pattern(pattern);
+    }
+}
+
+void XPlaneLogThrottleSink::set_formatter_(std::unique_ptr<spdlog::formatter> sink_formatter)
+{
+    for (auto &sink : m_sinks)
+    {
+        sink->set_formatter(sink_formatter->clone());
+    }
+}
+
+size_t XPlaneLogThrottleSink::callSiteKey(const spdlog::details::log_msg &msg)
+{
+    constexpr size_t kMix = static_cast<size_t>(0x9E3779B97F4A7C15ull);
+    if (msg.source.filename != nullptr)
+    {
+        return std::hash<const void *>()(msg.source.filename) ^ (static_cast<size_t>(msg.source.line) * kMix);
+    }
+    if (msg.source.funcname != nullptr)
+    {
+        // XPlaneLog::formatSite: the format string's address
+        return std::hash<const void *>()(msg.source.funcname) ^ (static_cast<size_t>(msg.level) * kMix);
+    }
+
+    // Plain strings: FNV-1a over the text without its digits
+    size_t hash = static_cast<size_t>(14695981039346656037ull);
+    for (char c : msg.payload)
+    {
+        if (c < '0' || c > '9')
+        {
+            hash = (hash ^ static_cast<unsigned char>(c)) * static_cast<size_t>(1099511628211ull);
+        }
+    }
+    return hash ^ (static_cast<size_t>(msg.level) * kMix);
+}
+
+XPlaneLogThrottleSink::TokenBucket &XPlaneLogThrottleSink::findBucket(size_t key, spdlog::log_clock::time_point now)
+{
+    auto it = m_buckets.find(key);
+    if (it != m_buckets.end())
+    {
+        m_bucketOrder.splice(m_bucketOrder.begin(), m_bucketOrder, it->second);
+        return it->second->second;
+    }
+
+    if (m_buckets.size() >= kMaxBuckets)
+    {
+        // Reuse the least recently used bucket's node for the new call site
+        auto oldest = std::prev(m_bucketOrder.end());
+        m_buckets.erase(oldest->first);
+        m_bucketOrder.splice(m_bucketOrder.begin(), m_bucketOrder, oldest);
+    }
+    else
+    {
+        m_bucketOrder.emplace_front();
+    }
+
+    m_bucketOrder.front() = {key, TokenBucket{m_burst, now, 0}};
+    m_buckets.emplace(key, m_bucketOrder.begin());
+    return m_bucketOrder.front().second;
+}
+
+bool XPlaneLogThrottleSink::allowByRate(const spdlog::details::log_msg &msg)
+{
+    if (m_ratePerSecond <= 0.0)
+    {
+        return true;
+    }
+
+    TokenBucket &bucket = findBucket(callSiteKey(msg), msg.time);
+
+    // Refill for the time elapsed since this call site last logged
+    double elapsed = std::chrono::duration<double>(msg.time - bucket.lastRefill).count();
+    if (elapsed > 0.0)
+    {
+        bucket.tokens = std::min(m_burst, bucket.tokens + elapsed * m_ratePerSecond);
+        bucket.lastRefill = msg.time;
+    }
+
+    if (bucket.tokens < 1.0)
+    {
+        ++bucket.suppressed;
+        return false;
+    }
+    bucket.tokens -= 1.0;
+
+    // The call site may log again: tell the reader what it missed
+    if (bucket.suppressed > 0)
+    {
+        m_summaryBuffer.clear();
+        fmt::format_to(std::back_inserter(m_summaryBuffer), "Rate limit suppressed {} messages from this call site", bucket.suppressed);
+        spdlog::details::log_msg summary(msg.source, msg.logger_name, spdlog::level::warn,
+                                         spdlog::string_view_t(m_summaryBuffer.data(), m_summaryBuffer.size()));
+        summary.time = msg.time;
+        forward(summary);
+        bucket.suppressed = 0;
+    }
+
+    return true;
+}
+
+bool XPlaneLogThrottleSink::isDuplicate(const spdlog::details::log_msg &msg) const
+{
+    if (m_dedupWindow.count() <= 0 || msg.level != m_lastLevel || msg.time - m_lastTime >= m_dedupWindow)
+    {
+        return false;
+    }
+    return msg.payload.size() == m_lastPayload.size() &&
+           std::equal(msg.payload.begin(), msg.payload.end(), m_lastPayload.begin());
+}
+
+void XPlaneLogThrottleSink::emitRepeatSummary()
+{
+    if (m_repeatCount == 0)
+    {
+        return;
+    }
+
+    m_summaryBuffer.clear();
+    fmt::format_to(std::back_inserter(m_summaryBuffer), "Last message repeated {} times", m_repeatCount);
+    spdlog::details::log_msg summary(m_lastLoggerName, m_lastLevel, spdlog::string_view_t(m_summaryBuffer.data(), m_summaryBuffer.size()));
+    forward(summary);
+
+    m_repeatCount = 0;
+}
+
+void XPlaneLogThrottleSink::forward(const spdlog::details::log_msg &msg)
+{
+    for (auto &sink : m_sinks)
+    {
+        if (sink->should_log(msg.level))
+        {
+            sink->log(msg);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef XPLANELOGTHROTTLE_H
+#define XPLANELOGTHROTTLE_H
+
+// Standard Library Headers
+#include <atomic>        // For std::atomic
+#include <cstdint>       // For uint64_t
+#include <list>          // For std::list
+#include <mutex>         // For std::mutex
+#include <string>        // For std::string
+#include <unordered_map> // For std::unordered_map
+#include <utility>       // For std::pair
+#include <vector>        // For std::vector
+
+// Third-Party Library Headers
+#include <spdlog/details/log_msg.h> // For spdlog::details::log_msg
+#include <spdlog/sinks/base_sink.h> // For spdlog::sinks::base_sink
+
+// Project-Specific Headers
+#include "XPlaneLog.h"
+
+// Sink that sits in front of the real sinks and keeps log floods out of them.
+// - Identical consecutive messages within the dedup window are collapsed into a single
+//   "Last message repeated N times" line.
+// - Each call site gets a token bucket; messages beyond its rate are dropped and summarized
+//   once the call site is allowed to log again.
+// Call sites are identified by source location (XPLOG_* macros), by level and format string
+// (XPlaneLog's formatting overloads) or, failing that, by level and the text with its digits
+// left out, so "took 12 ms" and "took 13 ms" share a bucket.
+// In async mode it runs on the log worker, behind the queue, so producers never take its mutex.
+class XPlaneLogThrottleSink : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+    XPlaneLogThrottleSink(const XPlaneLog::Options &options, std::vector<spdlog::sink_ptr> sinks);
+
+    XPlaneLog::ThrottleStats stats() const;
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override;
+    void flush_() override;
+    void set_pattern_(const std::string &pattern) override;
+    void set_formatter_(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+private:
+    struct TokenBucket
+    {
+        double tokens = 0.0;
+        spdlog::log_clock::time_point lastRefill;
+        uint64_t suppressed = 0;
+    };
+
+    // Bounds the bucket table; the least recently used call site is evicted beyond it
+    static constexpr size_t kMaxBuckets = 1024;
+
+    static size_t callSiteKey(const spdlog::details::log_msg &msg);
+    TokenBucket &findBucket(size_t key, spdlog::log_clock::time_point now);
+    bool allowByRate(const spdlog::details::log_msg &msg);
+    bool isDuplicate(const spdlog::details::log_msg &msg) const;
+    void emitRepeatSummary();
+    void forward(const spdlog::details::log_msg &msg);
+
+    std::vector<spdlog::sink_ptr> m_sinks;
+
+    // Dedup state: the last message forwarded and how many copies were swallowed since
+    std::chrono::milliseconds m_dedupWindow;
+    std::string m_lastPayload;
+    std::string m_lastLoggerName;
+    spdlog::level::level_enum m_lastLevel = spdlog::level::off;
+    spdlog::log_clock::time_point m_lastTime;
+    uint64_t m_repeatCount = 0;
+
+    // Rate limit state
+    double m_ratePerSecond;
+    double m_burst;
+    // Most recently used first; the map points into the list
+    std::list<std::pair<size_t, TokenBucket>> m_bucketOrder;
+    std::unordered_map<size_t, std::list<std::pair<size_t, TokenBucket>>::iterator> m_buckets;
+
+    // Scratch buffer for summary lines
+    spdlog::memory_buf_t m_summaryBuffer;
+
+    std::atomic<uint64_t> m_suppressedDuplicates{0};
+    std::atomic<uint64_t> m_suppressedRateLimited{0};
+};
+
+#endif // XPLANELOGTHROTTLE_H
@@ -0,0 +1,508 @@
+#include "XPlaneLogViewer.h"
+
+// Standard Library Headers
+#include <algorithm> // For std::min, std::max and std::search
+#include <cctype>    // For std::tolower
+#include <chrono>    // For std::chrono
+#include <climits>   // For INT_MAX
+#include <cstring>   // For std::memcpy
+#include <ctime>     // For std::tm
+#include <iterator>  // For std::back_inserter
+
+// Third-Party Library Headers
+#include <imgui.h>
+#include <spdlog/details/os.h> // For spdlog::details::os::localtime
+
+// Project-Specific Headers
+#include "XPlaneProfiler.h"
+
+namespace
+{
+    const char *kLevelLabels[] = {"Trace", "Debug", "Info", "Warning", "Error", "Critical"};
+    const char *kLevelNames[] = {"TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+
+    ImVec4 LevelColor(spdlog::level::level_enum level)
+    {
+        switch (level)
+        {
+        case spdlog::level::trace:
+            return ImVec4(0.55f, 0.55f, 0.55f, 1.0f);
+        case spdlog::level::debug:
+            return ImVec4(0.70f, 0.70f, 0.75f, 1.0f);
+        case spdlog::level::warn:
+            return ImVec4(1.00f, 0.80f, 0.30f, 1.0f);
+        case spdlog::level::err:
+            return ImVec4(1.00f, 0.40f, 0.40f, 1.0f);
+        case spdlog::level::critical:
+            return ImVec4(1.00f, 0.20f, 0.60f, 1.0f);
+        default:
+            return ImGui::GetStyleColorVec4(ImGuiCol_Text);
+        }
+    }
+} // namespace
+
+XPlaneLogViewer::XPlaneLogViewer(size_t lineCapacity, size_t textCapacity)
+{
+    size_t roundedCapacity = 2;
+    while (roundedCapacity < lineCapacity)
+    {
+        roundedCapacity <<= 1;
+    }
+    m_lineCapacity = roundedCapacity;
+    m_lineMask = roundedCapacity - 1;
+    m_textCapacity = std::max(textCapacity, 4 * kMaxLineLength);
+
+    m_levelEnabled.fill(true);
+
+    m_sink = std::make_shared<Sink>(*this);
+    m_worker = std::thread(&XPlaneLogViewer::workerLoop, this);
+}
+
+XPlaneLogViewer::~XPlaneLogViewer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_filterMutex);
+        m_stopping = true;
+        m_filterCondition.notify_one();
+    }
+    m_worker.join();
+}
+
+void XPlaneLogViewer::clear()
+{
+    std::lock_guard<std::mutex> lock(m_storeMutex);
+    m_firstLine.store(m_endLine.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void XPlaneLogViewer::trim()
+{
+    m_storeAllocated = false;
+    {
+        std::lock_guard<std::mutex> lock(m_storeMutex);
+        m_lines.reset();
+        m_text.reset();
+        m_firstLine.store(m_endLine.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+        std::deque<uint64_t>().swap(m_index);
+    }
+    m_visibleNumbers = std::vector<uint64_t>();
+    m_visibleBatch.entries = std::vector<Batch::Entry>();
+    m_visibleBatch.text = std::vector<char>();
+}
+
+// Store
+
+void XPlaneLogViewer::allocateStore()
+{
+    std::lock_guard<std::mutex> lock(m_storeMutex);
+    m_storeAllocated = true;
+
+    // Allocated without initialization, so pages are only touched as lines arrive
+    m_lines.reset(new Line[m_lineCapacity]);
+    m_text.reset(new char[m_textCapacity]);
+}
+
+void XPlaneLogViewer::append(const spdlog::details::log_msg &msg)
+{
+    XP_PROFILE_SCOPE("XPlaneLogViewer::append");
+    size_t length = std::min(msg.payload.size(), kMaxLineLength);
+
+    std::lock_guard<std::mutex> lock(m_storeMutex);
+    if (!m_lines)
+    {
+        return;
+    }
+
+    // Keep each line contiguous: if it would wrap, skip the rest of the text ring
+    uint64_t start = m_textEnd;
+    size_t ringOffset = static_cast<size_t>(start % m_textCapacity);
+    if (ringOffset + length > m_textCapacity)
+    {
+        start += m_textCapacity - ringOffset;
+    }
+    uint64_t end = start + length;
+
+    // Evict the oldest lines until there is a free slot and the new text overwrites nothing still in use
+    uint64_t first = m_firstLine.load(std::memory_order_relaxed);
+    uint64_t last = m_endLine.load(std::memory_order_relaxed);
+    while (first < last && (last - first > m_lineMask || end - m_lines[first & m_lineMask].textOffset > m_textCapacity))
+    {
+        ++first;
+    }
+
+    std::memcpy(&m_text[start % m_textCapacity], msg.payload.data(), length);
+    m_lines[last & m_lineMask] = Line{msg.time.time_since_epoch().count(), start, static_cast<uint32_t>(length), msg.level};
+    m_textEnd = end;
+
+    m_firstLine.store(first, std::memory_order_relaxed);
+    m_endLine.store(last + 1, std::memory_order_release);
+}
+
+void XPlaneLogViewer::copyLine(uint64_t number, Batch &batch) const
+{
+    // Evicted lines keep their row as an empty entry at level off, which no filter matches
+    if (!m_lines || number < m_firstLine.load(std::memory_order_relaxed) || number >= m_endLine.load(std::memory_order_relaxed))
+    {
+        batch.entries.push_back({number, {}, spdlog::level::off, batch.text.size(), 0});
+        return;
+    }
+
+    const Line &line = m_lines[number & m_lineMask];
+    const char *text = &m_text[line.textOffset % m_textCapacity];
+    batch.entries.push_back({number, spdlog::log_clock::time_point(spdlog::log_clock::duration(line.time)), line.level, batch.text.size(), line.length});
+    batch.text.insert(batch.text.end(), text, text + line.length);
+}
+
+void XPlaneLogViewer::copyRange(uint64_t first, uint64_t last, Batch &batch) const
+{
+    std::lock_guard<std::mutex> lock(m_storeMutex);
+    first = std::max(first, m_firstLine.load(std::memory_order_relaxed));
+    for (uint64_t number = first; number < last; ++number)
+    {
+        copyLine(number, batch);
+    }
+}
+
+void XPlaneLogViewer::copyLines(const uint64_t *numbers, size_t count, Batch &batch) const
+{
+    std::lock_guard<std::mutex> lock(m_storeMutex);
+    for (size_t i = 0; i < count; ++i)
+    {
+        copyLine(numbers[i], batch);
+    }
+}
+
+// Filter
+
+bool XPlaneLogViewer::Filter::narrows(const Filter &other) const
+{
+    return (levelMask & ~other.levelMask) == 0 && text.find(other.text) != std::string::npos;
+}
+
+bool XPlaneLogViewer::Filter::matches(spdlog::level::level_enum level, const char *line, size_t length) const
+{
+    if ((levelMask & (1u << level)) == 0)
+    {
+        return false;
+    }
+    if (text.empty())
+    {
+        return true;
+    }
+
+    // Case-insensitive substring search; the filter text is already lower case
+    const char *end = line + length;
+    return std::search(line, end, text.begin(), text.end(), [](char a, char b)
+                       { return std::tolower(static_cast<unsigned char>(a)) == b; }) != end;
+}
+
+void XPlaneLogViewer::setFilter()
+{
+    Filter filter;
+    filter.levelMask = 0;
+    for (int level = 0; level < spdlog::level::off; ++level)
+    {
+        if (m_levelEnabled[level])
+        {
+            filter.levelMask |= 1u << level;
+        }
+    }
+    filter.text = m_filterText;
+    std::transform(filter.text.begin(), filter.text.end(), filter.text.begin(), [](char c)
+                   { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+    std::lock_guard<std::mutex> lock(m_filterMutex);
+    m_filter = std::move(filter);
+    ++m_filterGeneration;
+    m_filterCondition.notify_one();
+}
+
+bool XPlaneLogViewer::filterChanged(uint64_t generation)
+{
+    std::lock_guard<std::mutex> lock(m_filterMutex);
+    return m_stopping || m_filterGeneration != generation;
+}
+
+void XPlaneLogViewer::workerLoop()
+{
+    XPlaneProfiler::setThreadName("Log viewer filter");
+    Filter filter;
+    uint64_t generation = 0;
+    uint64_t scannedEnd = 0;    // Lines below this have been matched against the filter
+    bool indexComplete = false; // The index holds every match below scannedEnd
+    Batch batch;
+    std::vector<uint64_t> previous;
+
+    for (;;)
+    {
+        bool changed = false;
+        bool narrowing = false;
+        {
+            std::unique_lock<std::mutex> lock(m_filterMutex);
+            if (m_open.load())
+            {
+                // New lines are picked up on the timeout; only a filter change wakes the worker early
+                m_filterCondition.wait_for(lock, std::chrono::milliseconds(50), [&]
+                                           { return m_stopping || m_filterGeneration != generation; });
+
+                // Closed windows are no longer drawn, so a stale render time means closed
+                auto sinceRender = spdlog::log_clock::now().time_since_epoch() - spdlog::log_clock::duration(m_lastRender.load());
+                if (sinceRender > std::chrono::seconds(1))
+                {
+                    m_open.store(false);
+                }
+            }
+            else
+            {
+                // Nothing to keep up to date: sleep until the window is drawn or the filter changes
+                m_filterCondition.wait(lock, [&]
+                                       { return m_stopping || m_open.load() || m_filterGeneration != generation; });
+            }
+            if (m_stopping)
+            {
+                return;
+            }
+            if (m_filterGeneration != generation)
+            {
+                narrowing = indexComplete && filter.isActive() && m_filter.narrows(filter);
+                filter = m_filter;
+                generation = m_filterGeneration;
+                changed = true;
+            }
+        }
+
+        if (changed)
+        {
+            m_scanning.store(true);
+            {
+                std::lock_guard<std::mutex> lock(m_indexMutex);
+                previous.clear();
+                if (narrowing)
+                {
+                    previous.assign(m_index.begin(), m_index.end());
+                }
+                m_index.clear();
+                m_indexGeneration.store(generation);
+                m_indexActive.store(filter.isActive());
+            }
+
+            if (narrowing)
+            {
+                // Only the previous matches can match a narrower filter
+                indexComplete = true;
+                for (size_t i = 0; i < previous.size(); i += kScanBatch)
+                {
+                    if (filterChanged(generation))
+                    {
+                        indexComplete = false;
+                        break;
+                    }
+                    batch.clear();
+                    copyLines(previous.data() + i, std::min(kScanBatch, previous.size() - i), batch);
+                    appendMatches(filter, batch);
+                }
+            }
+            else
+            {
+                scannedEnd = m_firstLine.load();
+                indexComplete = true;
+            }
+        }
+
+        // Without an active filter the window reads the store directly
+        if (!filter.isActive() || !indexComplete)
+        {
+            m_scanning.store(false);
+            continue;
+        }
+
+        // Match the lines that arrived since the last pass
+        uint64_t end = m_endLine.load(std::memory_order_acquire);
+        scannedEnd = std::max(scannedEnd, m_firstLine.load());
+        while (scannedEnd < end && !filterChanged(generation))
+        {
+            uint64_t batchEnd = std::min<uint64_t>(end, scannedEnd + kScanBatch);
+            batch.clear();
+            copyRange(scannedEnd, batchEnd, batch);
+            appendMatches(filter, batch);
+            scannedEnd = batchEnd;
+        }
+
+        trimIndex();
+        m_scanning.store(false);
+    }
+}
+
+void XPlaneLogViewer::appendMatches(const Filter &filter, const Batch &batch)
+{
+    // Match without holding any lock, then publish the batch in one go
+    m_matches.clear();
+    for (const Batch::Entry &entry : batch.entries)
+    {
+        if (filter.matches(entry.level, batch.text.data() + entry.offset, entry.length))
+        {
+            m_matches.push_back(entry.number);
+        }
+    }
+
+    if (!m_matches.empty())
+    {
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+        m_index.insert(m_index.end(), m_matches.begin(), m_matches.end());
+    }
+}
+
+void XPlaneLogViewer::trimIndex()
+{
+    uint64_t first = m_firstLine.load();
+    std::lock_guard<std::mutex> lock(m_indexMutex);
+    while (!m_index.empty() && m_index.front() < first)
+    {
+        m_index.pop_front();
+    }
+}
+
+// Window
+
+void XPlaneLogViewer::render(bool *open)
+{
+    if (!m_storeAllocated)
+    {
+        allocateStore();
+    }
+
+    m_lastRender.store(spdlog::log_clock::now().time_since_epoch().count());
+    if (!m_open.exchange(true))
+    {
+        // Opened, or drawn again after the worker considered it closed
+        std::lock_guard<std::mutex> lock(m_filterMutex);
+        m_filterCondition.notify_one();
+    }
+
+    ImGui::SetNextWindowSize(ImVec2(900, 500), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Log Viewer", open))
+    {
+        ImGui::End();
+        return;
+    }
+
+    // Toolbar
+    bool filterEdited = false;
+    for (int level = 0; level < spdlog::level::off; ++level)
+    {
+        if (level > 0)
+        {
+            ImGui::SameLine();
+        }
+        filterEdited |= ImGui::Checkbox(kLevelLabels[level], &m_levelEnabled[level]);
+    }
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 16.0f);
+    filterEdited |= ImGui::InputTextWithHint("##Filter", "Filter", m_filterText, sizeof(m_filterText));
+    ImGui::SameLine();
+    ImGui::Checkbox("Auto-scroll", &m_autoScroll);
+    ImGui::SameLine();
+    if (ImGui::Button("Clear"))
+    {
+        clear();
+    }
+
+    if (filterEdited)
+    {
+        setFilter();
+    }
+
+    uint64_t first = m_firstLine.load();
+    uint64_t end = std::max(first, m_endLine.load(std::memory_order_acquire));
+    bool filtered = m_indexActive.load();
+
+    size_t rowCount;
+    if (filtered)
+    {
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+        rowCount = m_index.size();
+    }
+    else
+    {
+        rowCount = static_cast<size_t>(end - first);
+    }
+
+    if (filtered)
+    {
+        ImGui::TextDisabled("%zu of %llu lines%s", rowCount, static_cast<unsigned long long>(end - first), m_scanning.load() ? " (filtering...)" : "");
+    }
+    else
+    {
+        ImGui::TextDisabled("%llu lines", static_cast<unsigned long long>(end - first));
+    }
+    ImGui::Separator();
+
+    // Only the visible rows are copied out of the store and drawn
+    ImGui::BeginChild("##LogLines", ImVec2(0, 0), 0, ImGuiWindowFlags_HorizontalScrollbar);
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(std::min<size_t>(rowCount, INT_MAX)));
+    while (clipper.Step())
+    {
+        m_visibleNumbers.clear();
+        if (filtered)
+        {
+            std::lock_guard<std::mutex> lock(m_indexMutex);
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd && static_cast<size_t>(row) < m_index.size(); ++row)
+            {
+                m_visibleNumbers.push_back(m_index[row]);
+            }
+        }
+        else
+        {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+            {
+                m_visibleNumbers.push_back(first + row);
+            }
+        }
+
+        m_visibleBatch.clear();
+        copyLines(m_visibleNumbers.data(), m_visibleNumbers.size(), m_visibleBatch);
+        for (const Batch::Entry &entry : m_visibleBatch.entries)
+        {
+            drawLine(m_visibleBatch, entry);
+        }
+    }
+
+    ImGui::PopStyleVar();
+
+    // Follow new lines while scrolled to the bottom
+    if (m_autoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+    {
+        ImGui::SetScrollHereY(1.0f);
+    }
+
+    ImGui::EndChild();
+    ImGui::End();
+}
+
+void XPlaneLogViewer::drawLine(const Batch &batch, const Batch::Entry &entry)
+{
+    if (entry.level == spdlog::level::off)
+    {
+        // Evicted while the frame was being drawn
+        ImGui::TextUnformatted("");
+        return;
+    }
+
+    auto seconds = std::chrono::time_point_cast<std::chrono::seconds>(entry.time);
+    auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(entry.time - seconds).count();
+    std::tm time = spdlog::details::os::localtime(spdlog::log_clock::to_time_t(entry.time));
+
+    m_lineBuffer.clear();
+    fmt::format_to(std::back_inserter(m_lineBuffer), "{:02}:{:02}:{:02}.{:03} [{}] ", time.tm_hour, time.tm_min, time.tm_sec,
+                   static_cast<int>(milliseconds), kLevelNames[entry.level]);
+    m_lineBuffer.append(batch.text.data() + entry.offset, batch.text.data() + entry.offset + entry.length);
+
+    ImGui::PushStyleColor(ImGuiCol_Text, LevelColor(entry.level));
+    ImGui::TextUnformatted(m_lineBuffer.data(), m_lineBuffer.data() + m_lineBuffer.size());
+    ImGui::PopStyleColor();
+}
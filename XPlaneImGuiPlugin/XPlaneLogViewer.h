@@ -0,0 +1,177 @@
+#ifndef XPLANELOGVIEWER_H
+#define XPLANELOGVIEWER_H
+
+// Standard Library Headers
+#include <array>              // For std::array
+#include <atomic>             // For std::atomic
+#include <condition_variable> // For std::condition_variable
+#include <cstdint>            // For fixed-width integers
+#include <deque>              // For std::deque
+#include <memory>             // For std::unique_ptr
+#include <mutex>              // For std::mutex
+#include <string>             // For std::string
+#include <thread>             // For std::thread
+#include <vector>             // For std::vector
+
+// Third-Party Library Headers
+#include <spdlog/details/log_msg.h>    // For spdlog::details::log_msg
+#include <spdlog/details/null_mutex.h> // For spdlog::details::null_mutex
+#include <spdlog/sinks/base_sink.h>    // For spdlog::sinks::base_sink
+
+// In-sim log window.
+// A sink keeps the most recent lines in a fixed-size ring (line table plus a text ring), so a
+// million lines cost two allocations and no per-line heap traffic. The ring is allocated the
+// first time the window is drawn, and lines logged before that are not kept; trim() frees it
+// again. The window draws only the visible rows with ImGuiListClipper.
+// Filtering runs on a worker thread that maintains an index of matching line numbers: new lines
+// are scanned as they arrive, and a filter that narrows the previous one (typing more characters,
+// unticking a level) only rescans the lines already in the index. The render thread never scans.
+// While the window is closed the worker sleeps until it is drawn again.
+class XPlaneLogViewer
+{
+public:
+    XPlaneLogViewer(size_t lineCapacity, size_t textCapacity);
+    ~XPlaneLogViewer();
+
+    // Sink to attach to the logger (or to the async worker)
+    spdlog::sink_ptr sink() const { return m_sink; }
+
+    // Draw the viewer window. Call from an ImGui render callback.
+    void render(bool *open);
+
+    // Forget every stored line
+    void clear();
+
+    // Free the line store and forget its lines; the next render() allocates it again.
+    // Main thread, not from inside a render callback.
+    void trim();
+
+private:
+    class Sink : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+    {
+    public:
+        explicit Sink(XPlaneLogViewer &viewer) : m_viewer(viewer) {}
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg &msg) override { m_viewer.append(msg); }
+        void flush_() override {}
+
+    private:
+        XPlaneLogViewer &m_viewer;
+    };
+
+    // One stored line; its text lives in the text ring at textOffset (modulo the ring size).
+    // Trivial, so the line table can be allocated without touching its pages.
+    struct Line
+    {
+        spdlog::log_clock::rep time;
+        uint64_t textOffset;
+        uint32_t length;
+        spdlog::level::level_enum level;
+    };
+
+    // Lines copied out of the store so they can be matched or drawn without holding its lock
+    struct Batch
+    {
+        struct Entry
+        {
+            uint64_t number;
+            spdlog::log_clock::time_point time;
+            spdlog::level::level_enum level;
+            size_t offset;
+            size_t length;
+        };
+
+        std::vector<Entry> entries;
+        std::vector<char> text;
+
+        void clear()
+        {
+            entries.clear();
+            text.clear();
+        }
+    };
+
+    struct Filter
+    {
+        std::string text; // Lower case
+        uint32_t levelMask = kAllLevels;
+
+        bool isActive() const { return !text.empty() || levelMask != kAllLevels; }
+
+        // True if every line matching this filter also matches the other one
+        bool narrows(const Filter &other) const;
+
+        bool matches(spdlog::level::level_enum level, const char *text, size_t length) const;
+    };
+
+    static constexpr uint32_t kAllLevels = (1u << spdlog::level::off) - 1;
+
+    // Lines longer than this are truncated when stored
+    static constexpr size_t kMaxLineLength = 16 * 1024;
+
+    // Lines per worker batch; the filter generation is checked between batches
+    static constexpr size_t kScanBatch = 4096;
+
+    // Store
+    void allocateStore();
+    void append(const spdlog::details::log_msg &msg);
+    void copyLine(uint64_t number, Batch &batch) const; // Store lock held
+    void copyRange(uint64_t first, uint64_t last, Batch &batch) const;
+    void copyLines(const uint64_t *numbers, size_t count, Batch &batch) const;
+
+    // Filter worker
+    void setFilter();
+    void workerLoop();
+    bool filterChanged(uint64_t generation);
+    void appendMatches(const Filter &filter, const Batch &batch);
+    void trimIndex();
+
+    void drawLine(const Batch &batch, const Batch::Entry &entry);
+
+    spdlog::sink_ptr m_sink;
+
+    // Line ring: line n is stored at m_lines[n & m_lineMask] while m_firstLine <= n < m_endLine
+    // Both are null until the window is first drawn and after trim(); m_storeAllocated is the
+    // render thread's copy of that state
+    mutable std::mutex m_storeMutex;
+    std::unique_ptr<Line[]> m_lines;
+    size_t m_lineCapacity;
+    size_t m_lineMask;
+    std::unique_ptr<char[]> m_text;
+    size_t m_textCapacity;
+    uint64_t m_textEnd = 0;
+    std::atomic<uint64_t> m_firstLine{0};
+    std::atomic<uint64_t> m_endLine{0};
+
+    // Filter requested by the UI, picked up by the worker
+    std::mutex m_filterMutex;
+    std::condition_variable m_filterCondition;
+    Filter m_filter;
+    uint64_t m_filterGeneration = 0;
+    bool m_stopping = false;
+    std::thread m_worker;
+
+    // Set by render(); the worker clears m_open once the window has not been drawn for a while
+    std::atomic<bool> m_open{false};
+    std::atomic<spdlog::log_clock::rep> m_lastRender{0};
+
+    // Line numbers matching the filter of m_indexGeneration, in ascending order
+    std::mutex m_indexMutex;
+    std::deque<uint64_t> m_index;
+    std::atomic<uint64_t> m_indexGeneration{0};
+    std::atomic<bool> m_indexActive{false};
+    std::atomic<bool> m_scanning{false};
+    std::vector<uint64_t> m_matches; // Worker scratch
+
+    // UI state, render thread only
+    std::array<bool, spdlog::level::off> m_levelEnabled;
+    char m_filterText[256] = "";
+    bool m_autoScroll = true;
+    bool m_storeAllocated = false;
+    std::vector<uint64_t> m_visibleNumbers;
+    Batch m_visibleBatch;
+    spdlog::memory_buf_t m_lineBuffer;
+};
+
+#endif // XPLANELOGVIEWER_H
@@ -0,0 +1,189 @@
+// Windows SDK headers
+#ifdef _WIN32
+#include <windows.h>
+#include <cstring> // For std::memset
+#else
+#include <fcntl.h>    // For open
+#include <sys/mman.h> // For mmap, munmap, shm_open and shm_unlink
+#include <unistd.h>   // For ftruncate and close
+#endif
+
+#include "XPlaneMappedFile.h"
+
+XPlaneMappedFile::~XPlaneMappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool XPlaneMappedFile::open(const std::string &path, size_t size)
+{
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    const DWORD sizeHigh = static_cast<DWORD>(static_cast<unsigned long long>(size) >> 32);
+    const DWORD sizeLow = static_cast<DWORD>(size & 0xFFFFFFFFull);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, sizeHigh, sizeLow, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void *data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+bool XPlaneMappedFile::openShared(const std::string &name, size_t size)
+{
+    close();
+
+    // Backed by the paging file; the segment disappears when the last handle is closed
+    const DWORD sizeHigh = static_cast<DWORD>(static_cast<unsigned long long>(size) >> 32);
+    const DWORD sizeLow = static_cast<DWORD>(size & 0xFFFFFFFFull);
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, sizeHigh, sizeLow, name.c_str());
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    void *data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    // A reader may still hold the segment of a previous session open, in which case it is reused
+    std::memset(data, 0, size);
+
+    m_mappingHandle = mapping;
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+void XPlaneMappedFile::close()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_mappingHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+        m_mappingHandle = nullptr;
+    }
+    if (m_fileHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+        m_fileHandle = nullptr;
+    }
+    m_size = 0;
+}
+
+#else
+
+bool XPlaneMappedFile::open(const std::string &path, size_t size)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+bool XPlaneMappedFile::openShared(const std::string &name, size_t size)
+{
+    close();
+
+    // A segment left behind by a crashed session may have the wrong size, and macOS cannot resize
+    // an existing one, so always start from a new segment. Readers of the old one see it go stale.
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    m_fd = fd;
+    m_data = data;
+    m_size = size;
+    m_sharedName = name;
+    return true;
+}
+
+void XPlaneMappedFile::close()
+{
+    if (m_data)
+    {
+        munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (!m_sharedName.empty())
+    {
+        shm_unlink(m_sharedName.c_str());
+        m_sharedName.clear();
+    }
+    m_size = 0;
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef XPLANEMAPPEDFILE_H
+#define XPLANEMAPPEDFILE_H
+
+// Standard Library Headers
+#include <cstddef> // For size_t
+#include <string>  // For std::string
+
+// A read-write memory mapping of a fixed-size file or named shared-memory segment.
+// Writes land in the OS page cache, so they reach the file even if the process crashes.
+class XPlaneMappedFile
+{
+public:
+    XPlaneMappedFile() = default;
+    ~XPlaneMappedFile();
+
+    XPlaneMappedFile(const XPlaneMappedFile &) = delete;
+    XPlaneMappedFile &operator=(const XPlaneMappedFile &) = delete;
+
+    // Create (or truncate) the file at path, size it and map it. Returns false on failure.
+    bool open(const std::string &path, size_t size);
+
+    // Create a named shared-memory segment of the given size (zero-filled) and map it, replacing
+    // any stale segment of the same name. Other processes open it by name; it is removed on close().
+    // Names follow the platform rules: "Local\..." on Windows, "/..." for shm_open elsewhere.
+    bool openShared(const std::string &name, size_t size);
+
+    // Unmap and close
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    void *data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    void *m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void *m_fileHandle = nullptr;
+    void *m_mappingHandle = nullptr;
+#else
+    int m_fd = -1;
+    std::string m_sharedName; // Unlinked on close
+#endif
+};
+
+#endif // XPLANEMAPPEDFILE_H
@@ -0,0 +1,603 @@
+#include "XPlaneMetrics.h"
+
+// Standard Library Headers
+#include <algorithm>     // For std::min, std::max and std::replace_if
+#include <array>         // For std::array
+#include <cctype>        // For std::isalnum
+#include <cmath>         // For std::ceil
+#include <cstdio>        // For std::FILE and std::fprintf
+#include <filesystem>    // For std::filesystem::path and std::filesystem::rename
+#include <map>           // For std::map
+#include <memory>        // For std::unique_ptr
+#include <mutex>         // For std::mutex
+#include <system_error>  // For std::error_code
+#include <unordered_map> // For std::unordered_map
+
+#if defined(_MSC_VER)
+#include <intrin.h> // For _BitScanReverse64
+#endif
+
+// Third-Party Library Headers
+#include <imgui.h>
+
+// X-Plane SDK Headers
+#include "XPLMPlugin.h" // For XPLMGetMyID and XPLMGetPluginInfo
+
+// Project-Specific Headers
+#include "XPlaneLog.h"
+
+namespace
+{
+    template <typename Metric>
+    struct Entry
+    {
+        std::string help;
+        std::string unit;
+        Metric metric;
+    };
+
+    // Metrics are created once and never destroyed, so references handed out stay valid.
+    // The lock is only taken to register or to walk the lists; writers never take it.
+    struct Registry
+    {
+        std::mutex mutex;
+        std::map<std::string, std::unique_ptr<Entry<XPlaneMetrics::Counter>>> counters;
+        std::map<std::string, std::unique_ptr<Entry<XPlaneMetrics::Gauge>>> gauges;
+        std::map<std::string, std::unique_ptr<Entry<XPlaneMetrics::Histogram>>> histograms;
+
+        std::mutex collectorsMutex; // Held while collectors run
+        std::map<int, std::function<void()>> collectors;
+        int nextCollectorId = 1;
+    };
+
+    // Function-local so metrics can be registered from static initializers
+    Registry &GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    std::atomic<size_t> g_NextShard{0};
+
+    template <typename Metric>
+    Metric &FindOrCreate(std::map<std::string, std::unique_ptr<Entry<Metric>>> &metrics, const std::string &name, const std::string &unit, const std::string &help)
+    {
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        auto &entry = metrics[name];
+        if (!entry)
+        {
+            entry = std::make_unique<Entry<Metric>>();
+            entry->help = help;
+            entry->unit = unit;
+        }
+        return entry->metric;
+    }
+
+    int HighestBit(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    uint64_t Percentile(const std::array<uint64_t, XPlaneMetrics::Histogram::kBuckets> &buckets, uint64_t count, double quantile, uint64_t min, uint64_t max)
+    {
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count))));
+        uint64_t seen = 0;
+        for (size_t index = 0; index < buckets.size(); ++index)
+        {
+            seen += buckets[index];
+            if (seen >= rank)
+            {
+                // Middle of the bucket, kept inside the observed range
+                uint64_t lower = XPlaneMetrics::Histogram::bucketLowerBound(index);
+                uint64_t middle = lower + (XPlaneMetrics::Histogram::bucketUpperBound(index) - lower) / 2;
+                return std::min(std::max(middle, min), max);
+            }
+        }
+        return max;
+    }
+
+    // Prometheus metric names allow [a-zA-Z0-9_:]
+    std::string ExportName(const std::string &name, const std::string &unit)
+    {
+        std::string result = unit.empty() ? name : name + "_" + unit;
+        std::replace_if(result.begin(), result.end(), [](char c)
+                        { return !std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != ':'; }, '_');
+        return result;
+    }
+
+    // Counter names end in _total, as Prometheus expects of counters
+    std::string CounterExportName(const std::string &name)
+    {
+        std::string result = ExportName(name, std::string());
+        const std::string suffix = "_total";
+        if (result.size() < suffix.size() || result.compare(result.size() - suffix.size(), suffix.size(), suffix) != 0)
+        {
+            result += suffix;
+        }
+        return result;
+    }
+
+    // HELP text escapes backslashes and newlines; label values also escape double quotes
+    std::string EscapeExportText(const std::string &text, bool quotes)
+    {
+        std::string result;
+        result.reserve(text.size());
+        for (char c : text)
+        {
+            if (c == '\\' || (quotes && c == '"'))
+            {
+                result += '\\';
+                result += c;
+            }
+            else if (c == '\n')
+            {
+                result += "\\n";
+            }
+            else
+            {
+                result += c;
+            }
+        }
+        return result;
+    }
+
+    std::string PluginName()
+    {
+        char pluginName[256];
+        XPLMGetPluginInfo(XPLMGetMyID(), pluginName, nullptr, nullptr, nullptr);
+        return pluginName;
+    }
+
+    // Nanosecond values are shown in the most readable unit
+    void FormatValue(char *text, size_t size, uint64_t value, const std::string &unit)
+    {
+        if (unit == "ns")
+        {
+            if (value >= 1000000000)
+                std::snprintf(text, size, "%.2f s", value / 1e9);
+            else if (value >= 1000000)
+                std::snprintf(text, size, "%.2f ms", value / 1e6);
+            else if (value >= 1000)
+                std::snprintf(text, size, "%.1f us", value / 1e3);
+            else
+                std::snprintf(text, size, "%llu ns", static_cast<unsigned long long>(value));
+        }
+        else
+        {
+            std::snprintf(text, size, "%llu %s", static_cast<unsigned long long>(value), unit.c_str());
+        }
+    }
+
+    // Panel state, render thread only
+    struct PanelState
+    {
+        XPlaneMetrics::Snapshot snapshot;
+        std::unordered_map<std::string, double> counterRates;
+        std::string lastExport;
+    };
+    PanelState g_Panel;
+
+    // How often the panel takes a new snapshot
+    constexpr std::chrono::milliseconds kPanelRefresh{500};
+} // namespace
+
+// Counter
+
+uint64_t XPlaneMetrics::Counter::value() const
+{
+    uint64_t total = 0;
+    for (const Shard &shard : m_shards)
+    {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void XPlaneMetrics::Counter::syncTotal(uint64_t total)
+{
+    uint64_t last = m_lastTotal.exchange(total, std::memory_order_relaxed);
+    add(total >= last ? total - last : total);
+}
+
+// Gauge
+
+void XPlaneMetrics::Gauge::add(double delta)
+{
+    double current = m_value.load(std::memory_order_relaxed);
+    while (!m_value.compare_exchange_weak(current, current + delta, std::memory_order_relaxed))
+    {
+    }
+}
+
+// Histogram
+
+size_t XPlaneMetrics::Histogram::bucketIndex(uint64_t value)
+{
+    constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+    if (value < kSubBuckets)
+    {
+        return static_cast<size_t>(value);
+    }
+
+    int exponent = HighestBit(value);
+    if (exponent > kMaxExponent)
+    {
+        return kBuckets - 1;
+    }
+
+    // The top kSubBucketBits bits below the leading one pick the sub-bucket
+    uint64_t subBucket = (value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+    return static_cast<size_t>((exponent - kSubBucketBits + 1) << kSubBucketBits) + static_cast<size_t>(subBucket);
+}
+
+uint64_t XPlaneMetrics::Histogram::bucketLowerBound(size_t index)
+{
+    constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    if (index < kSubBuckets)
+    {
+        return index;
+    }
+
+    int exponent = static_cast<int>(index >> kSubBucketBits) + kSubBucketBits - 1;
+    uint64_t subBucket = index & (kSubBuckets - 1);
+    return (kSubBuckets + subBucket) << (exponent - kSubBucketBits);
+}
+
+uint64_t XPlaneMetrics::Histogram::bucketUpperBound(size_t index)
+{
+    return index + 1 < kBuckets ? bucketLowerBound(index + 1) - 1 : UINT64_MAX;
+}
+
+void XPlaneMetrics::Histogram::record(uint64_t value)
+{
+    Shard &shard = m_shards[shardIndex()];
+    shard.buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+
+    // Only this thread's shard is touched, so these loops almost never retry
+    uint64_t current = shard.min.load(std::memory_order_relaxed);
+    while (value < current && !shard.min.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+    current = shard.max.load(std::memory_order_relaxed);
+    while (value > current && !shard.max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+// Registry
+
+size_t XPlaneMetrics::shardIndex()
+{
+    // Threads are spread over the shards in the order they first record
+    static thread_local size_t index = g_NextShard.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return index;
+}
+
+XPlaneMetrics::Counter &XPlaneMetrics::counter(const std::string &name, const std::string &help)
+{
+    return FindOrCreate(GetRegistry().counters, name, std::string(), help);
+}
+
+XPlaneMetrics::Gauge &XPlaneMetrics::gauge(const std::string &name, const std::string &help)
+{
+    return FindOrCreate(GetRegistry().gauges, name, std::string(), help);
+}
+
+XPlaneMetrics::Histogram &XPlaneMetrics::histogram(const std::string &name, const std::string &unit, const std::string &help)
+{
+    return FindOrCreate(GetRegistry().histograms, name, unit, help);
+}
+
+int XPlaneMetrics::addCollector(std::function<void()> collector)
+{
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.collectorsMutex);
+    int id = registry.nextCollectorId++;
+    registry.collectors[id] = std::move(collector);
+    return id;
+}
+
+void XPlaneMetrics::removeCollector(int id)
+{
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.collectorsMutex);
+    registry.collectors.erase(id);
+}
+
+XPlaneMetrics::Snapshot XPlaneMetrics::snapshot()
+{
+    Registry &registry = GetRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.collectorsMutex);
+        for (auto &collector : registry.collectors)
+        {
+            collector.second();
+        }
+    }
+
+    Snapshot snapshot;
+    snapshot.time = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    snapshot.counters.reserve(registry.counters.size());
+    for (const auto &counter : registry.counters)
+    {
+        snapshot.counters.push_back({counter.first, counter.second->help, counter.second->metric.value()});
+    }
+
+    snapshot.gauges.reserve(registry.gauges.size());
+    for (const auto &gauge : registry.gauges)
+    {
+        snapshot.gauges.push_back({gauge.first, gauge.second->help, gauge.second->metric.value()});
+    }
+
+    std::array<uint64_t, Histogram::kBuckets> buckets;
+    snapshot.histograms.reserve(registry.histograms.size());
+    for (const auto &histogram : registry.histograms)
+    {
+        HistogramValue value;
+        value.name = histogram.first;
+        value.help = histogram.second->help;
+        value.unit = histogram.second->unit;
+        value.min = UINT64_MAX;
+
+        // The count is taken from the buckets, so the percentiles always add up even while writers run
+        buckets.fill(0);
+        for (const Histogram::Shard &shard : histogram.second->metric.m_shards)
+        {
+            for (size_t index = 0; index < Histogram::kBuckets; ++index)
+            {
+                uint64_t bucket = shard.buckets[index].load(std::memory_order_relaxed);
+                buckets[index] += bucket;
+                value.count += bucket;
+            }
+            value.sum += shard.sum.load(std::memory_order_relaxed);
+            value.min = std::min(value.min, shard.min.load(std::memory_order_relaxed));
+            value.max = std::max(value.max, shard.max.load(std::memory_order_relaxed));
+        }
+
+        if (value.count == 0)
+        {
+            value.min = 0;
+        }
+        else
+        {
+            value.p50 = Percentile(buckets, value.count, 0.50, value.min, value.max);
+            value.p90 = Percentile(buckets, value.count, 0.90, value.min, value.max);
+            value.p99 = Percentile(buckets, value.count, 0.99, value.min, value.max);
+            value.p999 = Percentile(buckets, value.count, 0.999, value.min, value.max);
+        }
+        snapshot.histograms.push_back(std::move(value));
+    }
+
+    return snapshot;
+}
+
+std::string XPlaneMetrics::exportToFile()
+{
+    // <plugin folder>/<plugin name>_metrics.prom
+    char pluginName[256];
+    char pluginPath[512];
+    XPLMGetPluginInfo(XPLMGetMyID(), pluginName, pluginPath, nullptr, nullptr);
+    std::string sanitizedName = pluginName;
+    std::replace_if(sanitizedName.begin(), sanitizedName.end(), [](char c)
+                    { return !std::isalnum(static_cast<unsigned char>(c)) && c != '_'; }, '_');
+
+    std::filesystem::path path = std::filesystem::path(pluginPath).parent_path() / (sanitizedName + "_metrics.prom");
+    return exportToFile(path.string());
+}
+
+std::string XPlaneMetrics::exportToFile(const std::string &path)
+{
+    Snapshot snapshot = XPlaneMetrics::snapshot();
+
+    // Every sample carries the plugin name, so one collector can merge the files of several plugins
+    std::string labels = "plugin=\"" + EscapeExportText(PluginName(), true) + "\"";
+
+    std::string temporaryPath = path + ".tmp";
+    std::FILE *file = std::fopen(temporaryPath.c_str(), "w");
+    if (!file)
+    {
+        XPlaneLog::error("Metrics: could not write {}", temporaryPath);
+        return std::string();
+    }
+
+    for (const CounterValue &counter : snapshot.counters)
+    {
+        std::string name = CounterExportName(counter.name);
+        if (!counter.help.empty())
+        {
+            std::fprintf(file, "# HELP %s %s\n", name.c_str(), EscapeExportText(counter.help, false).c_str());
+        }
+        std::fprintf(file, "# TYPE %s counter\n%s{%s} %llu\n", name.c_str(), name.c_str(), labels.c_str(),
+                     static_cast<unsigned long long>(counter.value));
+    }
+
+    for (const GaugeValue &gauge : snapshot.gauges)
+    {
+        std::string name = ExportName(gauge.name, std::string());
+        if (!gauge.help.empty())
+        {
+            std::fprintf(file, "# HELP %s %s\n", name.c_str(), EscapeExportText(gauge.help, false).c_str());
+        }
+        std::fprintf(file, "# TYPE %s gauge\n%s{%s} %.17g\n", name.c_str(), name.c_str(), labels.c_str(), gauge.value);
+    }
+
+    // Histograms are exported as summaries: their quantiles are what dashboards compare across sims
+    for (const HistogramValue &histogram : snapshot.histograms)
+    {
+        std::string name = ExportName(histogram.name, histogram.unit);
+        if (!histogram.help.empty())
+        {
+            std::fprintf(file, "# HELP %s %s\n", name.c_str(), EscapeExportText(histogram.help, false).c_str());
+        }
+        std::fprintf(file, "# TYPE %s summary\n", name.c_str());
+        const std::pair<const char *, uint64_t> quantiles[] = {
+            {"0.5", histogram.p50}, {"0.9", histogram.p90}, {"0.99", histogram.p99}, {"0.999", histogram.p999}};
+        for (const auto &quantile : quantiles)
+        {
+            std::fprintf(file, "%s{%s,quantile=\"%s\"} %llu\n", name.c_str(), labels.c_str(), quantile.first,
+                         static_cast<unsigned long long>(quantile.second));
+        }
+        std::fprintf(file, "%s_sum{%s} %llu\n%s_count{%s} %llu\n", name.c_str(), labels.c_str(),
+                     static_cast<unsigned long long>(histogram.sum), name.c_str(), labels.c_str(),
+                     static_cast<unsigned long long>(histogram.count));
+    }
+
+    bool written = std::ferror(file) == 0;
+    written = std::fclose(file) == 0 && written;
+
+    std::error_code error;
+    if (written)
+    {
+        std::filesystem::rename(temporaryPath, path, error);
+    }
+    if (!written || error)
+    {
+        XPlaneLog::error("Metrics: could not write {}", path);
+        std::filesystem::remove(temporaryPath, error);
+        return std::string();
+    }
+    return path;
+}
+
+// Window
+
+void XPlaneMetrics::renderPanel(bool *open)
+{
+    ImGui::SetNextWindowSize(ImVec2(760, 520), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Metrics", open))
+    {
+        ImGui::End();
+        return;
+    }
+
+    // Refreshed at a fixed rate rather than every frame, which also gives the counter rates a stable interval
+    auto now = std::chrono::steady_clock::now();
+    if (g_Panel.snapshot.time.time_since_epoch().count() == 0 || now - g_Panel.snapshot.time >= kPanelRefresh)
+    {
+        Snapshot previous = std::move(g_Panel.snapshot);
+        g_Panel.snapshot = snapshot();
+
+        double seconds = std::chrono::duration<double>(g_Panel.snapshot.time - previous.time).count();
+        std::unordered_map<std::string, uint64_t> previousValues;
+        for (const CounterValue &counter : previous.counters)
+        {
+            previousValues[counter.name] = counter.value;
+        }
+        g_Panel.counterRates.clear();
+        for (const CounterValue &counter : g_Panel.snapshot.counters)
+        {
+            auto it = previousValues.find(counter.name);
+            if (it != previousValues.end() && seconds > 0.0)
+            {
+                g_Panel.counterRates[counter.name] = static_cast<double>(counter.value - it->second) / seconds;
+            }
+        }
+    }
+
+    if (ImGui::Button("Export"))
+    {
+        std::string path = exportToFile();
+        g_Panel.lastExport = path.empty() ? "Export failed, see the log" : "Wrote " + path;
+    }
+    if (!g_Panel.lastExport.empty())
+    {
+        ImGui::SameLine();
+        ImGui::TextDisabled("%s", g_Panel.lastExport.c_str());
+    }
+
+    const ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchProp;
+    const Snapshot &current = g_Panel.snapshot;
+
+    if (ImGui::CollapsingHeader("Histograms", ImGuiTreeNodeFlags_DefaultOpen) && ImGui::BeginTable("##Histograms", 7, tableFlags))
+    {
+        ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, 3.0f);
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("Min");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("p99.9");
+        ImGui::TableSetupColumn("Max");
+        ImGui::TableHeadersRow();
+
+        char text[32];
+        for (const HistogramValue &histogram : current.histograms)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(histogram.name.c_str());
+            if (!histogram.help.empty() && ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("%s", histogram.help.c_str());
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(histogram.count));
+            for (uint64_t value : {histogram.min, histogram.p50, histogram.p99, histogram.p999, histogram.max})
+            {
+                ImGui::TableNextColumn();
+                FormatValue(text, sizeof(text), value, histogram.unit);
+                ImGui::TextUnformatted(text);
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::CollapsingHeader("Counters", ImGuiTreeNodeFlags_DefaultOpen) && ImGui::BeginTable("##Counters", 3, tableFlags))
+    {
+        ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, 3.0f);
+        ImGui::TableSetupColumn("Value");
+        ImGui::TableSetupColumn("Per second");
+        ImGui::TableHeadersRow();
+
+        for (const CounterValue &counter : current.counters)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(counter.name.c_str());
+            if (!counter.help.empty() && ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("%s", counter.help.c_str());
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(counter.value));
+            ImGui::TableNextColumn();
+            auto rate = g_Panel.counterRates.find(counter.name);
+            if (rate != g_Panel.counterRates.end())
+            {
+                ImGui::Text("%.1f", rate->second);
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::CollapsingHeader("Gauges", ImGuiTreeNodeFlags_DefaultOpen) && ImGui::BeginTable("##Gauges", 2, tableFlags))
+    {
+        ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, 3.0f);
+        ImGui::TableSetupColumn("Value");
+        ImGui::TableHeadersRow();
+
+        for (const GaugeValue &gauge : current.gauges)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(gauge.name.c_str());
+            if (!gauge.help.empty() && ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("%s", gauge.help.c_str());
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.6g", gauge.value);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
@@ -0,0 +1,169 @@
+#ifndef XPLANEMETRICS_H
+#define XPLANEMETRICS_H
+
+// Standard Library Headers
+#include <atomic>     // For std::atomic
+#include <chrono>     // For std::chrono::steady_clock
+#include <cstddef>    // For size_t
+#include <cstdint>    // For fixed-width integers
+#include <functional> // For std::function
+#include <string>     // For std::string
+#include <vector>     // For std::vector
+
+// Plugin metrics registry.
+// Counters and histograms are sharded: each thread writes its own cache-line-aligned shard with
+// relaxed atomics, so hot paths on different threads never share a cache line. snapshot() sums
+// the shards without stopping writers. Gauges hold a single last-written value.
+// Register a metric once and keep the reference, e.g.
+//     static XPlaneMetrics::Counter &clicks = XPlaneMetrics::counter("imgui.mouse_clicks");
+//     clicks.add();
+// Names use dots; they become underscores in the exported file, where counters also get the
+// Prometheus "_total" suffix.
+class XPlaneMetrics
+{
+public:
+    static constexpr size_t kShards = 8;
+
+    class Counter
+    {
+    public:
+        void add(uint64_t value = 1) { m_shards[shardIndex()].value.fetch_add(value, std::memory_order_relaxed); }
+        uint64_t value() const;
+
+        // For a running total kept elsewhere and copied in by a collector: adds what it has grown by
+        // since the previous call. A total that restarts from zero (a restarted subsystem) counts on
+        // from there, so the counter never goes down.
+        void syncTotal(uint64_t total);
+
+    private:
+        struct alignas(64) Shard
+        {
+            std::atomic<uint64_t> value{0};
+        };
+        Shard m_shards[kShards];
+        std::atomic<uint64_t> m_lastTotal{0};
+    };
+
+    class Gauge
+    {
+    public:
+        void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+        void add(double delta);
+        double value() const { return m_value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<double> m_value{0.0};
+    };
+
+    // Log-linear buckets: 16 per power of two, so a recorded value is reported within about 3%.
+    // Values from 0 to 2^48 are tracked; larger ones land in the last bucket (max stays exact).
+    class Histogram
+    {
+    public:
+        static constexpr int kSubBucketBits = 4;
+        static constexpr int kMaxExponent = 47;
+        static constexpr size_t kBuckets = (kMaxExponent - kSubBucketBits + 2) << kSubBucketBits;
+
+        void record(uint64_t value);
+
+        static size_t bucketIndex(uint64_t value);
+        static uint64_t bucketLowerBound(size_t index);
+        static uint64_t bucketUpperBound(size_t index);
+
+    private:
+        friend class XPlaneMetrics;
+
+        struct alignas(64) Shard
+        {
+            std::atomic<uint64_t> sum{0};
+            std::atomic<uint64_t> min{UINT64_MAX};
+            std::atomic<uint64_t> max{0};
+            std::atomic<uint64_t> buckets[kBuckets] = {};
+        };
+        Shard m_shards[kShards];
+    };
+
+    // Records the lifetime of the scope in nanoseconds
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Histogram &histogram) : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer()
+        {
+            m_histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count()));
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        Histogram &m_histogram;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    struct CounterValue
+    {
+        std::string name;
+        std::string help;
+        uint64_t value = 0;
+    };
+
+    struct GaugeValue
+    {
+        std::string name;
+        std::string help;
+        double value = 0.0;
+    };
+
+    struct HistogramValue
+    {
+        std::string name;
+        std::string help;
+        std::string unit;
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t min = 0;
+        uint64_t max = 0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+
+        double mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+    };
+
+    struct Snapshot
+    {
+        std::chrono::steady_clock::time_point time;
+        std::vector<CounterValue> counters;
+        std::vector<GaugeValue> gauges;
+        std::vector<HistogramValue> histograms;
+    };
+
+    // Find or create a metric. The returned reference stays valid while the plugin is loaded.
+    static Counter &counter(const std::string &name, const std::string &help = std::string());
+    static Gauge &gauge(const std::string &name, const std::string &help = std::string());
+    static Histogram &histogram(const std::string &name, const std::string &unit = "ns", const std::string &help = std::string());
+
+    // Collectors run at the start of every snapshot, to refresh gauges from stats that live elsewhere.
+    // They run on the thread taking the snapshot; the built-in ones expect the main thread.
+    static int addCollector(std::function<void()> collector);
+    static void removeCollector(int id);
+
+    // Current value of every metric, sorted by name
+    static Snapshot snapshot();
+
+    // Write a snapshot in Prometheus text format to <plugin folder>/<plugin name>_metrics.prom, or to path.
+    // The file is replaced atomically, so a collector polling it never reads a partial file.
+    // Returns the path written, or an empty string on failure.
+    static std::string exportToFile();
+    static std::string exportToFile(const std::string &path);
+
+    // Draw the metrics window. Call from an ImGui render callback.
+    static void renderPanel(bool *open);
+
+private:
+    static size_t shardIndex();
+};
+
+#endif // XPLANEMETRICS_H
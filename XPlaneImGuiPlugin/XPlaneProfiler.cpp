@@ -0,0 +1,376 @@
+#include "XPlaneProfiler.h"
+
+// Standard Library Headers
+#include <algorithm>  // For std::min and std::replace_if
+#include <cctype>     // For std::isalnum
+#include <chrono>     // For std::chrono::steady_clock
+#include <cstdio>     // For std::FILE and std::fprintf
+#include <ctime>      // For std::strftime
+#include <filesystem> // For std::filesystem::path
+#include <memory>     // For std::unique_ptr
+#include <mutex>      // For std::mutex
+#include <thread>     // For std::this_thread::yield
+#include <vector>     // For std::vector
+
+// X-Plane SDK Headers
+#include "XPLMPlugin.h"     // For XPLMGetMyID and XPLMGetPluginInfo
+#include "XPLMProcessing.h" // For XPLMRegisterFlightLoopCallback
+
+// Project-Specific Headers
+#include "XPlaneLog.h"
+
+std::atomic<bool> XPlaneProfiler::s_enabled{false};
+
+namespace
+{
+    struct Event
+    {
+        const char *name;
+        int64_t start;
+        int64_t end;
+        int64_t arg;
+    };
+
+    // Ring slot. Relaxed atomics let dump() read a slot its thread is overwriting; such reads are discarded.
+    struct EventSlot
+    {
+        std::atomic<const char *> name;
+        std::atomic<int64_t> start;
+        std::atomic<int64_t> end;
+        std::atomic<int64_t> arg;
+    };
+
+    // Ring of the most recent zones of one thread. Only that thread writes it; dump() copies it
+    // and discards whatever may have been overwritten while it was copying. The ring is allocated
+    // at the thread's first zone while the profiler is enabled, so a thread that only names itself
+    // costs a name. shutdown() and trim() release it.
+    // Owned by g_Buffers, not by the thread: a thread_local with a destructor would run it on
+    // threads that outlive the plugin after X-Plane has unloaded it. The small record itself stays
+    // until unload, so a thread's pointer to it never dangles.
+    struct ThreadBuffer
+    {
+        uint32_t id = 0;
+        std::string name;
+        std::atomic<EventSlot *> events{nullptr};
+        size_t mask = 0;
+        std::atomic<uint64_t> writeIndex{0};
+        std::atomic<bool> recording{false}; // Set while the owner may be writing to events
+    };
+
+    std::mutex g_BuffersMutex; // Guards the list, thread names, and ring allocation and release
+    std::vector<std::unique_ptr<ThreadBuffer>> g_Buffers;
+    size_t g_EventsPerThread = 65536;
+    uint32_t g_NextThreadId = 1;
+    thread_local ThreadBuffer *t_Buffer = nullptr;
+
+    // Frame start times, main thread only
+    constexpr size_t kMaxFrames = 4096;
+    int64_t g_FrameStarts[kMaxFrames];
+    uint64_t g_FrameCount = 0;
+    int g_DumpFrames = 300;
+
+    ThreadBuffer *GetThreadBuffer()
+    {
+        if (!t_Buffer)
+        {
+            auto buffer = std::make_unique<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(g_BuffersMutex);
+            buffer->id = g_NextThreadId++;
+            buffer->name = "Thread " + std::to_string(buffer->id);
+            t_Buffer = buffer.get();
+            g_Buffers.push_back(std::move(buffer));
+        }
+        return t_Buffer;
+    }
+
+    // Called by the owning thread
+    void AllocateRing(ThreadBuffer &buffer)
+    {
+        size_t capacity = 2;
+        std::lock_guard<std::mutex> lock(g_BuffersMutex);
+        while (capacity < g_EventsPerThread)
+        {
+            capacity <<= 1;
+        }
+
+        // Allocated without initialization, so pages are only touched as zones are recorded
+        buffer.mask = capacity - 1;
+        buffer.writeIndex.store(0, std::memory_order_relaxed);
+        buffer.events.store(new EventSlot[capacity]);
+    }
+
+    // Buffers lock held. The owner sets recording before it loads events, so once events is
+    // cleared, waiting for recording to drop is enough to know it is done with the old ring.
+    void ReleaseRing(ThreadBuffer &buffer)
+    {
+        EventSlot *events = buffer.events.exchange(nullptr);
+        while (buffer.recording.load())
+        {
+            std::this_thread::yield();
+        }
+        delete[] events;
+    }
+
+    // Quoted JSON string; zone and thread names come from callers and may hold quotes or backslashes
+    void WriteJsonString(std::FILE *file, const char *text)
+    {
+        std::fputc('"', file);
+        for (const char *c = text; *c; ++c)
+        {
+            unsigned char ch = static_cast<unsigned char>(*c);
+            if (ch == '"' || ch == '\\')
+            {
+                std::fputc('\\', file);
+                std::fputc(ch, file);
+            }
+            else if (ch < 0x20)
+            {
+                std::fprintf(file, "\\u%04x", ch);
+            }
+            else
+            {
+                std::fputc(ch, file);
+            }
+        }
+        std::fputc('"', file);
+    }
+
+    // Frames are counted on X-Plane's flight loop, so they advance even while no ImGui window is drawn
+    float FrameMarkFlightLoopCallback(float /*elapsedSinceLastCall*/, float /*elapsedSinceLastFlightLoop*/, int /*counter*/, void * /*refcon*/)
+    {
+        XPlaneProfiler::frameMark();
+        return -1.0f;
+    }
+
+    void WriteEvent(std::FILE *file, const Event &event, uint32_t threadId, int64_t origin, bool &first)
+    {
+        double timestamp = static_cast<double>(event.start - origin) / 1000.0;
+        std::fprintf(file, "%s\n{\"name\":", first ? "" : ",");
+        WriteJsonString(file, event.name);
+        std::fprintf(file, ",\"cat\":\"xp\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,", threadId, timestamp);
+        first = false;
+
+        // Zero-length zones are markers
+        if (event.end == event.start)
+        {
+            std::fprintf(file, "\"ph\":\"i\",\"s\":\"t\"");
+        }
+        else
+        {
+            std::fprintf(file, "\"ph\":\"X\",\"dur\":%.3f", static_cast<double>(event.end - event.start) / 1000.0);
+        }
+
+        if (event.arg >= 0)
+        {
+            std::fprintf(file, ",\"args\":{\"value\":%lld}", static_cast<long long>(event.arg));
+        }
+        std::fprintf(file, "}");
+    }
+} // namespace
+
+void XPlaneProfiler::init()
+{
+    init(Options());
+}
+
+void XPlaneProfiler::init(const Options &options)
+{
+    if (isEnabled())
+    {
+        return;
+    }
+
+    g_EventsPerThread = options.eventsPerThread;
+    setDumpFrames(options.dumpFrames);
+
+    XPLMRegisterFlightLoopCallback(FrameMarkFlightLoopCallback, -1.0f, nullptr);
+    setThreadName("Main");
+    s_enabled.store(true);
+}
+
+void XPlaneProfiler::shutdown()
+{
+    if (!s_enabled.exchange(false))
+    {
+        return;
+    }
+    XPLMUnregisterFlightLoopCallback(FrameMarkFlightLoopCallback, nullptr);
+    trim();
+}
+
+void XPlaneProfiler::trim()
+{
+    std::lock_guard<std::mutex> lock(g_BuffersMutex);
+    for (const auto &buffer : g_Buffers)
+    {
+        ReleaseRing(*buffer);
+    }
+}
+
+int64_t XPlaneProfiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void XPlaneProfiler::record(const char *name, int64_t start, int64_t end, int64_t arg)
+{
+    ThreadBuffer *buffer = GetThreadBuffer();
+    buffer->recording.store(true);
+    EventSlot *events = buffer->events.load();
+    if (!events)
+    {
+        buffer->recording.store(false, std::memory_order_release);
+        if (!isEnabled())
+        {
+            return;
+        }
+        AllocateRing(*buffer);
+        buffer->recording.store(true);
+        events = buffer->events.load();
+        if (!events)
+        {
+            // Released again by trim() or shutdown() in the meantime
+            buffer->recording.store(false, std::memory_order_release);
+            return;
+        }
+    }
+
+    uint64_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+
+    // Publish the previous index before overwriting a slot, so a reader that sees the new contents also sees the index
+    std::atomic_thread_fence(std::memory_order_release);
+    EventSlot &slot = events[index & buffer->mask];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.arg.store(arg, std::memory_order_relaxed);
+    buffer->writeIndex.store(index + 1, std::memory_order_release);
+    buffer->recording.store(false, std::memory_order_release);
+}
+
+void XPlaneProfiler::frameMark()
+{
+    int64_t frameStart = now();
+    g_FrameStarts[g_FrameCount % kMaxFrames] = frameStart;
+    ++g_FrameCount;
+
+    if (isEnabled())
+    {
+        record("X-Plane flight loop", frameStart, frameStart, static_cast<int64_t>(g_FrameCount));
+    }
+}
+
+void XPlaneProfiler::setThreadName(const char *name)
+{
+    ThreadBuffer *buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(g_BuffersMutex);
+    buffer->name = name;
+}
+
+void XPlaneProfiler::setDumpFrames(int frames)
+{
+    g_DumpFrames = std::max(1, std::min(frames, static_cast<int>(kMaxFrames) - 1));
+}
+
+int XPlaneProfiler::getDumpFrames()
+{
+    return g_DumpFrames;
+}
+
+std::string XPlaneProfiler::dump()
+{
+    if (g_FrameCount == 0)
+    {
+        XPlaneLog::warn("Profiler: no frames recorded yet");
+        return std::string();
+    }
+
+    // The window starts at the oldest of the last g_DumpFrames frames
+    uint64_t frames = std::min<uint64_t>({static_cast<uint64_t>(g_DumpFrames), g_FrameCount, kMaxFrames});
+    int64_t windowStart = g_FrameStarts[(g_FrameCount - frames) % kMaxFrames];
+
+    // <plugin folder>/<plugin name>_profile_<local time>.json
+    char pluginName[256];
+    char pluginPath[512];
+    XPLMGetPluginInfo(XPLMGetMyID(), pluginName, pluginPath, nullptr, nullptr);
+    std::string sanitizedName = pluginName;
+    std::replace_if(sanitizedName.begin(), sanitizedName.end(), [](char c)
+                    { return !std::isalnum(static_cast<unsigned char>(c)) && c != '_'; }, '_');
+
+    char timeText[32];
+    std::time_t wallTime = std::time(nullptr);
+    std::strftime(timeText, sizeof(timeText), "%Y%m%d_%H%M%S", std::localtime(&wallTime));
+
+    std::filesystem::path path = std::filesystem::path(pluginPath).parent_path() / (sanitizedName + "_profile_" + timeText + ".json");
+
+    std::FILE *file = std::fopen(path.string().c_str(), "w");
+    if (!file)
+    {
+        XPlaneLog::error("Profiler: could not write {}", path.string());
+        return std::string();
+    }
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    size_t written = 0;
+
+    std::fprintf(file, "\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":");
+    WriteJsonString(file, sanitizedName.c_str());
+    std::fprintf(file, "}}");
+    first = false;
+
+    std::vector<Event> events;
+    std::unique_lock<std::mutex> lock(g_BuffersMutex);
+    for (const auto &buffer : g_Buffers)
+    {
+        std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", buffer->id);
+        WriteJsonString(file, buffer->name.c_str());
+        std::fprintf(file, "}}");
+
+        // Ring allocation and release take the lock we hold, so the ring stays put while we read it
+        const EventSlot *ring = buffer->events.load();
+        if (!ring)
+        {
+            continue;
+        }
+
+        size_t capacity = buffer->mask + 1;
+        uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t begin = end > capacity ? end - capacity : 0;
+
+        events.resize(static_cast<size_t>(end - begin));
+        for (uint64_t index = begin; index < end; ++index)
+        {
+            const EventSlot &slot = ring[index & buffer->mask];
+            Event &event = events[static_cast<size_t>(index - begin)];
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.start = slot.start.load(std::memory_order_relaxed);
+            event.end = slot.end.load(std::memory_order_relaxed);
+            event.arg = slot.arg.load(std::memory_order_relaxed);
+        }
+
+        // Entries the owning thread may have overwritten while they were being copied, including the
+        // slot it may be writing right now
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t endAfterCopy = buffer->writeIndex.load(std::memory_order_relaxed);
+        uint64_t firstIntact = endAfterCopy + 1 > capacity ? endAfterCopy + 1 - capacity : 0;
+
+        for (uint64_t index = std::max(begin, firstIntact); index < end; ++index)
+        {
+            const Event &event = events[static_cast<size_t>(index - begin)];
+            if (event.start >= windowStart)
+            {
+                WriteEvent(file, event, buffer->id, windowStart, first);
+                ++written;
+            }
+        }
+    }
+
+    lock.unlock();
+
+    std::fprintf(file, "\n]}\n");
+    std::fclose(file);
+
+    XPlaneLog::info("Profiler: wrote {} zones from the last {} frames to {}", written, frames, path.string());
+    return path.string();
+}
@@ -0,0 +1,99 @@
+#ifndef XPLANEPROFILER_H
+#define XPLANEPROFILER_H
+
+// Standard Library Headers
+#include <atomic>  // For std::atomic
+#include <cstddef> // For size_t
+#include <cstdint> // For fixed-width integers
+#include <string>  // For std::string
+
+// Scoped timeline profiler.
+// XP_PROFILE_SCOPE("name") records the start and end of the enclosing scope into a per-thread ring
+// that only its own thread writes, so recording takes no lock. Recording is always on, which
+// means a stutter can be captured after it was noticed: dump() writes the last N frames of every
+// thread as Chrome trace JSON (open in chrome://tracing or ui.perfetto.dev).
+// A thread's ring is allocated at its first zone after init() and freed by trim() or shutdown().
+// Rings of threads that have exited stay until then, so their zones still appear in dump().
+// Zone names must be string literals or otherwise outlive the profiler.
+class XPlaneProfiler
+{
+public:
+    struct Options
+    {
+        // Ring size per thread in zones (rounded up to a power of two)
+        size_t eventsPerThread = 65536;
+        // Frames written by dump()
+        int dumpFrames = 300;
+    };
+
+    static void init();
+    static void init(const Options &options);
+    static void shutdown();
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Mark the start of a frame on the main thread. init() registers a flight loop callback that
+    // calls this once per X-Plane frame.
+    static void frameMark();
+
+    // Name the calling thread in the trace. Allocates no ring.
+    static void setThreadName(const char *name);
+
+    // Free every thread's ring; threads allocate a new one at their next zone while enabled.
+    // Their earlier zones are lost.
+    static void trim();
+
+    static void setDumpFrames(int frames);
+    static int getDumpFrames();
+
+    // Write the last getDumpFrames() frames to <plugin folder>/<name>_profile_<time>.json.
+    // Main thread only. Returns the file path, or an empty string on failure.
+    static std::string dump();
+
+    // Monotonic time in nanoseconds
+    static int64_t now();
+
+    static void record(const char *name, int64_t start, int64_t end, int64_t arg);
+
+    class Scope
+    {
+    public:
+        explicit Scope(const char *name, int64_t arg = -1)
+            : m_name(name), m_arg(arg), m_start(isEnabled() ? now() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (m_start != 0)
+            {
+                record(m_name, m_start, now(), m_arg);
+            }
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *m_name;
+        int64_t m_arg;
+        int64_t m_start;
+    };
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+#define XP_PROFILE_CONCAT_INNER(a, b) a##b
+#define XP_PROFILE_CONCAT(a, b) XP_PROFILE_CONCAT_INNER(a, b)
+
+// Time the enclosing scope. The _ARG form adds a number shown in the zone's arguments.
+#if defined(XPLANE_PROFILER_DISABLED)
+#define XP_PROFILE_SCOPE(name) (void)0
+#define XP_PROFILE_SCOPE_ARG(name, arg) (void)0
+#else
+#define XP_PROFILE_SCOPE(name) XPlaneProfiler::Scope XP_PROFILE_CONCAT(xp_profile_scope_, __LINE__)(name)
+#define XP_PROFILE_SCOPE_ARG(name, arg) XPlaneProfiler::Scope XP_PROFILE_CONCAT(xp_profile_scope_, __LINE__)(name, arg)
+#endif
+
+#endif // XPLANEPROFILER_H
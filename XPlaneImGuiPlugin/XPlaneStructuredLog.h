@@ -0,0 +1,60 @@
+#ifndef XPLANESTRUCTUREDLOG_H
+#define XPLANESTRUCTUREDLOG_H
+
+// Standard Library Headers
+#include <cstdint> // For fixed-width integers
+
+// On-disk layout of the binary structured log (<plugin>.binlog).
+// The file is a FileHeader followed by blocks. Format definition blocks register a format
+// string and its argument types under an id; record blocks hold a thread's records back to back.
+// Records are packed without padding, so readers must memcpy fields out.
+// This header has no dependencies so the offline decoder can share it.
+namespace XPlaneStructuredLogFormat
+{
+    constexpr uint32_t kMagic = 0x4C425058; // "XPBL"
+    constexpr uint32_t kVersion = 1;
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+    };
+
+    enum BlockType : uint32_t
+    {
+        // Payload: uint32 id, uint32 argCount, char argTypes[argCount], uint32 formatLength, char format[formatLength]
+        Block_FormatDefinition = 1,
+        // Payload: RecordHeader + packed arguments, repeated
+        Block_Records = 2,
+    };
+
+    struct BlockHeader
+    {
+        uint32_t type;
+        uint32_t size;     // Payload bytes following this header
+        uint64_t threadId; // Thread that wrote the records (0 for definitions)
+    };
+
+    struct RecordHeader
+    {
+        uint32_t formatId;
+        uint32_t size; // Bytes including this header
+        int64_t timestampNs; // Nanoseconds since the Unix epoch
+    };
+
+    // Argument type codes. Integers are widened to 32 or 64 bits; strings are a uint16 length followed by the bytes.
+    enum ArgType : char
+    {
+        Arg_Int32 = 'i',
+        Arg_UInt32 = 'I',
+        Arg_Int64 = 'l',
+        Arg_UInt64 = 'L',
+        Arg_Float = 'f',
+        Arg_Double = 'd',
+        Arg_Bool = 'b',
+        Arg_Char = 'c',
+        Arg_String = 's',
+    };
+} // namespace XPlaneStructuredLogFormat
+
+#endif // XPLANESTRUCTUREDLOG_H
@@ -0,0 +1,82 @@
+#ifndef XPLANETELEMETRY_H
+#define XPLANETELEMETRY_H
+
+// Standard Library Headers
+#include <atomic>  // For std::atomic
+#include <cstddef> // For size_t
+#include <cstdint> // For fixed-width integers
+#include <string>  // For std::string
+
+// Layout of the shared-memory telemetry segment published by XPlaneTelemetryPublisher.
+// The segment is a header followed by a table of named values. Values are updated under a
+// seqlock: the writer makes sequence odd, writes, then makes it even again, so a reader copies
+// the table and retries if sequence was odd or changed meanwhile. Entries are only appended, and
+// an entry's name is written before entryCount covers it. This header has no dependencies so
+// external readers can share it.
+namespace XPlaneTelemetryFormat
+{
+    constexpr uint32_t kMagic = 0x4D545058; // "XPTM"
+    constexpr uint32_t kVersion = 1;
+
+    enum class Kind : uint32_t
+    {
+        Counter = 1,   // Monotonic count
+        Gauge = 2,     // Last value
+        Histogram = 3, // One statistic of a histogram; the name ends in .count, .mean, .p50, .p99 or .max
+    };
+
+    struct SegmentHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerSize; // sizeof(SegmentHeader)
+        uint32_t entrySize;  // sizeof(Entry)
+        uint32_t entryCapacity;
+        std::atomic<uint32_t> entryCount;
+        std::atomic<uint64_t> sequence; // Odd while the values are being written
+        int64_t publishTimeNs;          // Wall clock of the last publish, nanoseconds since the Unix epoch
+        uint32_t publishIntervalMs;
+        uint32_t processId;
+        std::atomic<uint32_t> closed; // Set when the plugin stops; the segment is then removed
+        uint32_t reserved;
+        char pluginName[64];
+        uint8_t reserved2[8];
+    };
+
+    struct Entry
+    {
+        char name[48]; // Null-terminated metric name, e.g. "imgui.frame_time.p99"; longer names end in "~<hash>.<stat>"
+        char unit[8];  // "ns", "bytes" or empty
+        Kind kind;
+        uint32_t reserved;
+        double value;
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free, "Telemetry requires lock-free atomics");
+    static_assert(sizeof(SegmentHeader) == 128, "SegmentHeader layout changed");
+    static_assert(sizeof(Entry) == 72, "Entry layout changed");
+
+    inline size_t SegmentSize(uint32_t entryCapacity)
+    {
+        return sizeof(SegmentHeader) + static_cast<size_t>(entryCapacity) * sizeof(Entry);
+    }
+
+    // Name of the segment for a plugin: "Local\XPlaneTelemetry_<name>" on Windows, "/xptm_<name>"
+    // for shm_open elsewhere (kept within macOS's 31-character limit)
+    inline std::string SegmentName(const std::string &pluginName)
+    {
+        std::string sanitized;
+        for (char c : pluginName)
+        {
+            bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+            sanitized += valid ? c : '_';
+        }
+#ifdef _WIN32
+        return "Local\\XPlaneTelemetry_" + sanitized;
+#else
+        return "/xptm_" + sanitized.substr(0, 25);
+#endif
+    }
+} // namespace XPlaneTelemetryFormat
+
+#endif // XPLANETELEMETRY_H
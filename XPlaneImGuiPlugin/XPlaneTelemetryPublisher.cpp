@@ -0,0 +1,237 @@
+// Windows SDK headers
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX // Keep std::min and std::max usable
+#endif
+#include <windows.h>
+#else
+#include <unistd.h> // For getpid
+#endif
+
+#include "XPlaneTelemetryPublisher.h"
+
+// Standard Library Headers
+#include <algorithm>     // For std::max
+#include <atomic>        // For std::atomic_thread_fence
+#include <cstring>       // For std::strncpy
+#include <unordered_map> // For std::unordered_map
+#include <utility>       // For std::pair
+#include <vector>        // For std::vector
+
+// X-Plane SDK Headers
+#include "XPLMProcessing.h" // For XPLMRegisterFlightLoopCallback
+
+// Project-Specific Headers
+#include "XPlaneLog.h"
+#include "XPlaneMappedFile.h"
+#include "XPlaneMetrics.h"
+#include "XPlaneProfiler.h"
+#include "XPlaneTelemetry.h"
+
+using namespace XPlaneTelemetryFormat;
+
+namespace
+{
+    XPlaneMappedFile g_Segment;
+    SegmentHeader *g_Header = nullptr;
+    Entry *g_Entries = nullptr;
+    std::string g_SegmentName;
+    float g_IntervalSeconds = 0.25f;
+
+    // Entry index by metric name; entries are never removed
+    std::unordered_map<std::string, uint32_t> g_EntryIndex;
+    bool g_TableFullReported = false;
+    bool g_LongNameReported = false;
+
+    // Values of one publish, staged so the seqlock is held only while they are copied in
+    std::vector<std::pair<uint32_t, double>> g_Values;
+
+    // Entry::name holds 47 characters. Longer metric names keep their start and their last
+    // component (".p99") around a hash of the whole name, so they stay distinct and are shortened
+    // the same way on every run.
+    std::string EntryName(const std::string &name)
+    {
+        constexpr size_t kMaxLength = sizeof(Entry::name) - 1;
+        if (name.size() <= kMaxLength)
+        {
+            return name;
+        }
+
+        uint32_t hash = 2166136261u; // FNV-1a
+        for (char c : name)
+        {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        const std::string hashText = fmt::format("~{:08x}", hash);
+
+        size_t dot = name.rfind('.');
+        std::string suffix = dot != std::string::npos && name.size() - dot <= 8 ? name.substr(dot) : std::string();
+        std::string shortened = name.substr(0, kMaxLength - hashText.size() - suffix.size()) + hashText + suffix;
+
+        if (!g_LongNameReported)
+        {
+            XPlaneLog::warn("Telemetry: metric names over {} characters are shortened, e.g. {} is published as {}", kMaxLength, name, shortened);
+            g_LongNameReported = true;
+        }
+        return shortened;
+    }
+
+    // Index of the entry for name, appending it when new. UINT32_MAX when the table is full.
+    uint32_t FindOrAddEntry(const std::string &name, Kind kind, const std::string &unit)
+    {
+        auto it = g_EntryIndex.find(name);
+        if (it != g_EntryIndex.end())
+        {
+            return it->second;
+        }
+
+        uint32_t index = g_Header->entryCount.load(std::memory_order_relaxed);
+        if (index >= g_Header->entryCapacity)
+        {
+            if (!g_TableFullReported)
+            {
+                XPlaneLog::warn("Telemetry: table full ({} entries), {} and later metrics are not published", g_Header->entryCapacity, name);
+                g_TableFullReported = true;
+            }
+            return UINT32_MAX;
+        }
+
+        // Readers only look at entries below entryCount, so the name is complete before it is counted
+        Entry &entry = g_Entries[index];
+        std::strncpy(entry.name, EntryName(name).c_str(), sizeof(entry.name) - 1);
+        std::strncpy(entry.unit, unit.c_str(), sizeof(entry.unit) - 1);
+        entry.kind = kind;
+        g_Header->entryCount.store(index + 1, std::memory_order_release);
+
+        g_EntryIndex.emplace(name, index);
+        return index;
+    }
+
+    void Stage(const std::string &name, Kind kind, const std::string &unit, double value)
+    {
+        uint32_t index = FindOrAddEntry(name, kind, unit);
+        if (index != UINT32_MAX)
+        {
+            g_Values.emplace_back(index, value);
+        }
+    }
+
+    float PublishFlightLoopCallback(float /*elapsedSinceLastCall*/, float /*elapsedSinceLastFlightLoop*/, int /*counter*/, void * /*refcon*/)
+    {
+        XPlaneTelemetryPublisher::publish();
+        return g_IntervalSeconds;
+    }
+} // namespace
+
+bool XPlaneTelemetryPublisher::init(const std::string &pluginName)
+{
+    return init(pluginName, Options());
+}
+
+bool XPlaneTelemetryPublisher::init(const std::string &pluginName, const Options &options)
+{
+    if (g_Header)
+    {
+        return true;
+    }
+
+    std::string segmentName = SegmentName(pluginName);
+    if (!g_Segment.openShared(segmentName, SegmentSize(options.maxEntries)))
+    {
+        XPlaneLog::warn("Telemetry: could not create shared memory segment {}", segmentName);
+        return false;
+    }
+
+    g_Header = static_cast<SegmentHeader *>(g_Segment.data());
+    g_Entries = reinterpret_cast<Entry *>(static_cast<char *>(g_Segment.data()) + sizeof(SegmentHeader));
+    g_Header->headerSize = sizeof(SegmentHeader);
+    g_Header->entrySize = sizeof(Entry);
+    g_Header->entryCapacity = options.maxEntries;
+    g_Header->publishIntervalMs = static_cast<uint32_t>(options.publishInterval.count());
+#ifdef _WIN32
+    g_Header->processId = static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    g_Header->processId = static_cast<uint32_t>(getpid());
+#endif
+    std::strncpy(g_Header->pluginName, pluginName.c_str(), sizeof(g_Header->pluginName) - 1);
+    g_Header->version = kVersion;
+
+    // Readers check the magic last, so they never see a half-initialized header as valid
+    std::atomic_thread_fence(std::memory_order_release);
+    g_Header->magic = kMagic;
+
+    g_SegmentName = segmentName;
+    g_IntervalSeconds = std::max(0.01f, static_cast<float>(options.publishInterval.count()) / 1000.0f);
+    g_TableFullReported = false;
+    g_LongNameReported = false;
+    XPLMRegisterFlightLoopCallback(PublishFlightLoopCallback, g_IntervalSeconds, nullptr);
+
+    XPlaneLog::info("Telemetry: publishing to shared memory segment {}", segmentName);
+    return true;
+}
+
+void XPlaneTelemetryPublisher::shutdown()
+{
+    if (!g_Header)
+    {
+        return;
+    }
+
+    XPLMUnregisterFlightLoopCallback(PublishFlightLoopCallback, nullptr);
+
+    // Readers that still have the segment mapped see that no more updates will come
+    g_Header->closed.store(1, std::memory_order_release);
+    g_Header = nullptr;
+    g_Entries = nullptr;
+    g_Segment.close();
+
+    g_EntryIndex.clear();
+    g_SegmentName.clear();
+}
+
+void XPlaneTelemetryPublisher::publish()
+{
+    if (!g_Header)
+    {
+        return;
+    }
+
+    XP_PROFILE_SCOPE("XPlaneTelemetryPublisher::publish");
+    XPlaneMetrics::Snapshot snapshot = XPlaneMetrics::snapshot();
+
+    g_Values.clear();
+    for (const XPlaneMetrics::CounterValue &counter : snapshot.counters)
+    {
+        Stage(counter.name, Kind::Counter, std::string(), static_cast<double>(counter.value));
+    }
+    for (const XPlaneMetrics::GaugeValue &gauge : snapshot.gauges)
+    {
+        Stage(gauge.name, Kind::Gauge, std::string(), gauge.value);
+    }
+    for (const XPlaneMetrics::HistogramValue &histogram : snapshot.histograms)
+    {
+        Stage(histogram.name + ".count", Kind::Histogram, std::string(), static_cast<double>(histogram.count));
+        Stage(histogram.name + ".mean", Kind::Histogram, histogram.unit, histogram.mean());
+        Stage(histogram.name + ".p50", Kind::Histogram, histogram.unit, static_cast<double>(histogram.p50));
+        Stage(histogram.name + ".p99", Kind::Histogram, histogram.unit, static_cast<double>(histogram.p99));
+        Stage(histogram.name + ".max", Kind::Histogram, histogram.unit, static_cast<double>(histogram.max));
+    }
+
+    // Seqlock write: odd while the values change
+    uint64_t sequence = g_Header->sequence.load(std::memory_order_relaxed);
+    g_Header->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (const auto &value : g_Values)
+    {
+        g_Entries[value.first].value = value.second;
+    }
+    g_Header->publishTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    g_Header->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+std::string XPlaneTelemetryPublisher::getSegmentName()
+{
+    return g_SegmentName;
+}
@@ -0,0 +1,35 @@
+#ifndef XPLANETELEMETRYPUBLISHER_H
+#define XPLANETELEMETRYPUBLISHER_H
+
+// Standard Library Headers
+#include <chrono>  // For std::chrono::milliseconds
+#include <cstdint> // For fixed-width integers
+#include <string>  // For std::string
+
+// Publishes every XPlaneMetrics value into a named shared-memory segment (layout in
+// XPlaneTelemetry.h), so monitoring tools on the same machine can read a running sim's numbers
+// with plain memory loads instead of parsing logs. The TelemetryReader tool is an example reader.
+// Publishing runs on a flight loop callback on the main thread.
+class XPlaneTelemetryPublisher
+{
+public:
+    struct Options
+    {
+        std::chrono::milliseconds publishInterval{250};
+        // Table size; metrics beyond it are not published
+        uint32_t maxEntries = 1024;
+    };
+
+    // Create the segment and start publishing. Returns false if the segment could not be created.
+    static bool init(const std::string &pluginName);
+    static bool init(const std::string &pluginName, const Options &options);
+    static void shutdown();
+
+    // Publish now, outside the regular interval
+    static void publish();
+
+    // Name other processes open the segment by, empty when not publishing
+    static std::string getSegmentName();
+};
+
+#endif // XPLANETELEMETRYPUBLISHER_H
@@ -4,27 +4,47 @@
 #endif
 
 #include "imgui_impl_xplane.h"
+#include "imgui_impl_xplane_atlas.h"
+#include "imgui_impl_xplane_hittest.h"
+#include "imgui_impl_xplane_ini.h"
+#include "imgui_impl_xplane_texture.h"
+#include "imgui_impl_xplane_throttle.h"
+#include "imgui_impl_xplane_xplm.h"
 
 // Standard library headers
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
 #include <filesystem>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 // X-Plane SDK headers
 #include <XPLMDisplay.h>
 #include <XPLMPlugin.h>
+#include <XPLMProcessing.h>
 #include <XPLMUtilities.h>
 #include <XPLMGraphics.h>
 
 // ImGui core library
 #include <imgui.h>
 
+// ImGui internals, for the window list in NativeWindows mode
+#include <imgui_internal.h>
+
 // OpenGL3 backend for ImGui
 #include <backends/imgui_impl_opengl3.h>
 #include <backends/imgui_impl_opengl3_loader.h> // required for OpenGL3 loader: glTexImage2D, glTexParameteri, etc.
 
 // Project-specific headers
 #include "XPlaneLog.h"
+#include "XPlaneLogViewer.h"
+#include "XPlaneMetrics.h"
+#include "XPlaneProfiler.h"
 
 // Logging macro for function calls with plugin name
 #define LOG_CALL(func, ...)                                            \
@@ -60,6 +80,83 @@ namespace ImGui
         // Optional callback for key event notifications (after ImGui processes them)
         static ImGuiKeyEventCallback g_KeyEventCallback = nullptr;
 
+        // Refreshes the allocator gauges for XPlaneMetrics snapshots
+        static int g_MetricsCollector = 0;
+
+        // Metrics
+        static XPlaneMetrics::Counter &MouseEventsMetric()
+        {
+            static XPlaneMetrics::Counter &counter = XPlaneMetrics::counter("imgui.mouse_events", "Mouse button and wheel events received by the overlay");
+            return counter;
+        }
+
+        static XPlaneMetrics::Counter &KeyEventsMetric()
+        {
+            static XPlaneMetrics::Counter &counter = XPlaneMetrics::counter("imgui.key_events", "Key events received by the overlay");
+            return counter;
+        }
+
+        // How ImGui windows are shown, see WindowMode
+        static WindowMode g_WindowMode = WindowMode::FullScreenOverlay;
+
+        // Stats of the last completed frame
+        static FrameStats g_LastFrameStats;
+        static std::vector<CallbackTiming> g_LastCallbackTimings;
+
+        static uint64_t NanosecondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+
+        // Time of the oldest input event not yet reflected in a rendered frame
+        static std::chrono::steady_clock::time_point g_PendingInputTime;
+
+        static void MarkInputPending()
+        {
+            if (g_PendingInputTime.time_since_epoch().count() == 0)
+            {
+                g_PendingInputTime = std::chrono::steady_clock::now();
+            }
+            NotifyInput();
+        }
+
+        // Render time histogram of a callback, "imgui.callback.<name>", created on first use
+        static XPlaneMetrics::Histogram &CallbackTimeMetric(const ImGuiRenderCallbackWrapper &callback)
+        {
+            static std::unordered_map<int, XPlaneMetrics::Histogram *> histograms;
+            auto it = histograms.find(callback.getId());
+            if (it != histograms.end())
+            {
+                return *it->second;
+            }
+
+            std::string name = std::string("imgui.callback.") + callback.getName();
+            for (char &c : name)
+            {
+                c = (c == ' ') ? '_' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            XPlaneMetrics::Histogram &histogram = XPlaneMetrics::histogram(name, "ns", "CPU time of one render callback");
+            histograms.emplace(callback.getId(), &histogram);
+            return histogram;
+        }
+
+        // Publishes the allocator's last-frame stats and the process resident size as gauges
+        static void CollectAllocatorMetrics()
+        {
+            static XPlaneMetrics::Gauge &bytesInUse = XPlaneMetrics::gauge("imgui.heap_bytes_in_use", "Live ImGui heap bytes");
+            static XPlaneMetrics::Gauge &poolBytes = XPlaneMetrics::gauge("imgui.heap_pool_bytes", "Memory held by the ImGui small-block pool");
+            static XPlaneMetrics::Gauge &allocations = XPlaneMetrics::gauge("imgui.allocations_per_frame", "ImGui allocations in the last frame");
+            static XPlaneMetrics::Gauge &arenaBytes = XPlaneMetrics::gauge("imgui.frame_arena_bytes", "FrameAlloc bytes used in the last frame");
+            static XPlaneMetrics::Gauge &residentBytes = XPlaneMetrics::gauge("process.resident_bytes", "Resident set size of the X-Plane process");
+
+            AllocatorStats stats = GetAllocatorStats();
+            bytesInUse.set(static_cast<double>(stats.bytesInUse));
+            poolBytes.set(static_cast<double>(stats.poolBytesReserved));
+            allocations.set(static_cast<double>(stats.allocations));
+            arenaBytes.set(static_cast<double>(stats.frameArenaBytes));
+            residentBytes.set(static_cast<double>(GetResidentMemoryBytes()));
+        }
+
         // Caution: The menu bar height is not included in the screen height and it may vary across platforms
         // int g_menuBarHeight = 30; // Height of the menu bar
 
@@ -67,35 +164,49 @@ namespace ImGui
         static void UpdateWindowGeometry()
         {
             // Update g_WindowGeometry with the new geometry of the "Minimal Window"
-            XPLMGetWindowGeometry(xplmWindowID, &g_WindowGeometry.left, &g_WindowGeometry.top, &g_WindowGeometry.right, &g_WindowGeometry.bottom);
+            Xplm::GetWindowGeometry(xplmWindowID, &g_WindowGeometry.left, &g_WindowGeometry.top, &g_WindowGeometry.right, &g_WindowGeometry.bottom);
             // Update width and height based on the obtained geometry
             g_WindowGeometry.width = g_WindowGeometry.right - g_WindowGeometry.left;
             g_WindowGeometry.height = g_WindowGeometry.top - g_WindowGeometry.bottom;
         }
 
+        // XPLM window coordinates to ImGui display coordinates (Y axis inverted)
+        static ImVec2 ToImGuiPos(int x, int y)
+        {
+            return ImVec2(static_cast<float>(x), static_cast<float>(g_WindowGeometry.top - y));
+        }
+
+        // Whether ImGui last saw the mouse over its content, so it is told once when the mouse leaves
+        static bool g_MouseOverImGui = false;
+
         // Forward declarations
         static void RenderImGuiFrame();
 
         // Callbacks
         static int HandleMouseClickEvent(XPLMWindowID inWindowID, int x, int y, XPLMMouseStatus isDown, void *inRefcon)
         {
-            // Update ImGui mouse position
-            ImGuiIO &io = ImGui::GetIO();
+            XP_PROFILE_SCOPE("HandleMouseClickEvent");
+            MouseEventsMetric().add();
             // Invert the Y-axis to match ImGui's coordinate system
-            io.MousePos = ImVec2(static_cast<float>(x), static_cast<float>(g_WindowGeometry.top - y));
+            const ImVec2 mousePos = ToImGuiPos(x, y);
 
-            // Determine if the mouse is over any ImGui content
-            if (io.WantCaptureMouse)
+            // A press is ours if it lands on ImGui content; X-Plane only sends the drag and release
+            // of a press we claimed
+            if (isDown != xplm_MouseDown || HitTest(mousePos))
             {
+                MarkInputPending();
+                ImGuiIO &io = ImGui::GetIO();
+                io.MousePos = mousePos;
+                g_MouseOverImGui = true;
                 // Forward the mouse click to ImGui by updating the ImGuiIO structure
                 if (isDown == xplm_MouseDown)
                 {
                     io.MouseDown[0] = true; // Left mouse button down
                     // Bring window to front so it receives input above other plugins
-                    XPLMBringWindowToFront(inWindowID);
+                    Xplm::BringWindowToFront(inWindowID);
                     // Take keyboard focus when the mouse is clicked in an ImGui window
-                    if (!XPLMHasKeyboardFocus(inWindowID))
-                        XPLMTakeKeyboardFocus(inWindowID);
+                    if (!Xplm::HasKeyboardFocus(inWindowID))
+                        Xplm::TakeKeyboardFocus(inWindowID);
                 }
                 else if (isDown == xplm_MouseDrag)
                 {
@@ -113,9 +224,10 @@ namespace ImGui
             {
                 // Mouse click is outside ImGui, disengage and pass the event to X-Plane
                 // Ensure that the keyboard focus is removed from the XPLM window if it has it
-                if (XPLMHasKeyboardFocus(inWindowID))
+                ImGuiIO &io = ImGui::GetIO();
+                if (Xplm::HasKeyboardFocus(inWindowID))
                 {
-                    XPLMTakeKeyboardFocus(nullptr);
+                    Xplm::TakeKeyboardFocus(nullptr);
                     // Clear input keys (in case any are pending)
                     io.ClearInputKeys();
                     
@@ -137,14 +249,24 @@ namespace ImGui
 
         static XPLMCursorStatus HandleCursorEvent(XPLMWindowID inWindowID, int x, int y, void *inRefcon)
         {
-            // Update ImGui mouse position
-            ImGuiIO &io = ImGui::GetIO();
+            XP_PROFILE_SCOPE("HandleCursorEvent");
             // Invert the Y-axis to match ImGui's coordinate system
-            io.MousePos = ImVec2(static_cast<float>(x), static_cast<float>(g_WindowGeometry.top - y));
+            const ImVec2 mousePos = ToImGuiPos(x, y);
 
-            // Determine if the mouse is over any ImGui content
-            if (io.WantCaptureMouse)
+            // Determine if the mouse is over any ImGui content, or dragging something of ours
+            ImGuiIO &io = ImGui::GetIO();
+            if (HitTest(mousePos) || io.MouseDown[0] || io.MouseDown[1])
             {
+                // Hover feedback is input too; X-Plane also calls this while the mouse stands still
+                if (mousePos.x != io.MousePos.x || mousePos.y != io.MousePos.y)
+                {
+                    NotifyInput();
+                }
+
+                // Update ImGui mouse position
+                io.MousePos = mousePos;
+                g_MouseOverImGui = true;
+
                 // ImGui wants to capture the mouse, so don't pass the event to the underlying application
 
                 // Get the current ImGui mouse cursor
@@ -191,6 +313,12 @@ namespace ImGui
                 return xplm_CursorCustom;
             }
 
+            // Let ImGui drop its hover state once; further moves over the sim need no ImGui work
+            if (g_MouseOverImGui)
+            {
+                io.MousePos = ImVec2(-FLT_MAX, -FLT_MAX);
+                g_MouseOverImGui = false;
+            }
             return xplm_CursorDefault; // Return the default cursor for other cases
         }
 
@@ -203,14 +331,21 @@ namespace ImGui
 
         static int HandleRightClickEvent(XPLMWindowID in_window_id, int x, int y, int is_down, void *in_refcon)
         {
-            // Update ImGui mouse position
-            ImGuiIO &io = ImGui::GetIO();
+            XP_PROFILE_SCOPE("HandleRightClickEvent");
+            MouseEventsMetric().add();
             // Invert the Y-axis to match ImGui's coordinate system
-            io.MousePos = ImVec2(static_cast<float>(x), static_cast<float>(g_WindowGeometry.top - y));
+            const ImVec2 mousePos = ToImGuiPos(x, y);
 
-            // Determine if the mouse is over any ImGui content
-            if (io.WantCaptureMouse)
+            // A press is ours if it lands on ImGui content; X-Plane only sends the drag and release
+            // of a press we claimed
+            if (is_down != xplm_MouseDown || HitTest(mousePos))
             {
+                MarkInputPending();
+                // Update ImGui mouse position
+                ImGuiIO &io = ImGui::GetIO();
+                io.MousePos = mousePos;
+                g_MouseOverImGui = true;
+
                 if (is_down == xplm_MouseDown)
                 {
                     io.MouseDown[1] = true; // Right mouse button down
@@ -236,9 +371,12 @@ namespace ImGui
 
         static int HandleMouseWheelEvent(XPLMWindowID in_window_id, int x, int y, int wheel, int clicks, void *in_refcon)
         {
-            ImGuiIO &io = ImGui::GetIO();
-            if (io.WantCaptureMouse)
+            XP_PROFILE_SCOPE("HandleMouseWheelEvent");
+            MouseEventsMetric().add();
+            if (HitTest(ToImGuiPos(x, y)))
             {
+                MarkInputPending();
+                ImGuiIO &io = ImGui::GetIO();
                 io.MouseWheel += static_cast<float>(clicks);
                 return 1; // Indicate that the event has been handled by ImGui
             }
@@ -247,7 +385,17 @@ namespace ImGui
 
         static void HandleKeyEvent(XPLMWindowID in_window_id, char key, XPLMKeyFlags flags, char virtual_key, void *in_refcon, int losing_focus)
         {
+            XP_PROFILE_SCOPE("HandleKeyEvent");
             ImGuiIO &io = ImGui::GetIO();
+            if (losing_focus)
+            {
+                // Not a key press: another window took the keyboard
+                Xplm::KeyboardFocusLost(in_window_id);
+                io.ClearInputKeys();
+                return;
+            }
+            KeyEventsMetric().add();
+            MarkInputPending();
             // Ensure ImGui is capturing keyboard input
             if (io.WantCaptureKeyboard)
             {
@@ -384,7 +532,8 @@ namespace ImGui
                         // Ignore null virtual keys (normal when no key is pressed)
                         if (virtual_key != 0) {
                         // Log the unrecognized key using the provided logger
-                            XPlaneLog::warn(("Unrecognized virtual key: " + std::to_string(virtual_key)).c_str());
+                        // The macro records the call site so the throttle rate-limits this line on its own
+                            XPLOG_WARN("Unrecognized virtual key: {}", static_cast<int>(virtual_key));
                         }
                         imguiKey = ImGuiKey_None; 
                         break; 
@@ -454,6 +603,26 @@ namespace ImGui
             }
         }
 
+        // Set g_WindowGeometry to the screen
+        static void SetScreenGeometry()
+        {
+            // Relying on the lower-left corner of the primary monitor being at (0, 0) is not advisable.
+            // It is necessary to obtain the global desktop dimensions.
+            int left, bottom, right, top;
+            Xplm::GetScreenBoundsGlobal(&left, &top, &right, &bottom);
+
+            // Retrieve the screen width and height
+            int screenWidth, screenHeight;
+            Xplm::GetScreenSize(&screenWidth, &screenHeight);
+
+            g_WindowGeometry.width = screenWidth;
+            g_WindowGeometry.height = screenHeight;
+            g_WindowGeometry.left = left;
+            g_WindowGeometry.bottom = bottom;
+            g_WindowGeometry.right = left + screenWidth;
+            g_WindowGeometry.top = bottom + screenHeight;
+        }
+
         static void InitializeTransparentImGuiOverlay()
         {
             XPLMCreateWindow_t params{};
@@ -476,32 +645,341 @@ namespace ImGui
             // params.decorateAsFloatingWindow = xplm_WindowDecorationSelfDecorated; // Self-decorated window
             // params.decorateAsFloatingWindow = xplm_WindowDecorationSelfDecoratedResizable; // Self-decorated resizable window
 
-            // Initialize the window boundaries.
-            // Relying on the lower-left corner of the primary monitor being at (0, 0) is not advisable.
-            // It is necessary to obtain the global desktop dimensions.
-            int left, bottom, right, top;
-            XPLMGetScreenBoundsGlobal(&left, &top, &right, &bottom);
+            // Full screen window
+            // Ensure geometry is updated before window creation so that it is available in callbacks
+            SetScreenGeometry();
+            params.left = g_WindowGeometry.left;
+            params.bottom = g_WindowGeometry.bottom;
+            params.right = g_WindowGeometry.right;
+            params.top = g_WindowGeometry.top;
 
-            // Retrieve the screen width and height
+            // Create the window
+            xplmWindowID = Xplm::CreateXPLMWindow(&params);
+        }
+
+        // Resize the overlay to cover the screen again after the sim window changed size
+        static void FitWindowToScreen()
+        {
+            if (!xplmWindowID)
+            {
+                // NativeWindows mode only needs the new screen geometry
+                SetScreenGeometry();
+                return;
+            }
+            int left, top, right, bottom;
+            Xplm::GetScreenBoundsGlobal(&left, &top, &right, &bottom);
             int screenWidth, screenHeight;
-            XPLMGetScreenSize(&screenWidth, &screenHeight);
+            Xplm::GetScreenSize(&screenWidth, &screenHeight);
+            Xplm::SetWindowGeometry(xplmWindowID, left, bottom + screenHeight, left + screenWidth, bottom);
+            UpdateWindowGeometry();
+            XPlaneLog::info("ImGui overlay resized to {}x{}", g_WindowGeometry.width, g_WindowGeometry.height);
+        }
 
-            // Full screen window
-            params.left = left + 0;
-            params.bottom = bottom + 0;
-            params.right = params.left + screenWidth;
-            params.top = params.bottom + screenHeight;
+        // NativeWindows mode
+        // Margin around each ImGui window, so the resize grips just outside its edge get the mouse
+        constexpr int kNativeWindowPadding = 4;
 
-            // Ensure geometry is updated before window creation so that it is available in callbacks
-            g_WindowGeometry.width = screenWidth;
-            g_WindowGeometry.height = screenHeight;
-            g_WindowGeometry.left = params.left;
-            g_WindowGeometry.top = params.top;
-            g_WindowGeometry.right = params.right;
-            g_WindowGeometry.bottom = params.bottom;
+        // The XPLM window of one top-level ImGui window, and its share of the frame's draw data
+        struct NativeWindow
+        {
+            XPLMWindowID id = nullptr;
+            int left = 0, top = 0, right = 0, bottom = 0; // XPLM global coordinates
+            bool used = false;                             // Drawn in the current frame
+            ImDrawData drawData;
+        };
 
-            // Create the window
-            xplmWindowID = XPLMCreateWindowEx(&params);
+        // By ImGui window ID; map nodes are stable, so a NativeWindow's address is its XPLM refcon
+        static std::unordered_map<ImGuiID, NativeWindow> g_NativeWindows;
+
+        // Draw lists that belong to no window (foreground and background lists)
+        static ImDrawData g_UnownedDrawData;
+
+        // Scratch for matching draw lists to their native window
+        static std::vector<std::pair<ImDrawList *, NativeWindow *>> g_DrawListOwners;
+
+        static void ClearDrawDataSubset(ImDrawData &subset, const ImDrawData &source)
+        {
+            // Copy the display fields, then collect the lists again
+            subset = source;
+            subset.CmdLists.resize(0);
+            subset.CmdListsCount = 0;
+            subset.TotalVtxCount = 0;
+            subset.TotalIdxCount = 0;
+        }
+
+        static void AddToDrawDataSubset(ImDrawData &subset, ImDrawList *drawList)
+        {
+            subset.CmdLists.push_back(drawList);
+            subset.CmdListsCount++;
+            subset.TotalVtxCount += drawList->VtxBuffer.Size;
+            subset.TotalIdxCount += drawList->IdxBuffer.Size;
+        }
+
+        static void NativeWindowDrawCallback(XPLMWindowID inWindowID, void *inRefcon)
+        {
+            XP_PROFILE_SCOPE("NativeWindowDrawCallback");
+            // The projection still spans the screen; the window only limits what X-Plane composites
+            NativeWindow *native = static_cast<NativeWindow *>(inRefcon);
+            if (native->drawData.CmdListsCount > 0)
+            {
+                ImGui_ImplOpenGL3_RenderDrawData(&native->drawData);
+            }
+        }
+
+        // Builds the ImGui frame once per sim frame, independent of which windows exist
+        static int NativeFrameDrawCallback(XPLMDrawingPhase inPhase, int inIsBefore, void *inRefcon)
+        {
+            RenderImGuiFrame();
+            return 1;
+        }
+
+        // Create, move and destroy XPLM windows to match this frame's top-level ImGui windows and
+        // hand each its draw lists, in their original order
+        static void SyncNativeWindows(ImDrawData *drawData)
+        {
+            XP_PROFILE_SCOPE("SyncNativeWindows");
+            ImGuiContext &g = *GImGui;
+
+            for (auto &entry : g_NativeWindows)
+            {
+                entry.second.used = false;
+            }
+
+            for (ImGuiWindow *window : g.Windows)
+            {
+                if (!window->Active || window->Hidden || window->RootWindow != window)
+                {
+                    continue;
+                }
+
+                NativeWindow &native = g_NativeWindows[window->ID];
+                if (!native.used)
+                {
+                    ClearDrawDataSubset(native.drawData, *drawData);
+                    native.used = true;
+                }
+
+                // ImGui display coordinates to XPLM global coordinates, as the mouse handlers do
+                const ImRect rect = window->Rect();
+                const int left = g_WindowGeometry.left + static_cast<int>(std::floor(rect.Min.x)) - kNativeWindowPadding;
+                const int right = g_WindowGeometry.left + static_cast<int>(std::ceil(rect.Max.x)) + kNativeWindowPadding;
+                const int top = g_WindowGeometry.top - static_cast<int>(std::floor(rect.Min.y)) + kNativeWindowPadding;
+                const int bottom = g_WindowGeometry.top - static_cast<int>(std::ceil(rect.Max.y)) - kNativeWindowPadding;
+
+                if (!native.id)
+                {
+                    XPLMCreateWindow_t params{};
+                    params.structSize = sizeof(params);
+                    params.visible = 1;
+                    params.left = left;
+                    params.top = top;
+                    params.right = right;
+                    params.bottom = bottom;
+                    params.drawWindowFunc = NativeWindowDrawCallback;
+                    params.handleMouseClickFunc = HandleMouseClickEvent;
+                    params.handleRightClickFunc = HandleRightClickEvent;
+                    params.handleMouseWheelFunc = HandleMouseWheelEvent;
+                    params.handleKeyFunc = HandleKeyEvent;
+                    params.handleCursorFunc = HandleCursorEvent;
+                    params.refcon = &native;
+                    params.layer = xplm_WindowLayerFloatingWindows;
+                    params.decorateAsFloatingWindow = xplm_WindowDecorationNone;
+                    native.id = Xplm::CreateXPLMWindow(&params);
+                }
+                else if (left != native.left || top != native.top || right != native.right || bottom != native.bottom)
+                {
+                    Xplm::SetWindowGeometry(native.id, left, top, right, bottom);
+                }
+                native.left = left;
+                native.top = top;
+                native.right = right;
+                native.bottom = bottom;
+            }
+
+            // Every window's draw list goes to the native window of its root window
+            g_DrawListOwners.clear();
+            for (ImGuiWindow *window : g.Windows)
+            {
+                if (window->Active && !window->Hidden)
+                {
+                    auto it = g_NativeWindows.find(window->RootWindow->ID);
+                    if (it != g_NativeWindows.end() && it->second.used)
+                    {
+                        g_DrawListOwners.emplace_back(window->DrawList, &it->second);
+                    }
+                }
+            }
+            ClearDrawDataSubset(g_UnownedDrawData, *drawData);
+            for (int i = 0; i < drawData->CmdListsCount; i++)
+            {
+                ImDrawList *drawList = drawData->CmdLists[i];
+                auto owner = std::find_if(g_DrawListOwners.begin(), g_DrawListOwners.end(), [drawList](const std::pair<ImDrawList *, NativeWindow *> &entry)
+                                          { return entry.first == drawList; });
+                AddToDrawDataSubset(owner != g_DrawListOwners.end() ? owner->second->drawData : g_UnownedDrawData, drawList);
+            }
+
+            for (auto it = g_NativeWindows.begin(); it != g_NativeWindows.end();)
+            {
+                if (!it->second.used)
+                {
+                    Xplm::DestroyXPLMWindow(it->second.id);
+                    it = g_NativeWindows.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            // Drawn here, under the windows
+            if (g_UnownedDrawData.CmdListsCount > 0)
+            {
+                ImGui_ImplOpenGL3_RenderDrawData(&g_UnownedDrawData);
+            }
+        }
+
+        // Create the XPLM windows of the current mode
+        static void CreateModeWindows()
+        {
+            if (g_WindowMode == WindowMode::FullScreenOverlay)
+            {
+                InitializeTransparentImGuiOverlay();
+            }
+            else
+            {
+                SetScreenGeometry();
+                Xplm::RegisterDrawCallback(NativeFrameDrawCallback, xplm_Phase_Window, 1);
+            }
+        }
+
+        static void DestroyModeWindows()
+        {
+            if (xplmWindowID)
+            {
+                Xplm::DestroyXPLMWindow(xplmWindowID);
+                xplmWindowID = nullptr;
+            }
+            if (g_WindowMode == WindowMode::NativeWindows)
+            {
+                Xplm::UnregisterDrawCallback(NativeFrameDrawCallback, xplm_Phase_Window, 1);
+                for (auto &entry : g_NativeWindows)
+                {
+                    Xplm::DestroyXPLMWindow(entry.second.id);
+                }
+                g_NativeWindows.clear();
+            }
+        }
+
+        // Auto-suspend
+        // Once every render callback is hidden and ImGui has closed its last window, frames draw
+        // nothing. The overlay is then hidden, so X-Plane stops calling its draw, mouse and cursor
+        // handlers, until a flight loop sees a callback become visible again.
+        static bool g_Suspended = false;
+
+        static XPlaneMetrics::Counter &SuspendsMetric()
+        {
+            static XPlaneMetrics::Counter &counter = XPlaneMetrics::counter("imgui.suspends", "Times ImGui frames stopped because nothing was visible");
+            return counter;
+        }
+
+        static bool AnyCallbackVisible()
+        {
+            return std::any_of(g_ImGuiRenderCallbacks.begin(), g_ImGuiRenderCallbacks.end(), [](const ImGuiRenderCallbackWrapper &callback)
+                               { return callback.getVisibilityFlag(); });
+        }
+
+        static bool AnyWindowOpen()
+        {
+            ImGuiContext &g = *GImGui;
+            return std::any_of(g.Windows.begin(), g.Windows.end(), [](const ImGuiWindow *window)
+                               { return window->Active && !window->Hidden; });
+        }
+
+        // Starts or stops whatever drives the frames in the current mode
+        static void SetFramesRunning(bool running)
+        {
+            if (g_WindowMode == WindowMode::FullScreenOverlay)
+            {
+                if (xplmWindowID)
+                {
+                    Xplm::SetWindowIsVisible(xplmWindowID, running ? 1 : 0);
+                }
+            }
+            else if (running)
+            {
+                Xplm::RegisterDrawCallback(NativeFrameDrawCallback, xplm_Phase_Window, 1);
+            }
+            else
+            {
+                Xplm::UnregisterDrawCallback(NativeFrameDrawCallback, xplm_Phase_Window, 1);
+            }
+        }
+
+        static void SuspendFrames()
+        {
+            ReleaseKeyboardFocus();
+            // No cursor events arrive while suspended
+            ImGui::GetIO().MousePos = ImVec2(-FLT_MAX, -FLT_MAX);
+            g_MouseOverImGui = false;
+            SetFramesRunning(false);
+            g_Suspended = true;
+            SuspendsMetric().add();
+            XPLOG_DEBUG("ImGui frames suspended");
+        }
+
+        static void ResumeFrames()
+        {
+            if (!g_Suspended)
+            {
+                return;
+            }
+            g_Suspended = false;
+            SetFramesRunning(true);
+            XPLOG_DEBUG("ImGui frames resumed");
+        }
+
+        // Memory trimming, see TrimMemory()
+        static TrimPolicy g_TrimPolicy;
+        static bool g_Trimmed = false;        // Nothing rebuilt yet since the last trim
+        static float g_SuspendedSeconds = 0.0f;
+        static bool g_SuspendCheckScheduled = false; // SuspendFlightLoopCallback runs at the next flight loop
+
+        // Scheduled by an idle frame; the windows are not hidden from inside their own draw callback.
+        // Runs every flight loop while suspended, before the frame is drawn, so a callback made
+        // visible (from a menu item, for example) is drawn in the same sim frame.
+        static float SuspendFlightLoopCallback(float elapsedSinceLastCall, float elapsedSinceLastFlightLoop, int counter, void *refcon)
+        {
+            const bool idle = !AnyCallbackVisible() || SimSuspendsFrames();
+            if (!g_Suspended && idle)
+            {
+                SuspendFrames();
+                g_SuspendedSeconds = 0.0f;
+            }
+            else if (g_Suspended && !idle)
+            {
+                ResumeFrames();
+            }
+            else if (g_Suspended && !g_Trimmed && g_TrimPolicy.idleSeconds > 0.0f && !AnyCallbackVisible())
+            {
+                g_SuspendedSeconds += elapsedSinceLastCall;
+                if (g_SuspendedSeconds >= g_TrimPolicy.idleSeconds)
+                {
+                    TrimMemory();
+                }
+            }
+            // Keeps running every flight loop while suspended
+            g_SuspendCheckScheduled = g_Suspended;
+            return g_Suspended ? -1.0f : 0.0f;
+        }
+
+        // Runs SuspendFlightLoopCallback at the next flight loop, unless it is already due
+        static void ScheduleSuspendCheck()
+        {
+            if (!g_SuspendCheckScheduled)
+            {
+                Xplm::SetFlightLoopCallbackInterval(SuspendFlightLoopCallback, -1.0f, 1);
+                g_SuspendCheckScheduled = true;
+            }
         }
 
         // Prepare ImGui for a new frame in the X-Plane environment
@@ -509,9 +987,27 @@ namespace ImGui
         {
             // Adapt ImGui to the current display size and DPI settings of X-Plane
             // This might involve querying X-Plane for the current window size and passing it to ImGui
+            if (Xplm::BeginFrame())
+            {
+                FitWindowToScreen();
+            }
+
+            // Native windows get no cursor events once the mouse is off all of them, so look for ourselves
+            ImGuiIO &io = ImGui::GetIO();
+            if (g_WindowMode == WindowMode::NativeWindows && g_MouseOverImGui && !io.MouseDown[0] && !io.MouseDown[1])
+            {
+                int x, y;
+                Xplm::GetMouseLocationGlobal(&x, &y);
+                if (!HitTest(ToImGuiPos(x, y)))
+                {
+                    io.MousePos = ImVec2(-FLT_MAX, -FLT_MAX);
+                    g_MouseOverImGui = false;
+                }
+            }
+
             int windowWidth, windowHeight;
-            XPLMGetScreenSize(&windowWidth, &windowHeight);
-            ImGui::GetIO().DisplaySize = ImVec2((float)windowWidth, (float)windowHeight);
+            Xplm::GetScreenSize(&windowWidth, &windowHeight);
+            io.DisplaySize = ImVec2((float)windowWidth, (float)windowHeight);
 
             // Start a new ImGui frame after adapting to X-Plane's environment
             // ImGui::NewFrame();
@@ -520,16 +1016,58 @@ namespace ImGui
         // Initializes a new ImGui frame. Call this at the beginning of your drawing callback.
         void BeginFrame()
         {
+            XP_PROFILE_SCOPE("ImGui::XP::BeginFrame");
+            BeginFrameAllocator();
+            // Recreates the device objects and the atlas after a trim
+            if (g_Trimmed)
+            {
+                PackAtlasImages();
+            }
             ImGui_ImplOpenGL3_NewFrame();
+            g_Trimmed = false;
+            UpdateTextures();
             NewFrame(); // Adapt as necessary.
+            UpdateIniPersistence();
             ImGui::NewFrame();
         }
 
         // Finalizes the ImGui frame and renders it to the screen. Call this at the end of your drawing callback.
         void EndFrame()
         {
+            XP_PROFILE_SCOPE("ImGui::XP::EndFrame");
             ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            ImDrawData *drawData = ImGui::GetDrawData();
+            g_LastFrameStats.vertices = drawData->TotalVtxCount;
+            g_LastFrameStats.indices = drawData->TotalIdxCount;
+            g_LastFrameStats.drawLists = drawData->CmdListsCount;
+            g_LastFrameStats.drawCalls = 0;
+            g_LastFrameStats.textureSwitches = 0;
+            ImTextureID boundTexture = ImTextureID();
+            for (int i = 0; i < drawData->CmdListsCount; i++)
+            {
+                const ImDrawList *drawList = drawData->CmdLists[i];
+                g_LastFrameStats.drawCalls += drawList->CmdBuffer.Size;
+                for (const ImDrawCmd &cmd : drawList->CmdBuffer)
+                {
+                    if (!cmd.UserCallback && cmd.GetTexID() != boundTexture)
+                    {
+                        boundTexture = cmd.GetTexID();
+                        ++g_LastFrameStats.textureSwitches;
+                    }
+                }
+            }
+            if (g_WindowMode == WindowMode::FullScreenOverlay)
+            {
+                ImGui_ImplOpenGL3_RenderDrawData(drawData);
+            }
+            else
+            {
+                // Each native window draws its part in its own draw callback
+                SyncNativeWindows(drawData);
+            }
+
+            // Where this frame's windows are, for routing mouse events until the next frame
+            RebuildHitTestIndex();
 
             // If using ImGui's docking features, this is necessary
             // if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
@@ -543,26 +1081,106 @@ namespace ImGui
             ImGui::EndFrame();
         }
 
+        // Throttled sim frames show the last ImGui frame again. False if there is none.
+        static bool RedrawLastFrame()
+        {
+            ImDrawData *drawData = ImGui::GetDrawData();
+            if (!drawData)
+            {
+                return false;
+            }
+            XP_PROFILE_SCOPE("RedrawLastFrame");
+            if (g_WindowMode == WindowMode::FullScreenOverlay)
+            {
+                ImGui_ImplOpenGL3_RenderDrawData(drawData);
+            }
+            else if (g_UnownedDrawData.CmdListsCount > 0)
+            {
+                // The native windows redraw their own share
+                ImGui_ImplOpenGL3_RenderDrawData(&g_UnownedDrawData);
+            }
+            return true;
+        }
+
         // Renders ImGui frame within OpenGL context
         // Called by DrawWindowCallback so rendering respects window z-order
         static void RenderImGuiFrame()
         {
+            // Nothing is drawn while the sim loads
+            if (SimSuspendsFrames())
+            {
+                ScheduleSuspendCheck();
+                return;
+            }
+            // A trim dropped the buffers the last frame's draw data points into
+            if (!g_Trimmed && !ShouldBuildFrame() && RedrawLastFrame())
+            {
+                return;
+            }
+
+            XP_PROFILE_SCOPE("RenderImGuiFrame");
+            static XPlaneMetrics::Histogram &frameTime = XPlaneMetrics::histogram("imgui.frame_time", "ns", "CPU time of one overlay frame, render callbacks included");
+            static XPlaneMetrics::Histogram &frameInterval = XPlaneMetrics::histogram("imgui.frame_interval", "ns", "Time between the starts of consecutive overlay frames");
+            static XPlaneMetrics::Histogram &beginFramePhase = XPlaneMetrics::histogram("imgui.phase.begin_frame", "ns", "CPU time of BeginFrame");
+            static XPlaneMetrics::Histogram &callbacksPhase = XPlaneMetrics::histogram("imgui.phase.callbacks", "ns", "CPU time of all render callbacks");
+            static XPlaneMetrics::Histogram &endFramePhase = XPlaneMetrics::histogram("imgui.phase.end_frame", "ns", "CPU time of EndFrame, OpenGL rendering included");
+            static XPlaneMetrics::Histogram &inputLatency = XPlaneMetrics::histogram("imgui.input_latency", "ns", "Time from an input event to the end of the frame that drew it");
+            static std::chrono::steady_clock::time_point lastFrameStart;
+
+            auto frameStart = std::chrono::steady_clock::now();
+            if (lastFrameStart.time_since_epoch().count() != 0)
+            {
+                frameInterval.record(NanosecondsBetween(lastFrameStart, frameStart));
+            }
+            lastFrameStart = frameStart;
             BeginFrame();
 
+            auto callbacksStart = std::chrono::steady_clock::now();
+            g_LastCallbackTimings.clear();
             for (auto &callbackEntry : g_ImGuiRenderCallbacks)
             {
                 // Check if the visibility flag is true before executing the callback
                 if (callbackEntry.getVisibilityFlag())
                 {
+                    XP_PROFILE_SCOPE_ARG(callbackEntry.getName(), callbackEntry.getId());
+                    auto callbackStart = std::chrono::steady_clock::now();
                     callbackEntry.getCallback()();
+                    uint64_t callbackNs = NanosecondsBetween(callbackStart, std::chrono::steady_clock::now());
+                    CallbackTimeMetric(callbackEntry).record(callbackNs);
+                    g_LastCallbackTimings.push_back({callbackEntry.getName(), callbackEntry.getId(), callbackNs});
                 }
             }
 
+            auto endFrameStart = std::chrono::steady_clock::now();
             EndFrame();
+            auto frameEnd = std::chrono::steady_clock::now();
+
+            g_LastFrameStats.frameNs = NanosecondsBetween(frameStart, frameEnd);
+            g_LastFrameStats.beginFrameNs = NanosecondsBetween(frameStart, callbacksStart);
+            g_LastFrameStats.callbacksNs = NanosecondsBetween(callbacksStart, endFrameStart);
+            g_LastFrameStats.endFrameNs = NanosecondsBetween(endFrameStart, frameEnd);
+            frameTime.record(g_LastFrameStats.frameNs);
+            beginFramePhase.record(g_LastFrameStats.beginFrameNs);
+            callbacksPhase.record(g_LastFrameStats.callbacksNs);
+            endFramePhase.record(g_LastFrameStats.endFrameNs);
+
+            // Input that arrived since the last frame has now been drawn
+            if (g_PendingInputTime.time_since_epoch().count() != 0)
+            {
+                inputLatency.record(NanosecondsBetween(g_PendingInputTime, frameEnd));
+                g_PendingInputTime = std::chrono::steady_clock::time_point();
+            }
+
+            // Nothing to draw until a callback becomes visible again
+            if (g_LastCallbackTimings.empty() && !AnyWindowOpen())
+            {
+                ScheduleSuspendCheck();
+                return;
+            }
 
             // After ImGui has processed all events and rendered, check if we should release keyboard focus
             // This handles the case where a popup was dismissed but we still hold XPLM keyboard focus
-            if (XPLMHasKeyboardFocus(xplmWindowID))
+            if (Xplm::GetFocusedWindow())
             {
                 ImGuiIO& io = ImGui::GetIO();
                 
@@ -570,7 +1188,7 @@ namespace ImGui
                 // This catches popup dismissals that happened during event processing
                 if (!io.WantCaptureMouse && !ImGui::IsWindowHovered(ImGuiHoveredFlags_AnyWindow | ImGuiHoveredFlags_AllowWhenBlockedByPopup))
                 {
-                    XPLMTakeKeyboardFocus(nullptr);
+                    Xplm::TakeKeyboardFocus(nullptr);
                     io.ClearInputKeys();
                     io.ClearEventsQueue();
                     ImGui::SetWindowFocus(nullptr);
@@ -614,19 +1232,16 @@ namespace ImGui
             XPlaneLog::init("ImGui::XP");
         }
 
-        // ImGui X-Plane integration initialization
-        void Init()
-        {
-            InitLogger();
-
-            InitializeTransparentImGuiOverlay();
+        // Staged initialization
+        static InitOptions g_InitOptions;
+        static size_t g_InitStagesDone = 0;
+        static std::vector<InitStageTiming> g_InitStageTimings;
+        static float g_InitIdleTime = 0.0f;
 
+        static void InitContextStage()
+        {
             // Determine the plugin's directory
-            // Initialize pluginPath with a size of 512
-            // Ensure that the path is null-terminated and has enough space for the full path
-            pluginPath.resize(512, '\0');
-
-            XPLMGetPluginInfo(XPLMGetMyID(), nullptr, &pluginPath[0], nullptr, nullptr);
+            pluginPath = Xplm::GetPluginPath();
 
             // Construct the path to imgui.ini within the plugin's directory
             std::filesystem::path path(pluginPath.c_str());
@@ -634,23 +1249,25 @@ namespace ImGui
             std::filesystem::path iniPath = path.parent_path() / iniFileName;
 
             // Debug: Print or log the iniPath to verify its correctness
-            XPlaneLog::info(("ImGui ini path: " + iniPath.string()).c_str());
-
-            static std::string iniPath_string = iniPath.string();
+            XPlaneLog::info("ImGui ini path: {}", iniPath.string());
 
             // Initialize ImGui for X-Plane OpenGL rendering
             IMGUI_CHECKVERSION();
+            // Must come before the context exists so every ImGui allocation goes through the pool
+            InstallAllocator();
             g_ImGuiContext = ImGui::CreateContext();
             ImGui::SetCurrentContext(g_ImGuiContext);  // Critical: Set the context as current!
             
-            // Set ImGui ini file path BEFORE any other ImGui operations
+            // No ini file name: ImGui would read and write it on the render thread.
+            // imgui_impl_xplane_ini reads it now in the background and writes changes the same way.
             ImGuiIO &io = ImGui::GetIO();
-            io.IniFilename = iniPath_string.c_str();
+            io.IniFilename = nullptr;
+            StartIniPersistence(iniPath.string());
             
             // Enable keyboard navigation (required for Tab, arrow keys to work)
             io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
-            
-            ImGui_ImplOpenGL3_Init("#version 330");
+
+            g_MetricsCollector = XPlaneMetrics::addCollector(CollectAllocatorMetrics);
 
             // Additional ImGui setup can be done here
 
@@ -660,8 +1277,107 @@ namespace ImGui
             // ImGui::StyleColorsLight();
 
             // SetupKeyMap(); // Needed to map X-Plane key codes to ImGui key codes
+        }
 
-            XPlaneLog::info("ImGui initialized for X-Plane.");
+        static void InitBackendStage()
+        {
+            ImGui_ImplOpenGL3_Init("#version 330");
+            InitTextures(std::filesystem::path(pluginPath.c_str()).parent_path().string());
+        }
+
+        static void InitFontsStage()
+        {
+            if (g_InitOptions.loadFonts)
+            {
+                g_InitOptions.loadFonts();
+            }
+        }
+
+        static void InitWindowsStage()
+        {
+            CreateModeWindows();
+            Xplm::RegisterFlightLoopCallback(SuspendFlightLoopCallback, 0.0f);
+        }
+
+        struct InitStage
+        {
+            const char *name;
+            void (*run)();
+        };
+
+        static const InitStage kInitStages[] = {
+            {"context", InitContextStage},
+            {"backend", InitBackendStage},
+            {"fonts", InitFontsStage},
+            {"windows", InitWindowsStage},
+        };
+        constexpr size_t kInitStageCount = sizeof(kInitStages) / sizeof(kInitStages[0]);
+
+        // Runs the next stage, timed; published as gauge "imgui.init.<stage>" in ns
+        static void RunInitStage()
+        {
+            const InitStage &stage = kInitStages[g_InitStagesDone++];
+            XP_PROFILE_SCOPE(stage.name);
+            auto start = std::chrono::steady_clock::now();
+            stage.run();
+            uint64_t ns = NanosecondsBetween(start, std::chrono::steady_clock::now());
+
+            g_InitStageTimings.push_back({stage.name, ns});
+            XPlaneMetrics::gauge(std::string("imgui.init.") + stage.name, "CPU time of the ImGui init stage, ns").set(static_cast<double>(ns));
+            XPlaneLog::info("ImGui init stage '{}' took {:.2f} ms", stage.name, static_cast<double>(ns) / 1.0e6);
+            if (g_InitStagesDone == kInitStageCount)
+            {
+                XPlaneLog::info("ImGui initialized for X-Plane.");
+            }
+        }
+
+        static float InitFlightLoopCallback(float elapsedSinceLastCall, float elapsedSinceLastFlightLoop, int counter, void *refcon)
+        {
+            if (AnyCallbackVisible())
+            {
+                // First use: finish now, before this sim frame is drawn
+                while (g_InitStagesDone < kInitStageCount)
+                {
+                    RunInitStage();
+                }
+            }
+            else
+            {
+                // Idle after load: spread the stages over frames
+                g_InitIdleTime += elapsedSinceLastCall;
+                if (g_InitIdleTime >= g_InitOptions.idleDelay)
+                {
+                    RunInitStage();
+                }
+            }
+            return g_InitStagesDone < kInitStageCount ? -1.0f : 0.0f;
+        }
+
+        // ImGui X-Plane integration initialization
+        void Init(const InitOptions &options)
+        {
+            InitLogger();
+
+            g_InitOptions = options;
+            if (options.mode == InitMode::Staged)
+            {
+                Xplm::RegisterFlightLoopCallback(InitFlightLoopCallback, -1.0f);
+                return;
+            }
+            while (g_InitStagesDone < kInitStageCount)
+            {
+                RunInitStage();
+            }
+        }
+
+        bool IsInitialized()
+        {
+            return g_InitStagesDone == kInitStageCount;
+        }
+
+        const std::vector<InitStageTiming> &GetInitStageTimings()
+        {
+            return g_InitStageTimings;
         }
 
         void AddGlyphToDefaultFont(const void *font_data, int font_size, float font_pixel_size, const ImWchar *glyphs_ranges, float glyphMinAdvanceXFactor)
@@ -679,7 +1395,7 @@ namespace ImGui
 
         ImFont *LoadFontProfile(const std::string &name, const std::string &fontPath, float size)
         {
-            XPlaneLog::info(("Loading: " + fontPath).c_str());
+            XPlaneLog::info("Loading: {}", fontPath);
 
             fontProfiles.push_back({name, fontPath, size});
 
@@ -706,16 +1422,18 @@ namespace ImGui
             }
             else
             {
-                XPlaneLog::error(("Failed to load font: " + fontPath).c_str());
+                XPlaneLog::error("Failed to load font: {}", fontPath);
                 return nullptr;
             }
         }
 
         void BuildFontAtlas()
         {
+            XP_PROFILE_SCOPE("ImGui::XP::BuildFontAtlas");
             // After adding fonts, we must rebuild the font atlas and recreate device objects
             // so the OpenGL3 backend uploads the new combined font texture
             ImGui::GetIO().Fonts->Build();
+            PackAtlasImages();
 
             // Destroy old GPU objects (font texture) and recreate with new atlas
             ::ImGui_ImplOpenGL3_DestroyDeviceObjects();
@@ -734,6 +1452,103 @@ namespace ImGui
             return nullptr; // or handle the case where the font is not found
         }
 
+        void SetWindowMode(WindowMode mode)
+        {
+            if (mode == g_WindowMode)
+            {
+                return;
+            }
+
+            // Before Init() only the setting changes
+            const bool initialized = IsInitialized();
+            if (initialized)
+            {
+                // The new mode starts running; the next idle frame suspends it again
+                ResumeFrames();
+                DestroyModeWindows();
+            }
+            g_WindowMode = mode;
+            if (initialized)
+            {
+                CreateModeWindows();
+                XPlaneLog::info("ImGui window mode: {}", mode == WindowMode::NativeWindows ? "native windows" : "full-screen overlay");
+            }
+        }
+
+        WindowMode GetWindowMode()
+        {
+            return g_WindowMode;
+        }
+
+        void SetTrimPolicy(const TrimPolicy &policy)
+        {
+            g_TrimPolicy = policy;
+        }
+
+        void TrimMemory()
+        {
+            if (!IsInitialized() || g_Trimmed)
+            {
+                return;
+            }
+            XP_PROFILE_SCOPE("TrimMemory");
+            static XPlaneMetrics::Counter &trims = XPlaneMetrics::counter("imgui.trims", "Times the ImGui memory was trimmed");
+            const size_t residentBefore = GetResidentMemoryBytes();
+
+            // Font texture, shaders and buffers; ImGui_ImplOpenGL3_NewFrame() creates them again
+            ImGui_ImplOpenGL3_DestroyDeviceObjects();
+            // Image textures; they load again when next drawn
+            TrimTextures();
+            // Rasterized again from the kept font data when the texture is recreated
+            ImGui::GetIO().Fonts->ClearTexData();
+
+            // What ImGui itself frees from windows unused for io.ConfigMemoryCompactTimer; that
+            // timer does not run while frames are suspended. Begin() restores the buffers.
+            ImGuiContext &g = *GImGui;
+            for (ImGuiWindow *window : g.Windows)
+            {
+                if (!window->MemoryCompacted)
+                {
+                    ImGui::GcCompactTransientWindowBuffers(window);
+                }
+            }
+            ImGui::GcCompactTransientMiscBuffers();
+
+            // Our own per-frame scratch
+            for (auto &entry : g_NativeWindows)
+            {
+                entry.second.drawData.CmdLists.clear();
+                entry.second.drawData.CmdListsCount = 0;
+            }
+            g_UnownedDrawData.CmdLists.clear();
+            g_UnownedDrawData.CmdListsCount = 0;
+            std::vector<std::pair<ImDrawList *, NativeWindow *>>().swap(g_DrawListOwners);
+            std::vector<CallbackTiming>().swap(g_LastCallbackTimings);
+            TrimAllocator();
+            // Profiler rings; each thread allocates its ring again at its next zone
+            XPlaneProfiler::trim();
+            // The log viewer's line store; allocated again when its window is next drawn
+            if (XPlaneLogViewer *viewer = XPlaneLog::getViewer())
+            {
+                viewer->trim();
+            }
+
+            g_Trimmed = true;
+            trims.add();
+            const size_t residentAfter = GetResidentMemoryBytes();
+            XPlaneLog::info("ImGui memory trimmed, process resident {:.1f} MiB -> {:.1f} MiB", static_cast<double>(residentBefore) / (1024.0 * 1024.0), static_cast<double>(residentAfter) / (1024.0 * 1024.0));
+        }
+
+        FrameStats GetLastFrameStats()
+        {
+            return g_LastFrameStats;
+        }
+
+        const std::vector<CallbackTiming> &GetLastCallbackTimings()
+        {
+            return g_LastCallbackTimings;
+        }
+
         void RegisterImGuiRenderCallback(ImGuiRenderCallbackWrapper callback)
         {
             g_ImGuiRenderCallbacks.push_back(callback);
@@ -757,9 +1572,9 @@ namespace ImGui
 
         void ReleaseKeyboardFocus()
         {
-            if (xplmWindowID && XPLMHasKeyboardFocus(xplmWindowID))
+            if (Xplm::GetFocusedWindow())
             {
-                XPLMTakeKeyboardFocus(nullptr);
+                Xplm::TakeKeyboardFocus(nullptr);
                 
                 // Clear ImGui input state
                 ImGuiIO& io = ImGui::GetIO();
@@ -770,15 +1585,38 @@ namespace ImGui
         }
 
         // ImGui X-Plane integration shutdown
+        // Undoes the init stages that have run, in reverse
         void Shutdown()
         {
+            Xplm::UnregisterFlightLoopCallback(InitFlightLoopCallback);
+
+            if (g_InitStagesDone == kInitStageCount)
+            {
+                Xplm::UnregisterFlightLoopCallback(SuspendFlightLoopCallback);
+                g_SuspendCheckScheduled = false;
+                ResumeFrames();
+                DestroyModeWindows();
+            }
+
             // Shutdown the ImGui OpenGL3 backend
-            ImGui_ImplOpenGL3_Shutdown();
+            if (g_InitStagesDone > 1) // "backend" has run
+            {
+                ShutdownTextures();
+                ImGui_ImplOpenGL3_Shutdown();
+            }
 
-            XPlaneLog::info("ImGui shutdown for X-Plane.");
+            if (g_InitStagesDone > 0) // "context" has run
+            {
+                XPlaneMetrics::removeCollector(g_MetricsCollector);
+                StopIniPersistence();
 
-            // Destroy the ImGui context
-            ImGui::DestroyContext();
+                // Destroy the ImGui context
+                ImGui::DestroyContext();
+                g_ImGuiContext = nullptr;
+            }
+            g_InitStagesDone = 0;
+
+            XPlaneLog::info("ImGui shutdown for X-Plane.");
         }
 
     }
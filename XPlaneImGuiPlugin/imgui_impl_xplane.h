@@ -8,7 +8,14 @@
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include "imgui.h"
 
+// ImGui memory (pool allocator, frame arena)
+#include "imgui_impl_xplane_memory.h"
+
+// Bulk marker drawing for render callbacks
+#include "imgui_impl_xplane_markers.h"
+
 // Standard Library
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <string>
@@ -43,8 +50,9 @@ namespace ImGui
         class ImGuiRenderCallbackWrapper
         {
         public:
-            ImGuiRenderCallbackWrapper(std::function<void()> callback, bool *callbackEnabledFlag = nullptr)
-                : m_callback(callback), m_callbackEnabledFlag(callbackEnabledFlag), m_id(s_nextId++) {}
+            // name labels the callback's zone in profiler traces and must outlive the callback
+            ImGuiRenderCallbackWrapper(std::function<void()> callback, bool *callbackEnabledFlag = nullptr, const char *name = "ImGui render callback")
+                : m_callback(callback), m_callbackEnabledFlag(callbackEnabledFlag), m_name(name), m_id(s_nextId++) {}
 
             void operator()() const
             {
@@ -56,10 +64,13 @@ namespace ImGui
             // Getter methods
             bool getVisibilityFlag() const { return m_callbackEnabledFlag ? *m_callbackEnabledFlag : true; }
             std::function<void()> getCallback() const { return m_callback; }
+            const char *getName() const { return m_name; }
+            int getId() const { return m_id; }
 
         private:
             std::function<void()> m_callback;
             bool *m_callbackEnabledFlag;
+            const char *m_name;
             int m_id;
             static int s_nextId;
         };
@@ -67,9 +78,36 @@ namespace ImGui
         typedef ImGuiRenderCallbackWrapper ImGuiRenderCallback;
 
         // Initialization and Shutdown
-        void Init();        // Initialize ImGui for X-Plane. Add to XPluginStart.
+        // Init runs in stages: the ImGui context, the OpenGL3 backend, the fonts, and the XPLM windows.
+        // Immediate runs them all before Init returns. Staged only schedules a flight loop. It runs one
+        // stage per sim frame once the sim has been running for idleDelay seconds, or all remaining
+        // stages at once as soon as a render callback becomes visible. In Staged mode, fonts must be
+        // loaded from loadFonts, because the context does not exist when Init returns.
+        enum class InitMode
+        {
+            Immediate,
+            Staged
+        };
+
+        struct InitOptions
+        {
+            InitMode mode = InitMode::Immediate;
+            std::function<void()> loadFonts; // Font stage: AddGlyphToDefaultFont, LoadFontProfile, BuildFontAtlas
+            float idleDelay = 5.0f;          // Staged: seconds of flight loops before the first stage
+        };
+
+        // CPU time of one init stage
+        struct InitStageTiming
+        {
+            const char *name;
+            uint64_t ns;
+        };
+
+        void Init(const InitOptions &options = InitOptions()); // Initialize ImGui for X-Plane. Add to XPluginStart.
         // void SetupKeyMap(); // Setup key map for ImGui. Used in Init.
         void Shutdown();    // Shutdown ImGui for X-Plane. Add to XPluginStop.
+        bool IsInitialized(); // All init stages have run
+        const std::vector<InitStageTiming> &GetInitStageTimings(); // Stages run so far, in order
 
         // Font Handling
         struct LoadedFonts
@@ -93,6 +131,71 @@ namespace ImGui
         void BeginFrame(); // Begins a new ImGui frame. Used at the beginning of drawing callback.
         void EndFrame();   // Ends the current ImGui frame and renders it. Used at the end of drawing callback.
 
+        // Window Mode
+        // FullScreenOverlay: one transparent XPLM window covers the screen and ImGui draws into it.
+        // NativeWindows: every top-level ImGui window, popup and tooltip gets an XPLM window of its
+        // own size, created, moved and destroyed with it each frame, and draws only its own share of
+        // the draw data. X-Plane then only sends us mouse events over ImGui content and only those
+        // areas are composited.
+        enum class WindowMode
+        {
+            FullScreenOverlay,
+            NativeWindows
+        };
+
+        // Can be called before Init() or at runtime, but not from inside a draw callback
+        void SetWindowMode(WindowMode mode);
+        WindowMode GetWindowMode();
+
+        // Memory Trimming
+        // TrimMemory() releases what an idle UI does not need:
+        //   - the OpenGL3 backend's device objects (font texture, shaders, buffers);
+        //   - the atlas pixels on the CPU side;
+        //   - image textures (user images load again when next drawn);
+        //   - draw lists and other transient ImGui buffers;
+        //   - the frame arena, and the allocator's pool slabs once every block in them is free;
+        //   - the profiler's per-thread rings;
+        //   - the log viewer's line store.
+        // Each comes back when next used: the next frame rebuilds what it draws with, profiled threads
+        // allocate a new ring, and the viewer store returns when its window opens. It runs by itself
+        // once frames have been suspended for TrimPolicy::idleSeconds. Call it directly too, e.g. from
+        // XPluginDisable, but not from inside a render callback. The process resident set size before
+        // and after is logged.
+        struct TrimPolicy
+        {
+            float idleSeconds = 30.0f; // 0 or less: no idle trimming
+        };
+
+        void SetTrimPolicy(const TrimPolicy &policy);
+        void TrimMemory();
+
+        // Frame Statistics
+        // Timing and draw counts of the last completed overlay frame
+        struct FrameStats
+        {
+            uint64_t frameNs = 0;      // CPU time of the whole overlay frame
+            uint64_t beginFrameNs = 0; // BeginFrame
+            uint64_t callbacksNs = 0;  // All render callbacks
+            uint64_t endFrameNs = 0;   // EndFrame, OpenGL rendering included
+            int vertices = 0;
+            int indices = 0;
+            int drawLists = 0;
+            int drawCalls = 0;
+            int textureSwitches = 0; // Draw commands using a different texture than the one before
+        };
+
+        // CPU time of one render callback in the last frame
+        struct CallbackTiming
+        {
+            const char *name;
+            int id;
+            uint64_t ns;
+        };
+
+        FrameStats GetLastFrameStats();
+        // Callbacks that ran in the last frame, in registration order
+        const std::vector<CallbackTiming> &GetLastCallbackTimings();
+
         // Registering and Unregistering ImGui Render Callbacks
         void RegisterImGuiRenderCallback(ImGuiRenderCallbackWrapper callback);
         void UnregisterImGuiRenderCallback(ImGuiRenderCallback callback);
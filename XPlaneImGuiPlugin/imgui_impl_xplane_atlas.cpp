@@ -0,0 +1,160 @@
+#include "imgui_impl_xplane_atlas.h"
+
+// Standard library headers
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+// Project-specific headers
+#include "imgui_impl_xplane_texture.h"
+#include "imgui_impl_xplane_xplm.h"
+#include "XPlaneLog.h"
+#include "XPlaneProfiler.h"
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            struct AtlasImageEntry
+            {
+                int width = 0;
+                int height = 0;
+                std::vector<unsigned char> pixels; // Kept to copy in again after a rebuild
+                int rectIndex = -1;
+            };
+
+            std::vector<AtlasImageEntry> g_AtlasImages;
+
+            std::string PluginFolder()
+            {
+                return std::filesystem::path(Xplm::GetPluginPath()).parent_path().string();
+            }
+
+            const ImFontAtlasCustomRect *PackedRect(int handle)
+            {
+                if (handle < 0 || handle >= static_cast<int>(g_AtlasImages.size()))
+                {
+                    return nullptr;
+                }
+                ImFontAtlas *atlas = ImGui::GetIO().Fonts;
+                const ImFontAtlasCustomRect *rect = atlas->GetCustomRectByIndex(g_AtlasImages[handle].rectIndex);
+                return rect && rect->IsPacked() && atlas->TexWidth > 0 ? rect : nullptr;
+            }
+        } // namespace
+
+        int AddAtlasImage(int width, int height, const unsigned char *rgba)
+        {
+            if (width <= 0 || height <= 0 || !rgba)
+            {
+                return -1;
+            }
+            AtlasImageEntry entry;
+            entry.width = width;
+            entry.height = height;
+            entry.pixels.assign(rgba, rgba + static_cast<size_t>(width) * height * 4);
+            entry.rectIndex = ImGui::GetIO().Fonts->AddCustomRectRegular(width, height);
+            g_AtlasImages.push_back(std::move(entry));
+            return static_cast<int>(g_AtlasImages.size()) - 1;
+        }
+
+        int AddAtlasImageFromFile(const std::string &path)
+        {
+            std::filesystem::path file(path);
+            if (file.is_relative())
+            {
+                file = std::filesystem::path(PluginFolder()) / file;
+            }
+
+            std::ifstream in(file, std::ios::binary);
+            if (!in)
+            {
+                XPlaneLog::error("Atlas image {}: cannot read the file", file.string());
+                return -1;
+            }
+            const std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            DecodedImage image;
+            std::string error;
+            if (!DecodeImage(bytes.data(), bytes.size(), image, &error))
+            {
+                XPlaneLog::error("Atlas image {}: {}", file.string(), error);
+                return -1;
+            }
+            return AddAtlasImage(image.width, image.height, image.pixels.data());
+        }
+
+        bool GetAtlasImage(int handle, AtlasImage *out)
+        {
+            const ImFontAtlasCustomRect *rect = PackedRect(handle);
+            if (!rect)
+            {
+                return false;
+            }
+            const ImFontAtlas *atlas = ImGui::GetIO().Fonts;
+            out->texture = atlas->TexID;
+            out->size = ImVec2(static_cast<float>(rect->Width), static_cast<float>(rect->Height));
+            atlas->CalcCustomRectUV(rect, &out->uv0, &out->uv1);
+            return true;
+        }
+
+        void AtlasImageWidget(int handle, const ImVec2 &size, const ImVec4 &tint)
+        {
+            AtlasImage image;
+            if (!GetAtlasImage(handle, &image))
+            {
+                ImGui::Dummy(size);
+                return;
+            }
+            ImGui::Image(image.texture, (size.x > 0.0f && size.y > 0.0f) ? size : image.size, image.uv0, image.uv1, tint);
+        }
+
+        void AddAtlasImageToDrawList(ImDrawList *drawList, int handle, const ImVec2 &min, const ImVec2 &max, ImU32 color)
+        {
+            AtlasImage image;
+            if (GetAtlasImage(handle, &image))
+            {
+                drawList->AddImage(image.texture, min, max, image.uv0, image.uv1, color);
+            }
+        }
+
+        void PackAtlasImages()
+        {
+            if (g_AtlasImages.empty())
+            {
+                return;
+            }
+            XP_PROFILE_SCOPE("PackAtlasImages");
+            // Builds the atlas if its pixels were cleared, and converts it to RGBA. The OpenGL3
+            // backend uploads this same buffer, so the copies below end up in the font texture.
+            ImFontAtlas *atlas = ImGui::GetIO().Fonts;
+            unsigned char *pixels = nullptr;
+            int atlasWidth = 0, atlasHeight = 0;
+            atlas->GetTexDataAsRGBA32(&pixels, &atlasWidth, &atlasHeight);
+            if (!pixels)
+            {
+                return;
+            }
+
+            int packed = 0;
+            for (const AtlasImageEntry &entry : g_AtlasImages)
+            {
+                const ImFontAtlasCustomRect *rect = atlas->GetCustomRectByIndex(entry.rectIndex);
+                if (!rect || !rect->IsPacked())
+                {
+                    continue;
+                }
+                for (int y = 0; y < entry.height; ++y)
+                {
+                    std::memcpy(pixels + (static_cast<size_t>(rect->Y + y) * atlasWidth + rect->X) * 4, &entry.pixels[static_cast<size_t>(y) * entry.width * 4], static_cast<size_t>(entry.width) * 4);
+                }
+                ++packed;
+            }
+            XPlaneLog::info("Packed {} of {} images into the {}x{} font atlas", packed, g_AtlasImages.size(), atlasWidth, atlasHeight);
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
@@ -0,0 +1,62 @@
+#ifndef IMGUI_IMPL_XPLANE_ATLAS_H
+#define IMGUI_IMPL_XPLANE_ATLAS_H
+
+// ImGui
+#include "imgui.h"
+
+// Standard Library
+#include <string>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // Atlas Images
+        // Small RGBA images (aircraft icons, status lights, map symbols) packed into the font atlas
+        // as custom rects. They draw with the font texture, so a panel mixing text and hundreds of
+        // icons stays one ImDrawCmd per clip rect instead of one per texture change. Each texture
+        // change in the draw data costs a bind, counted in FrameStats::textureSwitches.
+        //
+        // Add images before BuildFontAtlas(), e.g. from InitOptions::loadFonts. Their pixels are
+        // copied into the atlas whenever it is built, including the rebuild after TrimMemory(). Keep
+        // them small: every image grows the atlas, which is one texture resident at all times.
+        // Larger or per-flight images belong in GetTexture() (imgui_impl_xplane_texture.h).
+        //
+        //     static int g_Beacon = ImGui::XP::AddAtlasImageFromFile("icons/beacon.dds");
+        //     ImGui::XP::AtlasImageWidget(g_Beacon, ImVec2(16, 16));
+
+        // Where an image is in the atlas; uv0 and uv1 are only valid once the atlas is built
+        struct AtlasImage
+        {
+            ImTextureID texture = ImTextureID(); // The font texture
+            ImVec2 size = ImVec2(0.0f, 0.0f);    // Pixels
+            ImVec2 uv0 = ImVec2(0.0f, 0.0f);
+            ImVec2 uv1 = ImVec2(0.0f, 0.0f);
+        };
+
+        // Copies width * height tightly packed RGBA8 pixels, top row first. Returns a handle, or -1.
+        int AddAtlasImage(int width, int height, const unsigned char *rgba);
+
+        // Decodes the file with DecodeImage() (imgui_impl_xplane_texture.h); relative paths are
+        // relative to the plugin folder. Returns a handle, or -1 with the reason logged.
+        int AddAtlasImageFromFile(const std::string &path);
+
+        // False if the handle is unknown or the atlas is not built yet
+        bool GetAtlasImage(int handle, AtlasImage *out);
+
+        // ImGui::Image for an atlas image; size defaults to the image's own
+        void AtlasImageWidget(int handle, const ImVec2 &size = ImVec2(0.0f, 0.0f), const ImVec4 &tint = ImVec4(1, 1, 1, 1));
+
+        // Adds a quad to drawList; with the font texture current, as in any window, it batches
+        // with the text around it
+        void AddAtlasImageToDrawList(ImDrawList *drawList, int handle, const ImVec2 &min, const ImVec2 &max, ImU32 color = IM_COL32_WHITE);
+
+        // Used by imgui_impl_xplane.cpp: builds the atlas if needed and copies the images in.
+        // Call before the OpenGL3 backend creates the font texture.
+        void PackAtlasImages();
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_ATLAS_H
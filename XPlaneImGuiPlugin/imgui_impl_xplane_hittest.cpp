@@ -0,0 +1,181 @@
+#include "imgui_impl_xplane_hittest.h"
+
+// ImGui internals, for the window list
+#include "imgui_internal.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            // Side of a grid cell in pixels; a 4K screen is 60 x 34 cells
+            constexpr float kCellSize = 64.0f;
+
+            // ImGui accepts resize drags slightly outside a window's edge
+            constexpr float kHoverPadding = 4.0f;
+
+            std::vector<ImRect> g_Rects;
+
+            // Grid of cells in rows. Cell c lists the rectangles g_CellRects[g_CellBegin[c]] onwards,
+            // g_CellCount[c] of them, unless one rectangle covers it completely (g_CellFull[c]).
+            int g_Columns = 0;
+            int g_Rows = 0;
+            std::vector<uint8_t> g_CellFull;
+            std::vector<uint32_t> g_CellCount;
+            std::vector<uint32_t> g_CellBegin;
+            std::vector<uint16_t> g_CellRects;
+            std::vector<uint32_t> g_CellCursor; // Build scratch
+
+            // A modal or popup is open: every click belongs to ImGui, which closes popups on a click outside them
+            bool g_CaptureAll = false;
+
+            // Cells a rectangle overlaps, clamped to the grid
+            void CellRange(const ImRect &rect, int &x0, int &y0, int &x1, int &y1)
+            {
+                x0 = std::max(0, static_cast<int>(rect.Min.x / kCellSize));
+                y0 = std::max(0, static_cast<int>(rect.Min.y / kCellSize));
+                x1 = std::min(g_Columns - 1, static_cast<int>(rect.Max.x / kCellSize));
+                y1 = std::min(g_Rows - 1, static_cast<int>(rect.Max.y / kCellSize));
+            }
+
+            bool CoversCell(const ImRect &rect, int x, int y)
+            {
+                return rect.Min.x <= x * kCellSize && rect.Min.y <= y * kCellSize && rect.Max.x >= (x + 1) * kCellSize && rect.Max.y >= (y + 1) * kCellSize;
+            }
+
+            bool Contains(const ImRect &rect, const ImVec2 &pos)
+            {
+                return pos.x >= rect.Min.x && pos.y >= rect.Min.y && pos.x < rect.Max.x && pos.y < rect.Max.y;
+            }
+        } // namespace
+
+        void RebuildHitTestIndex()
+        {
+            ImGuiContext &g = *GImGui;
+            const ImVec2 displaySize = ImGui::GetIO().DisplaySize;
+
+            g_Rects.clear();
+            // Combo dropdowns, context menus and menus close when clicked outside, so ImGui must see that click
+            g_CaptureAll = g.OpenPopupStack.Size > 0;
+            for (ImGuiWindow *window : g.Windows)
+            {
+                // Child windows lie inside their parent; popups are flagged as children too
+                const bool child = (window->Flags & ImGuiWindowFlags_ChildWindow) && !(window->Flags & ImGuiWindowFlags_Popup);
+                if (!window->Active || window->Hidden || child || (window->Flags & ImGuiWindowFlags_NoMouseInputs))
+                {
+                    continue;
+                }
+                if (window->Flags & ImGuiWindowFlags_Modal)
+                {
+                    // The modal's dimmed background blocks the whole screen
+                    g_CaptureAll = true;
+                }
+                ImRect rect = window->Rect();
+                rect.Min.x -= kHoverPadding;
+                rect.Min.y -= kHoverPadding;
+                rect.Max.x += kHoverPadding;
+                rect.Max.y += kHoverPadding;
+                if (rect.Max.x > 0.0f && rect.Max.y > 0.0f && rect.Min.x < displaySize.x && rect.Min.y < displaySize.y && g_Rects.size() < UINT16_MAX)
+                {
+                    g_Rects.push_back(rect);
+                }
+            }
+
+            g_Columns = std::max(1, static_cast<int>(displaySize.x / kCellSize) + 1);
+            g_Rows = std::max(1, static_cast<int>(displaySize.y / kCellSize) + 1);
+            const size_t cellCount = static_cast<size_t>(g_Columns) * g_Rows;
+
+            // Pass 1: count the rectangles crossing each cell and mark the fully covered ones
+            g_CellFull.assign(cellCount, 0);
+            g_CellCount.assign(cellCount, 0);
+            for (const ImRect &rect : g_Rects)
+            {
+                int x0, y0, x1, y1;
+                CellRange(rect, x0, y0, x1, y1);
+                for (int y = y0; y <= y1; ++y)
+                {
+                    for (int x = x0; x <= x1; ++x)
+                    {
+                        const size_t cell = static_cast<size_t>(y) * g_Columns + x;
+                        g_CellCount[cell]++;
+                        g_CellFull[cell] |= CoversCell(rect, x, y) ? 1 : 0;
+                    }
+                }
+            }
+
+            // Start offsets; full cells need no list
+            g_CellBegin.resize(cellCount);
+            uint32_t total = 0;
+            for (size_t cell = 0; cell < cellCount; ++cell)
+            {
+                g_CellBegin[cell] = total;
+                if (!g_CellFull[cell])
+                {
+                    total += g_CellCount[cell];
+                }
+            }
+
+            // Pass 2: fill the lists
+            g_CellRects.resize(total);
+            g_CellCursor = g_CellBegin;
+            for (size_t i = 0; i < g_Rects.size(); ++i)
+            {
+                int x0, y0, x1, y1;
+                CellRange(g_Rects[i], x0, y0, x1, y1);
+                for (int y = y0; y <= y1; ++y)
+                {
+                    for (int x = x0; x <= x1; ++x)
+                    {
+                        const size_t cell = static_cast<size_t>(y) * g_Columns + x;
+                        if (!g_CellFull[cell])
+                        {
+                            g_CellRects[g_CellCursor[cell]++] = static_cast<uint16_t>(i);
+                        }
+                    }
+                }
+            }
+        }
+
+        bool HitTest(const ImVec2 &pos)
+        {
+            if (g_CaptureAll)
+            {
+                return true;
+            }
+            if (pos.x < 0.0f || pos.y < 0.0f)
+            {
+                return false;
+            }
+            const int x = static_cast<int>(pos.x / kCellSize);
+            const int y = static_cast<int>(pos.y / kCellSize);
+            if (x >= g_Columns || y >= g_Rows)
+            {
+                return false;
+            }
+
+            const size_t cell = static_cast<size_t>(y) * g_Columns + x;
+            if (g_CellFull[cell])
+            {
+                return true;
+            }
+            const uint32_t begin = g_CellBegin[cell];
+            const uint32_t end = begin + g_CellCount[cell];
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                if (Contains(g_Rects[g_CellRects[i]], pos))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
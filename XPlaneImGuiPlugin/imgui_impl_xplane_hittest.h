@@ -0,0 +1,29 @@
+#ifndef IMGUI_IMPL_XPLANE_HITTEST_H
+#define IMGUI_IMPL_XPLANE_HITTEST_H
+
+// ImGui
+#include "imgui.h"
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // Overlay hit testing
+        // The overlay is one screen-sized XPLM window, so every mouse event in the sim reaches it and
+        // must be claimed or passed on. io.WantCaptureMouse only reflects where the mouse was at the
+        // last NewFrame, which misroutes the first click after the mouse moves onto or off a window.
+        // Instead, EndFrame indexes the rectangles of the frame's ImGui windows, popups and modals in
+        // a uniform grid, and the mouse handlers ask HitTest() about the event's own position.
+
+        // Rebuild the index from the windows drawn in the current frame. Called after ImGui::Render().
+        void RebuildHitTestIndex();
+
+        // True if a point in ImGui display coordinates is over ImGui content (anywhere while a
+        // modal or popup is open, so a click outside a popup reaches ImGui and closes it). O(1): one grid cell lookup plus the few rectangles that cross that cell.
+        bool HitTest(const ImVec2 &pos);
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_HITTEST_H
@@ -0,0 +1,267 @@
+#include "imgui_impl_xplane_hud.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstdint>
+
+// ImGui for X-Plane
+#include "imgui_impl_xplane.h"
+#include "imgui_impl_xplane_throttle.h"
+#include "imgui_impl_xplane_xplm.h"
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            // Frames of sparkline history
+            constexpr int kHistory = 120;
+
+            // Callbacks with their own row; later ones are summed into "Other"
+            constexpr int kMaxCallbackRows = 12;
+
+            // Smoothing of the numbers printed next to the sparklines, so they stay readable
+            constexpr float kSmoothing = 0.1f;
+
+            // Last kHistory samples of one value, written at the shared g_HistoryOffset
+            struct Series
+            {
+                float values[kHistory] = {};
+                float smoothed = 0.0f;
+                float max = 0.0f;
+
+                void push(int offset, float value)
+                {
+                    values[offset] = value;
+                    smoothed += (value - smoothed) * kSmoothing;
+                    // Plot scale: the peak of the history, rescanned once per wrap so it can shrink
+                    max = (offset == kHistory - 1) ? *std::max_element(values, values + kHistory) : std::max(max, value);
+                }
+            };
+
+            struct CallbackRow
+            {
+                int id = -1;
+                const char *name = nullptr;
+                Series ms;
+                bool active = false; // Ran in the last frame
+                int idleFrames = 0;  // The row is freed after a full history without running
+            };
+
+            Series g_SimFrameMs;
+            Series g_OverlayMs;
+            Series g_CallbacksMs;
+            Series g_EndFrameMs;
+            Series g_Vertices;
+            Series g_Indices;
+            Series g_DrawCalls;
+            Series g_TextureSwitches;
+            Series g_Allocations;
+            Series g_XplmCalls;
+            uint64_t g_LastXplmCallCount = 0;
+            int g_LastSampleFrame = -2; // ImGui frame of the last Sample(); a gap means the HUD was closed
+            CallbackRow g_CallbackRows[kMaxCallbackRows];
+            Series g_OtherCallbacksMs;
+            int g_HistoryOffset = 0;
+
+            XPLMDataRef g_FrameRatePeriod = nullptr;
+
+            const char *SimStateName(SimState state)
+            {
+                switch (state)
+                {
+                case SimState::Paused:
+                    return "paused, UI throttled";
+                case SimState::Replay:
+                    return "replay, UI throttled";
+                case SimState::Loading:
+                    return "loading";
+                case SimState::Settling:
+                    return "settling after load, UI throttled";
+                default:
+                    return "running";
+                }
+            }
+
+            float ToMs(uint64_t ns)
+            {
+                return static_cast<float>(ns) / 1.0e6f;
+            }
+
+            CallbackRow *FindCallbackRow(const CallbackTiming &timing)
+            {
+                CallbackRow *freeRow = nullptr;
+                for (CallbackRow &row : g_CallbackRows)
+                {
+                    if (row.id == timing.id)
+                    {
+                        return &row;
+                    }
+                    if (!freeRow && row.id == -1)
+                    {
+                        freeRow = &row;
+                    }
+                }
+                if (freeRow)
+                {
+                    freeRow->id = timing.id;
+                    freeRow->name = timing.name;
+                }
+                return freeRow;
+            }
+
+            void Sample()
+            {
+                if (!g_FrameRatePeriod)
+                {
+                    g_FrameRatePeriod = Xplm::FindDataRef("sim/operation/misc/frame_rate_period");
+                }
+
+                // Counters kept running while the HUD was closed: restart the deltas from here and
+                // skip this frame, so the first sample is not everything since the last one
+                const int frame = ImGui::GetFrameCount();
+                const bool reopened = frame != g_LastSampleFrame + 1;
+                g_LastSampleFrame = frame;
+                if (reopened)
+                {
+                    g_LastXplmCallCount = Xplm::GetCallCount();
+                    return;
+                }
+
+                const FrameStats stats = GetLastFrameStats();
+                const AllocatorStats allocator = GetAllocatorStats();
+                const int offset = g_HistoryOffset;
+
+                g_SimFrameMs.push(offset, g_FrameRatePeriod ? Xplm::GetDataf(g_FrameRatePeriod) * 1000.0f : 0.0f);
+                g_OverlayMs.push(offset, ToMs(stats.frameNs));
+                g_CallbacksMs.push(offset, ToMs(stats.callbacksNs));
+                g_EndFrameMs.push(offset, ToMs(stats.endFrameNs));
+                g_Vertices.push(offset, static_cast<float>(stats.vertices));
+                g_Indices.push(offset, static_cast<float>(stats.indices));
+                g_DrawCalls.push(offset, static_cast<float>(stats.drawCalls));
+                g_TextureSwitches.push(offset, static_cast<float>(stats.textureSwitches));
+                g_Allocations.push(offset, static_cast<float>(allocator.allocations));
+                const uint64_t xplmCalls = Xplm::GetCallCount();
+                g_XplmCalls.push(offset, static_cast<float>(xplmCalls - g_LastXplmCallCount));
+                g_LastXplmCallCount = xplmCalls;
+
+                for (CallbackRow &row : g_CallbackRows)
+                {
+                    row.active = false;
+                }
+                float otherMs = 0.0f;
+                for (const CallbackTiming &timing : GetLastCallbackTimings())
+                {
+                    CallbackRow *row = FindCallbackRow(timing);
+                    if (row)
+                    {
+                        row->ms.push(offset, ToMs(timing.ns));
+                        row->active = true;
+                        row->idleFrames = 0;
+                    }
+                    else
+                    {
+                        otherMs += ToMs(timing.ns);
+                    }
+                }
+                // Hidden callbacks keep their row for a while, with zeros in the history
+                for (CallbackRow &row : g_CallbackRows)
+                {
+                    if (row.id != -1 && !row.active)
+                    {
+                        row.ms.push(offset, 0.0f);
+                        if (++row.idleFrames >= kHistory)
+                        {
+                            row = CallbackRow();
+                        }
+                    }
+                }
+                g_OtherCallbacksMs.push(offset, otherMs);
+
+                g_HistoryOffset = (offset + 1) % kHistory;
+            }
+
+            // Label, smoothed value and sparkline on one line
+            void SparklineRow(const char *label, const Series &series, const char *valueFormat)
+            {
+                ImGui::TextUnformatted(label);
+                ImGui::SameLine(ImGui::GetFontSize() * 7.0f);
+                ImGui::Text(valueFormat, series.smoothed);
+                ImGui::SameLine(ImGui::GetFontSize() * 12.0f);
+                ImGui::PushID(label);
+                ImGui::PlotLines("##history", series.values, kHistory, g_HistoryOffset, nullptr, 0.0f, series.max * 1.1f, ImVec2(ImGui::GetFontSize() * 10.0f, ImGui::GetFontSize()));
+                ImGui::PopID();
+            }
+        } // namespace
+
+        void RenderPerformanceHUD(bool *p_open)
+        {
+            Sample();
+
+            ImGui::SetNextWindowPos(ImVec2(10.0f, 40.0f), ImGuiCond_FirstUseEver);
+            ImGui::SetNextWindowBgAlpha(0.65f);
+            const ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav;
+            if (!ImGui::Begin("Performance HUD", p_open, flags))
+            {
+                ImGui::End();
+                return;
+            }
+
+            // Frame budget: overlay CPU time as a share of the sim's frame
+            const float share = g_SimFrameMs.smoothed > 0.0f ? g_OverlayMs.smoothed / g_SimFrameMs.smoothed : 0.0f;
+            ImGui::Text("Overlay %.1f%% of the sim frame", share * 100.0f);
+            ImGui::TextDisabled("Sim %s", SimStateName(GetSimState()));
+            SparklineRow("Sim frame", g_SimFrameMs, "%6.2f ms");
+            SparklineRow("Overlay", g_OverlayMs, "%6.3f ms");
+            SparklineRow("Callbacks", g_CallbacksMs, "%6.3f ms");
+            SparklineRow("Render", g_EndFrameMs, "%6.3f ms");
+
+            // Per-callback bars, relative to the overlay frame
+            ImGui::Separator();
+            const float barWidth = ImGui::GetFontSize() * 10.0f;
+            for (CallbackRow &row : g_CallbackRows)
+            {
+                if (row.id == -1 || !row.active)
+                {
+                    continue;
+                }
+                ImGui::PushID(row.id);
+                ImGui::TextUnformatted(row.name);
+                ImGui::SameLine(ImGui::GetFontSize() * 12.0f);
+                const float fraction = g_OverlayMs.smoothed > 0.0f ? row.ms.smoothed / g_OverlayMs.smoothed : 0.0f;
+                ImGui::ProgressBar(std::min(fraction, 1.0f), ImVec2(barWidth, ImGui::GetFontSize()), FrameFormat("%.3f ms", row.ms.smoothed));
+                ImGui::PopID();
+            }
+            if (g_OtherCallbacksMs.smoothed > 0.0005f)
+            {
+                ImGui::TextDisabled("Other callbacks %.3f ms", g_OtherCallbacksMs.smoothed);
+            }
+
+            // Draw data and memory
+            ImGui::Separator();
+            SparklineRow("Vertices", g_Vertices, "%6.0f");
+            SparklineRow("Indices", g_Indices, "%6.0f");
+            SparklineRow("Draw calls", g_DrawCalls, "%6.0f");
+            SparklineRow("Texture switches", g_TextureSwitches, "%6.0f");
+            SparklineRow("XPLM calls", g_XplmCalls, "%6.1f");
+            SparklineRow("Allocations", g_Allocations, "%6.0f");
+            const ImFontAtlas *atlas = ImGui::GetIO().Fonts;
+            const float atlasKiB = static_cast<float>(atlas->TexWidth) * static_cast<float>(atlas->TexHeight) * 4.0f / 1024.0f;
+            ImGui::Text("Font atlas %dx%d, %.0f KiB", atlas->TexWidth, atlas->TexHeight, atlasKiB);
+
+            if (p_open && ImGui::BeginPopupContextWindow())
+            {
+                if (ImGui::MenuItem("Close"))
+                {
+                    *p_open = false;
+                }
+                ImGui::EndPopup();
+            }
+
+            ImGui::End();
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
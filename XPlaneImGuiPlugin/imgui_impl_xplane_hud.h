@@ -0,0 +1,20 @@
+#ifndef IMGUI_IMPL_XPLANE_HUD_H
+#define IMGUI_IMPL_XPLANE_HUD_H
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // Performance HUD
+        // A compact overlay comparing the sim's frame time with what the overlay costs per frame:
+        // phase and per-callback CPU time, draw counts, ImGui allocations and font atlas memory,
+        // with a sparkline of the last frames for the per-frame values. Call it once per frame from
+        // a render callback. History is fixed-size, so it allocates nothing after the first frame.
+        // Right-click the HUD to close it (clears *p_open).
+        void RenderPerformanceHUD(bool *p_open = nullptr);
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_HUD_H
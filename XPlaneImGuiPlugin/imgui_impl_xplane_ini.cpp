@@ -0,0 +1,217 @@
+#include "imgui_impl_xplane_ini.h"
+
+// Standard library headers
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+// ImGui
+#include "imgui.h"
+
+// Project-specific headers
+#include "XPlaneLog.h"
+#include "XPlaneMetrics.h"
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            using Clock = std::chrono::steady_clock;
+
+            // Quiet time before changed settings are written
+            constexpr auto kWriteDelay = std::chrono::seconds(1);
+
+            std::string g_Path;
+            std::thread g_Thread;
+
+            // Shared with the thread
+            std::mutex g_Mutex;
+            std::condition_variable g_Wake;
+            bool g_Stop = false;
+            bool g_LoadDone = false;
+            std::string g_Loaded;
+            bool g_HasPending = false;
+            std::string g_Pending;
+            Clock::time_point g_PendingSince;
+
+            // Render thread only
+            bool g_Applied = false;
+            std::string g_LastSaved;
+
+            XPlaneMetrics::Counter &WritesMetric()
+            {
+                static XPlaneMetrics::Counter &counter = XPlaneMetrics::counter("imgui.ini.writes", "imgui.ini writes");
+                return counter;
+            }
+
+            XPlaneMetrics::Counter &UnchangedMetric()
+            {
+                static XPlaneMetrics::Counter &counter = XPlaneMetrics::counter("imgui.ini.unchanged", "Settings captures identical to the last write");
+                return counter;
+            }
+
+            bool WriteAtomically(const std::string &path, const std::string &text)
+            {
+                const std::string temporaryPath = path + ".tmp";
+                {
+                    std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+                    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+                    out.flush();
+                    if (!out)
+                    {
+                        return false;
+                    }
+                }
+                // Replaces the old file in one step
+                std::error_code error;
+                std::filesystem::rename(temporaryPath, path, error);
+                if (error)
+                {
+                    std::filesystem::remove(temporaryPath, error);
+                    return false;
+                }
+                return true;
+            }
+
+            void ThreadMain()
+            {
+                std::string text;
+                {
+                    std::ifstream in(g_Path, std::ios::binary);
+                    if (in)
+                    {
+                        text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                    }
+                }
+
+                std::unique_lock<std::mutex> lock(g_Mutex);
+                g_Loaded = std::move(text);
+                g_LoadDone = true;
+                g_Wake.notify_all();
+
+                for (;;)
+                {
+                    g_Wake.wait(lock, []
+                                { return g_Stop || g_HasPending; });
+
+                    // Debounce: every new capture restarts the wait
+                    while (!g_Stop && g_HasPending && Clock::now() < g_PendingSince + kWriteDelay)
+                    {
+                        g_Wake.wait_until(lock, g_PendingSince + kWriteDelay);
+                    }
+
+                    if (g_HasPending)
+                    {
+                        std::string pending = std::move(g_Pending);
+                        g_HasPending = false;
+                        lock.unlock();
+                        if (WriteAtomically(g_Path, pending))
+                        {
+                            WritesMetric().add();
+                        }
+                        else
+                        {
+                            XPLOG_WARN("Could not write {}", g_Path);
+                        }
+                        lock.lock();
+                    }
+
+                    if (g_Stop && !g_HasPending)
+                    {
+                        return;
+                    }
+                }
+            }
+
+            // Queue the current settings if they differ from the last save
+            void CaptureSettings()
+            {
+                size_t size = 0;
+                const char *data = ImGui::SaveIniSettingsToMemory(&size);
+                if (g_LastSaved.size() == size && g_LastSaved.compare(0, size, data, size) == 0)
+                {
+                    UnchangedMetric().add();
+                    return;
+                }
+                g_LastSaved.assign(data, size);
+
+                std::lock_guard<std::mutex> lock(g_Mutex);
+                g_Pending = g_LastSaved;
+                g_HasPending = true;
+                g_PendingSince = Clock::now();
+                g_Wake.notify_all();
+            }
+        } // namespace
+
+        void StartIniPersistence(const std::string &path)
+        {
+            g_Path = path;
+            g_Thread = std::thread(ThreadMain);
+        }
+
+        void UpdateIniPersistence()
+        {
+            ImGuiIO &io = ImGui::GetIO();
+            if (!g_Applied && g_Thread.joinable())
+            {
+                // Normally finished during the other init stages
+                std::string text;
+                {
+                    std::unique_lock<std::mutex> lock(g_Mutex);
+                    g_Wake.wait(lock, []
+                                { return g_LoadDone; });
+                    text = std::move(g_Loaded);
+                }
+                if (!text.empty())
+                {
+                    ImGui::LoadIniSettingsFromMemory(text.data(), text.size());
+                }
+                g_LastSaved = std::move(text);
+                g_Applied = true;
+            }
+
+            if (io.WantSaveIniSettings)
+            {
+                io.WantSaveIniSettings = false;
+                CaptureSettings();
+            }
+        }
+
+        void StopIniPersistence()
+        {
+            if (!g_Thread.joinable())
+            {
+                return;
+            }
+
+            // Without a frame the settings were never loaded, and saving them would empty the file
+            if (g_Applied)
+            {
+                CaptureSettings();
+            }
+            {
+                std::lock_guard<std::mutex> lock(g_Mutex);
+                g_Stop = true;
+            }
+            g_Wake.notify_all();
+            g_Thread.join();
+
+            g_Stop = false;
+            g_LoadDone = false;
+            g_Loaded.clear();
+            g_HasPending = false;
+            g_Pending.clear();
+            g_Applied = false;
+            g_LastSaved.clear();
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
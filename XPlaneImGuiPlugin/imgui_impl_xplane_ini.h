@@ -0,0 +1,31 @@
+#ifndef IMGUI_IMPL_XPLANE_INI_H
+#define IMGUI_IMPL_XPLANE_INI_H
+
+// Standard Library
+#include <string>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // imgui.ini persistence
+        // ImGui gets no io.IniFilename, so it never touches the disk on the render thread.
+        //   - Load: a background thread reads the file while the other init stages run. The text
+        //     is applied before the first frame.
+        //   - Save: when ImGui flags changed settings (io.WantSaveIniSettings, at most once per
+        //     io.IniSavingRate), they are captured with SaveIniSettingsToMemory and compared with
+        //     the last save. Only real changes go to the thread.
+        //   - Write: the thread waits for a second without new changes, then writes a temporary
+        //     file and renames it over imgui.ini. A crash mid-write never leaves a truncated file.
+        // Writes are counted in imgui.ini.writes, unchanged captures in imgui.ini.unchanged.
+
+        // Used by imgui_impl_xplane.cpp
+        void StartIniPersistence(const std::string &path); // After the context is created: starts the read
+        void UpdateIniPersistence(); // Before each ImGui::NewFrame(): applies the read, captures changes
+        void StopIniPersistence();   // Before the context is destroyed: writes the last changes and joins
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_INI_H
@@ -0,0 +1,565 @@
+#include "imgui_impl_xplane_map.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Project-specific headers
+#include "XPlaneProfiler.h"
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            constexpr double kPi = 3.14159265358979323846;
+            constexpr double kMaxLatitude = 85.0511287798066;
+            constexpr double kWorldMax = 0.99999999999999989; // Largest double below 1
+            constexpr float kTileSize = 256.0f;
+            constexpr float kHoverPixels = 10.0f;
+            constexpr float kLabelCellPixels = 64.0f;
+            constexpr float kZoomPerWheelStep = 0.25f;
+
+            double ClampWorld(double value)
+            {
+                return std::min(std::max(value, 0.0), kWorldMax);
+            }
+        } // namespace
+
+        void LatLonToWorld(double latitude, double longitude, double *outX, double *outY)
+        {
+            const double lat = std::min(std::max(latitude, -kMaxLatitude), kMaxLatitude) * kPi / 180.0;
+            *outX = ClampWorld((longitude + 180.0) / 360.0);
+            *outY = ClampWorld((1.0 - std::log(std::tan(lat) + 1.0 / std::cos(lat)) / kPi) * 0.5);
+        }
+
+        void WorldToLatLon(double x, double y, double *outLatitude, double *outLongitude)
+        {
+            *outLongitude = x * 360.0 - 180.0;
+            *outLatitude = std::atan(std::sinh(kPi * (1.0 - 2.0 * y))) * 180.0 / kPi;
+        }
+
+        MapCanvas::MapCanvas(const Options &options) : m_options(options)
+        {
+            m_nodes.emplace_back();
+        }
+
+        // Objects
+
+        MapObjectId MapCanvas::add(const MapObject &object)
+        {
+            MapObjectId id;
+            if (!m_freeIds.empty())
+            {
+                id = m_freeIds.back();
+                m_freeIds.pop_back();
+            }
+            else
+            {
+                id = static_cast<MapObjectId>(m_records.size());
+                m_records.emplace_back();
+            }
+            Record &record = m_records[id];
+            record.object = object;
+            record.object.x = ClampWorld(object.x);
+            record.object.y = ClampWorld(object.y);
+            insert(id);
+            ++m_size;
+            return id;
+        }
+
+        void MapCanvas::remove(MapObjectId id)
+        {
+            if (id >= m_records.size() || m_records[id].node < 0)
+            {
+                return;
+            }
+            unlink(id);
+            m_records[id].object = MapObject();
+            m_freeIds.push_back(id);
+            --m_size;
+        }
+
+        void MapCanvas::move(MapObjectId id, double x, double y, float rotation)
+        {
+            if (id >= m_records.size() || m_records[id].node < 0)
+            {
+                return;
+            }
+            x = ClampWorld(x);
+            y = ClampWorld(y);
+            Record &record = m_records[id];
+            record.object.rotation = rotation;
+            if (x == record.object.x && y == record.object.y)
+            {
+                return;
+            }
+
+            const Node &leaf = m_nodes[record.node];
+            if (x >= leaf.minX && x < leaf.minX + leaf.size && y >= leaf.minY && y < leaf.minY + leaf.size)
+            {
+                // Same leaf, hence the same path: only the cluster positions along it change
+                const double dx = x - record.object.x, dy = y - record.object.y;
+                int n = 0;
+                for (;;)
+                {
+                    Node &node = m_nodes[n];
+                    node.sumX += dx;
+                    node.sumY += dy;
+                    if (node.children < 0)
+                    {
+                        break;
+                    }
+                    n = childFor(node, x, y);
+                }
+                record.object.x = x;
+                record.object.y = y;
+                return;
+            }
+
+            unlink(id);
+            record.object.x = x;
+            record.object.y = y;
+            insert(id);
+        }
+
+        void MapCanvas::setStyle(MapObjectId id, ImU32 color, uint16_t symbol, float minZoom, float priority, const std::string &label)
+        {
+            if (id >= m_records.size() || m_records[id].node < 0)
+            {
+                return;
+            }
+            MapObject &object = m_records[id].object;
+            object.color = color;
+            object.symbol = symbol;
+            object.minZoom = minZoom;
+            object.priority = priority;
+            object.label = label;
+        }
+
+        const MapObject *MapCanvas::get(MapObjectId id) const
+        {
+            return id < m_records.size() && m_records[id].node >= 0 ? &m_records[id].object : nullptr;
+        }
+
+        void MapCanvas::clear()
+        {
+            m_nodes.assign(1, Node());
+            m_freeChildren.clear();
+            m_records.clear();
+            m_freeIds.clear();
+            m_size = 0;
+        }
+
+        // Quadtree
+
+        int MapCanvas::childFor(const Node &node, double x, double y) const
+        {
+            const double half = node.size * 0.5;
+            return node.children + (x >= node.minX + half ? 1 : 0) + (y >= node.minY + half ? 2 : 0);
+        }
+
+        int MapCanvas::allocateChildren()
+        {
+            if (!m_freeChildren.empty())
+            {
+                const int first = m_freeChildren.back();
+                m_freeChildren.pop_back();
+                return first;
+            }
+            const int first = static_cast<int>(m_nodes.size());
+            m_nodes.resize(m_nodes.size() + 4);
+            return first;
+        }
+
+        void MapCanvas::insert(MapObjectId id)
+        {
+            Record &record = m_records[id];
+            const double x = record.object.x, y = record.object.y;
+            int n = 0;
+            for (;;)
+            {
+                Node &node = m_nodes[n];
+                ++node.count;
+                node.sumX += x;
+                node.sumY += y;
+                if (node.children < 0)
+                {
+                    record.node = n;
+                    record.slot = static_cast<uint32_t>(node.items.size());
+                    node.items.push_back(id);
+                    if (static_cast<int>(node.items.size()) > m_options.nodeCapacity && node.depth < m_options.maxDepth)
+                    {
+                        split(n);
+                    }
+                    return;
+                }
+                n = childFor(node, x, y);
+            }
+        }
+
+        void MapCanvas::split(int nodeIndex)
+        {
+            const int first = allocateChildren(); // May move m_nodes
+            Node &node = m_nodes[nodeIndex];
+            const double half = node.size * 0.5;
+            for (int k = 0; k < 4; ++k)
+            {
+                Node &child = m_nodes[first + k];
+                child = Node();
+                child.minX = node.minX + (k & 1) * half;
+                child.minY = node.minY + (k >> 1) * half;
+                child.size = half;
+                child.depth = node.depth + 1;
+            }
+            node.children = first;
+
+            std::vector<MapObjectId> items;
+            items.swap(node.items);
+            for (MapObjectId id : items)
+            {
+                Record &record = m_records[id];
+                const int c = childFor(m_nodes[nodeIndex], record.object.x, record.object.y);
+                Node &child = m_nodes[c];
+                ++child.count;
+                child.sumX += record.object.x;
+                child.sumY += record.object.y;
+                record.node = c;
+                record.slot = static_cast<uint32_t>(child.items.size());
+                child.items.push_back(id);
+            }
+
+            // Everything may have landed in one quadrant
+            for (int k = 0; k < 4; ++k)
+            {
+                const Node &child = m_nodes[first + k];
+                if (static_cast<int>(child.items.size()) > m_options.nodeCapacity && child.depth < m_options.maxDepth)
+                {
+                    split(first + k);
+                }
+            }
+        }
+
+        void MapCanvas::unlink(MapObjectId id)
+        {
+            Record &record = m_records[id];
+            const double x = record.object.x, y = record.object.y;
+            int n = 0;
+            for (;;)
+            {
+                Node &node = m_nodes[n];
+                --node.count;
+                node.sumX -= x;
+                node.sumY -= y;
+                if (node.count == 0)
+                {
+                    node.sumX = node.sumY = 0.0; // No rounding left behind
+                }
+                if (node.children < 0)
+                {
+                    break;
+                }
+                n = childFor(node, x, y);
+            }
+
+            Node &leaf = m_nodes[record.node];
+            const MapObjectId last = leaf.items.back();
+            leaf.items[record.slot] = last;
+            m_records[last].slot = record.slot;
+            leaf.items.pop_back();
+            record.node = -1;
+
+            // Merge the highest subtree on the path that has become sparse
+            n = 0;
+            while (m_nodes[n].children >= 0)
+            {
+                if (static_cast<int>(m_nodes[n].count) <= m_options.nodeCapacity / 2)
+                {
+                    collapse(n);
+                    break;
+                }
+                n = childFor(m_nodes[n], x, y);
+            }
+        }
+
+        void MapCanvas::gather(int nodeIndex, std::vector<MapObjectId> &out)
+        {
+            Node &node = m_nodes[nodeIndex];
+            if (node.children < 0)
+            {
+                out.insert(out.end(), node.items.begin(), node.items.end());
+                node.items.clear();
+                return;
+            }
+            const int first = node.children;
+            node.children = -1;
+            for (int k = 0; k < 4; ++k)
+            {
+                gather(first + k, out);
+            }
+            m_freeChildren.push_back(first);
+        }
+
+        void MapCanvas::collapse(int nodeIndex)
+        {
+            std::vector<MapObjectId> items;
+            gather(nodeIndex, items);
+            for (uint32_t slot = 0; slot < items.size(); ++slot)
+            {
+                m_records[items[slot]].node = nodeIndex;
+                m_records[items[slot]].slot = slot;
+            }
+            m_nodes[nodeIndex].items = std::move(items);
+        }
+
+        // View
+
+        void MapCanvas::setView(double centerX, double centerY, float zoom)
+        {
+            m_centerX = ClampWorld(centerX);
+            m_centerY = ClampWorld(centerY);
+            m_zoom = std::min(std::max(zoom, m_options.minZoom), m_options.maxZoom);
+        }
+
+        ImVec2 MapCanvas::worldToScreen(double x, double y) const
+        {
+            const double scale = kTileSize * std::exp2(static_cast<double>(m_zoom));
+            return ImVec2(m_canvasMin.x + m_canvasSize.x * 0.5f + static_cast<float>((x - m_centerX) * scale),
+                          m_canvasMin.y + m_canvasSize.y * 0.5f + static_cast<float>((y - m_centerY) * scale));
+        }
+
+        void MapCanvas::screenToWorld(const ImVec2 &screen, double *outX, double *outY) const
+        {
+            const double scale = kTileSize * std::exp2(static_cast<double>(m_zoom));
+            *outX = m_centerX + (screen.x - m_canvasMin.x - m_canvasSize.x * 0.5f) / scale;
+            *outY = m_centerY + (screen.y - m_canvasMin.y - m_canvasSize.y * 0.5f) / scale;
+        }
+
+        // Drawing
+
+        MapObjectId MapCanvas::draw(const char *id, const ImVec2 &size)
+        {
+            XP_PROFILE_SCOPE("MapCanvas::draw");
+            const ImVec2 available = ImGui::GetContentRegionAvail();
+            m_canvasSize = ImVec2(std::max(size.x > 0.0f ? size.x : available.x, 1.0f), std::max(size.y > 0.0f ? size.y : available.y, 1.0f));
+            m_canvasMin = ImGui::GetCursorScreenPos();
+            const ImVec2 canvasMax(m_canvasMin.x + m_canvasSize.x, m_canvasMin.y + m_canvasSize.y);
+            ImGui::InvisibleButton(id, m_canvasSize);
+            const bool hovered = ImGui::IsItemHovered();
+
+            // Pan and zoom
+            ImGuiIO &io = ImGui::GetIO();
+            double scale = kTileSize * std::exp2(static_cast<double>(m_zoom));
+            if (ImGui::IsItemActive() && ImGui::IsMouseDragging(ImGuiMouseButton_Left, 0.0f))
+            {
+                m_centerX = ClampWorld(m_centerX - io.MouseDelta.x / scale);
+                m_centerY = ClampWorld(m_centerY - io.MouseDelta.y / scale);
+            }
+            if (hovered && io.MouseWheel != 0.0f)
+            {
+                // Keep the point under the cursor in place
+                double mouseX, mouseY;
+                screenToWorld(io.MousePos, &mouseX, &mouseY);
+                m_zoom = std::min(std::max(m_zoom + io.MouseWheel * kZoomPerWheelStep, m_options.minZoom), m_options.maxZoom);
+                scale = kTileSize * std::exp2(static_cast<double>(m_zoom));
+                m_centerX = ClampWorld(mouseX - (io.MousePos.x - m_canvasMin.x - m_canvasSize.x * 0.5f) / scale);
+                m_centerY = ClampWorld(mouseY - (io.MousePos.y - m_canvasMin.y - m_canvasSize.y * 0.5f) / scale);
+            }
+
+            ImDrawList *drawList = ImGui::GetWindowDrawList();
+            drawList->PushClipRect(m_canvasMin, canvasMax, true);
+            drawList->AddRectFilled(m_canvasMin, canvasMax, ImGui::GetColorU32(ImGuiCol_FrameBg));
+
+            // The view in world coordinates, grown so symbols straddling the edge are kept
+            float margin = 0.0f;
+            for (const MarkerSymbol &symbol : m_symbols)
+            {
+                margin = std::max(margin, std::max(symbol.size.x, symbol.size.y));
+            }
+            double viewMinX, viewMinY, viewMaxX, viewMaxY;
+            screenToWorld(ImVec2(m_canvasMin.x - margin, m_canvasMin.y - margin), &viewMinX, &viewMinY);
+            screenToWorld(ImVec2(canvasMax.x + margin, canvasMax.y + margin), &viewMaxX, &viewMaxY);
+
+            m_stats = Stats();
+            m_markerX.clear();
+            m_markerY.clear();
+            m_markerRotation.clear();
+            m_markerColor.clear();
+            m_markerSymbol.clear();
+            m_labelCandidates.clear();
+            MapObjectId hoveredObject = kNoMapObject;
+            float hoveredDistance = kHoverPixels * kHoverPixels;
+            const ImU32 clusterColor = IM_COL32(90, 160, 255, 200);
+            const ImU32 clusterTextColor = IM_COL32_WHITE;
+            const uint16_t symbolCount = static_cast<uint16_t>(std::min<size_t>(m_symbols.size(), 0xFFFF));
+
+            m_stack.clear();
+            m_stack.push_back(0);
+            while (!m_stack.empty())
+            {
+                const int n = m_stack.back();
+                m_stack.pop_back();
+                const Node &node = m_nodes[n];
+                ++m_stats.visitedNodes;
+                if (node.count == 0 || node.minX > viewMaxX || node.minY > viewMaxY || node.minX + node.size < viewMinX || node.minY + node.size < viewMinY)
+                {
+                    continue;
+                }
+
+                // Too small on screen to tell its objects apart
+                if (node.count > 1 && static_cast<float>(node.size * scale) < m_options.clusterPixels)
+                {
+                    const ImVec2 center = worldToScreen(node.sumX / node.count, node.sumY / node.count);
+                    const float radius = std::min(4.0f + 1.5f * std::log2(static_cast<float>(node.count)), m_options.clusterPixels * 0.5f);
+                    drawList->AddCircleFilled(center, radius, clusterColor);
+                    char text[16];
+                    std::snprintf(text, sizeof(text), "%u", node.count);
+                    const ImVec2 textSize = ImGui::CalcTextSize(text);
+                    drawList->AddText(ImVec2(center.x - textSize.x * 0.5f, center.y - textSize.y * 0.5f), clusterTextColor, text);
+                    ++m_stats.clusters;
+                    continue;
+                }
+
+                if (node.children >= 0)
+                {
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        m_stack.push_back(node.children + k);
+                    }
+                    continue;
+                }
+
+                for (MapObjectId objectId : node.items)
+                {
+                    const MapObject &object = m_records[objectId].object;
+                    if (object.minZoom > m_zoom || object.symbol >= symbolCount)
+                    {
+                        continue;
+                    }
+                    const ImVec2 p = worldToScreen(object.x, object.y);
+                    m_markerX.push_back(p.x);
+                    m_markerY.push_back(p.y);
+                    m_markerRotation.push_back(object.rotation);
+                    m_markerColor.push_back(object.color);
+                    m_markerSymbol.push_back(object.symbol);
+                    if (!object.label.empty())
+                    {
+                        const float offset = m_symbols[object.symbol].size.x * 0.5f + 3.0f;
+                        m_labelCandidates.push_back({object.priority, ImVec2(p.x + offset, p.y), objectId});
+                    }
+                    if (hovered)
+                    {
+                        const float dx = p.x - io.MousePos.x, dy = p.y - io.MousePos.y;
+                        if (dx * dx + dy * dy < hoveredDistance)
+                        {
+                            hoveredDistance = dx * dx + dy * dy;
+                            hoveredObject = objectId;
+                        }
+                    }
+                }
+            }
+
+            MarkerBatch batch;
+            batch.x = m_markerX.data();
+            batch.y = m_markerY.data();
+            batch.rotations = m_markerRotation.data();
+            batch.colors = m_markerColor.data();
+            batch.symbols = m_markerSymbol.data();
+            batch.count = static_cast<int>(m_markerX.size());
+            m_stats.drawnObjects = AddMarkers(drawList, batch, m_symbols.data(), static_cast<int>(m_symbols.size()));
+
+            placeLabels(drawList);
+            drawList->PopClipRect();
+            return hoveredObject;
+        }
+
+        void MapCanvas::placeLabels(ImDrawList *drawList)
+        {
+            m_stats.labelCandidates = static_cast<int>(m_labelCandidates.size());
+            if (m_labelCandidates.empty() || m_options.maxLabels <= 0)
+            {
+                return;
+            }
+
+            // Only the best few can be placed; sort just those
+            auto byPriority = [](const LabelCandidate &a, const LabelCandidate &b)
+            { return a.priority > b.priority; };
+            const size_t keep = static_cast<size_t>(m_options.maxLabels) * 4;
+            if (m_labelCandidates.size() > keep)
+            {
+                std::nth_element(m_labelCandidates.begin(), m_labelCandidates.begin() + keep, m_labelCandidates.end(), byPriority);
+                m_labelCandidates.resize(keep);
+            }
+            std::sort(m_labelCandidates.begin(), m_labelCandidates.end(), byPriority);
+
+            // Placed rectangles, bucketed by the screen cells they cover
+            const int columns = static_cast<int>(m_canvasSize.x / kLabelCellPixels) + 1;
+            const int rows = static_cast<int>(m_canvasSize.y / kLabelCellPixels) + 1;
+            m_labelGrid.resize(static_cast<size_t>(columns) * rows);
+            for (std::vector<int> &cell : m_labelGrid)
+            {
+                cell.clear();
+            }
+            m_placedLabels.clear();
+            auto cellOf = [&](float value, float origin, int limit)
+            { return std::min(std::max(static_cast<int>((value - origin) / kLabelCellPixels), 0), limit - 1); };
+
+            const ImU32 textColor = ImGui::GetColorU32(ImGuiCol_Text);
+            const ImU32 shadowColor = IM_COL32(0, 0, 0, 200);
+            for (const LabelCandidate &candidate : m_labelCandidates)
+            {
+                if (m_stats.labels >= m_options.maxLabels)
+                {
+                    break;
+                }
+                const std::string &text = m_records[candidate.id].object.label;
+                const ImVec2 textSize = ImGui::CalcTextSize(text.c_str());
+                const ImVec4 rect(candidate.anchor.x, candidate.anchor.y - textSize.y * 0.5f, candidate.anchor.x + textSize.x, candidate.anchor.y + textSize.y * 0.5f);
+                if (rect.z < m_canvasMin.x || rect.w < m_canvasMin.y || rect.x > m_canvasMin.x + m_canvasSize.x || rect.y > m_canvasMin.y + m_canvasSize.y)
+                {
+                    continue;
+                }
+
+                const int column0 = cellOf(rect.x, m_canvasMin.x, columns), column1 = cellOf(rect.z, m_canvasMin.x, columns);
+                const int row0 = cellOf(rect.y, m_canvasMin.y, rows), row1 = cellOf(rect.w, m_canvasMin.y, rows);
+                bool overlaps = false;
+                for (int row = row0; row <= row1 && !overlaps; ++row)
+                {
+                    for (int column = column0; column <= column1 && !overlaps; ++column)
+                    {
+                        for (int placed : m_labelGrid[static_cast<size_t>(row) * columns + column])
+                        {
+                            const ImVec4 &other = m_placedLabels[placed];
+                            if (rect.x < other.z && rect.z > other.x && rect.y < other.w && rect.w > other.y)
+                            {
+                                overlaps = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+                if (overlaps)
+                {
+                    continue;
+                }
+
+                const int index = static_cast<int>(m_placedLabels.size());
+                m_placedLabels.push_back(rect);
+                for (int row = row0; row <= row1; ++row)
+                {
+                    for (int column = column0; column <= column1; ++column)
+                    {
+                        m_labelGrid[static_cast<size_t>(row) * columns + column].push_back(index);
+                    }
+                }
+                drawList->AddText(ImVec2(rect.x + 1.0f, rect.y + 1.0f), shadowColor, text.c_str());
+                drawList->AddText(ImVec2(rect.x, rect.y), textColor, text.c_str());
+                ++m_stats.labels;
+            }
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
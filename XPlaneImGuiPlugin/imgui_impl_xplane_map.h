@@ -0,0 +1,171 @@
+#ifndef IMGUI_IMPL_XPLANE_MAP_H
+#define IMGUI_IMPL_XPLANE_MAP_H
+
+// ImGui
+#include "imgui.h"
+
+// Bulk marker drawing
+#include "imgui_impl_xplane_markers.h"
+
+// Standard Library
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // Map Canvas
+        // A pan and zoom map for render callbacks, whose per-frame cost follows what is on screen
+        // rather than how many objects it holds:
+        //   - objects live in a quadtree that adapts to their density. Moving one costs
+        //     O(log n), or O(1) while it stays within its leaf;
+        //   - drawing visits only the nodes inside the view;
+        //   - a node smaller than Options::clusterPixels on screen is drawn as one cluster mark
+        //     with its object count, minZoom notwithstanding;
+        //   - objects below their MapObject::minZoom are left out;
+        //   - visible objects are drawn with AddMarkers() (imgui_impl_xplane_markers.h);
+        //   - labels are placed by priority, skipping any that would overlap one already placed,
+        //     up to Options::maxLabels.
+        // World coordinates are Web Mercator in [0, 1] on both axes, y growing southwards (see
+        // LatLonToWorld). At zoom z the world is 256 * 2^z pixels wide, as with web map tiles.
+        // Main thread only.
+
+        using MapObjectId = uint32_t;
+        constexpr MapObjectId kNoMapObject = 0xFFFFFFFFu;
+
+        struct MapObject
+        {
+            double x = 0.0; // World position
+            double y = 0.0;
+            float rotation = 0.0f;        // Radians, clockwise
+            ImU32 color = IM_COL32_WHITE; // Marker tint
+            uint16_t symbol = 0;          // Index into MapCanvas::setSymbols()
+            float minZoom = 0.0f;         // Hidden while zoomed out further
+            float priority = 0.0f;        // Labels with higher priority are placed first
+            std::string label;            // Empty: no label
+        };
+
+        // Web Mercator; latitudes beyond +-85.05 degrees are clamped
+        void LatLonToWorld(double latitude, double longitude, double *outX, double *outY);
+        void WorldToLatLon(double x, double y, double *outLatitude, double *outLongitude);
+
+        struct MapCanvasOptions
+        {
+            int nodeCapacity = 16;      // Objects a leaf holds before it splits
+            int maxDepth = 24;          // About 2 m per leaf at the equator
+            float clusterPixels = 24.0f; // Nodes smaller than this on screen become one cluster mark
+            int maxLabels = 256;        // Per frame
+            float minZoom = 0.0f;
+            float maxZoom = 20.0f;
+        };
+
+        struct MapCanvasStats
+        {
+            int visitedNodes = 0;
+            int drawnObjects = 0;
+            int clusters = 0;
+            int labelCandidates = 0;
+            int labels = 0;
+        };
+
+        class MapCanvas
+        {
+        public:
+            using Options = MapCanvasOptions;
+            using Stats = MapCanvasStats;
+
+            explicit MapCanvas(const Options &options = Options());
+
+            // Objects
+            MapObjectId add(const MapObject &object);
+            void remove(MapObjectId id);
+            // O(log n); rotation only changes the marker
+            void move(MapObjectId id, double x, double y, float rotation);
+            // Everything but the position; use move() for that
+            void setStyle(MapObjectId id, ImU32 color, uint16_t symbol, float minZoom, float priority, const std::string &label);
+            const MapObject *get(MapObjectId id) const;
+            size_t size() const { return m_size; }
+            void clear();
+
+            // Marker symbols, indexed by MapObject::symbol
+            void setSymbols(const std::vector<MarkerSymbol> &symbols) { m_symbols = symbols; }
+
+            // View
+            void setView(double centerX, double centerY, float zoom);
+            double centerX() const { return m_centerX; }
+            double centerY() const { return m_centerY; }
+            float zoom() const { return m_zoom; }
+            ImVec2 worldToScreen(double x, double y) const;
+            void screenToWorld(const ImVec2 &screen, double *outX, double *outY) const;
+
+            // Draws the map as an item of the current window, filling the remaining content region
+            // if size is zero. Dragging pans, the mouse wheel zooms around the cursor. Returns the
+            // object under the mouse, or kNoMapObject.
+            MapObjectId draw(const char *id, const ImVec2 &size = ImVec2(0.0f, 0.0f));
+
+            const Stats &lastStats() const { return m_stats; }
+
+        private:
+            struct Node
+            {
+                double minX = 0.0, minY = 0.0, size = 1.0; // Square bounds
+                int depth = 0;
+                int children = -1; // First of four consecutive nodes, or -1 for a leaf
+                uint32_t count = 0; // Objects in the subtree
+                double sumX = 0.0, sumY = 0.0; // For the cluster position
+                std::vector<MapObjectId> items; // Leaves only
+            };
+
+            struct Record
+            {
+                MapObject object;
+                int node = -1; // Leaf holding it; -1 for a free id
+                uint32_t slot = 0; // Index in the leaf's items
+            };
+
+            struct LabelCandidate
+            {
+                float priority;
+                ImVec2 anchor;
+                MapObjectId id;
+            };
+
+            int childFor(const Node &node, double x, double y) const;
+            void insert(MapObjectId id);
+            void unlink(MapObjectId id);
+            void split(int nodeIndex);
+            void collapse(int nodeIndex);
+            void gather(int nodeIndex, std::vector<MapObjectId> &out);
+            int allocateChildren();
+            void placeLabels(ImDrawList *drawList);
+
+            Options m_options;
+            std::vector<Node> m_nodes; // m_nodes[0] is the root
+            std::vector<int> m_freeChildren; // First index of released groups of four
+            std::vector<Record> m_records;
+            std::vector<MapObjectId> m_freeIds;
+            size_t m_size = 0;
+            std::vector<MarkerSymbol> m_symbols;
+
+            double m_centerX = 0.5, m_centerY = 0.5;
+            float m_zoom = 2.0f;
+            ImVec2 m_canvasMin = ImVec2(0.0f, 0.0f), m_canvasSize = ImVec2(0.0f, 0.0f);
+            Stats m_stats;
+
+            // Reused between frames
+            std::vector<int> m_stack;
+            std::vector<float> m_markerX, m_markerY, m_markerRotation;
+            std::vector<ImU32> m_markerColor;
+            std::vector<uint16_t> m_markerSymbol;
+            std::vector<LabelCandidate> m_labelCandidates;
+            std::vector<ImVec4> m_placedLabels;
+            std::vector<std::vector<int>> m_labelGrid;
+        };
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_MAP_H
@@ -0,0 +1,262 @@
+#include "imgui_impl_xplane_markers.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMGUI_XP_MARKERS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            // Quads per PrimReserve: 32768 vertices, so a reserve never overflows 16-bit indices
+            // (ImGui starts a new vertex offset between reserves)
+            constexpr int kQuadsPerReserve = 8192;
+
+            constexpr float kPi = 3.14159265358979f;
+            constexpr float kHalfPi = 1.57079632679490f;
+            constexpr float kTwoPi = 6.28318530717959f;
+            constexpr float kInvTwoPi = 0.159154943091895f;
+
+            // Taylor series to x^9 on [-pi/2, pi/2]; error below 4e-6, well under a pixel
+            constexpr float kSin3 = -1.0f / 6.0f;
+            constexpr float kSin5 = 1.0f / 120.0f;
+            constexpr float kSin7 = -1.0f / 5040.0f;
+            constexpr float kSin9 = 1.0f / 362880.0f;
+
+            std::vector<int> g_Visible; // Indices of the markers left after culling, reused
+
+            float Sin(float x)
+            {
+                x -= kTwoPi * std::floor(x * kInvTwoPi + 0.5f); // [-pi, pi]
+                x = std::min(x, kPi - x);                        // sin(x) = sin(pi - x)
+                x = std::max(x, -kPi - x);
+                const float x2 = x * x;
+                return x * (1.0f + x2 * (kSin3 + x2 * (kSin5 + x2 * (kSin7 + x2 * kSin9))));
+            }
+
+            struct Corners
+            {
+                float x[4]; // Top left, top right, bottom right, bottom left
+                float y[4];
+            };
+
+            // Offsets of the corners from the center: (+-a +-b, +-e +-f), where a, e come from the
+            // half width and b, f from the half height rotated by the marker's angle
+            void RotatedCorners(float px, float py, float hx, float hy, float s, float c, Corners &out)
+            {
+                const float a = hx * c, b = hy * s, e = hx * s, f = hy * c;
+                out.x[0] = px - a + b;
+                out.y[0] = py - e - f;
+                out.x[1] = px + a + b;
+                out.y[1] = py + e - f;
+                out.x[2] = px + a - b;
+                out.y[2] = py + e + f;
+                out.x[3] = px - a - b;
+                out.y[3] = py - e + f;
+            }
+
+            void WriteQuad(ImDrawVert *vtx, ImDrawIdx *idx, unsigned int base, const Corners &corners, const MarkerSymbol &symbol, ImU32 color)
+            {
+                const ImVec2 uv[4] = {symbol.uv0, ImVec2(symbol.uv1.x, symbol.uv0.y), symbol.uv1, ImVec2(symbol.uv0.x, symbol.uv1.y)};
+                for (int k = 0; k < 4; ++k)
+                {
+                    vtx[k].pos = ImVec2(corners.x[k], corners.y[k]);
+                    vtx[k].uv = uv[k];
+                    vtx[k].col = color;
+                }
+                idx[0] = static_cast<ImDrawIdx>(base);
+                idx[1] = static_cast<ImDrawIdx>(base + 1);
+                idx[2] = static_cast<ImDrawIdx>(base + 2);
+                idx[3] = static_cast<ImDrawIdx>(base);
+                idx[4] = static_cast<ImDrawIdx>(base + 2);
+                idx[5] = static_cast<ImDrawIdx>(base + 3);
+            }
+
+#ifdef IMGUI_XP_MARKERS_SSE2
+            __m128 SinPs(__m128 x)
+            {
+                const __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kInvTwoPi))));
+                x = _mm_sub_ps(x, _mm_mul_ps(turns, _mm_set1_ps(kTwoPi)));
+                x = _mm_min_ps(x, _mm_sub_ps(_mm_set1_ps(kPi), x));
+                x = _mm_max_ps(x, _mm_sub_ps(_mm_set1_ps(-kPi), x));
+                const __m128 x2 = _mm_mul_ps(x, x);
+                __m128 p = _mm_add_ps(_mm_set1_ps(kSin7), _mm_mul_ps(x2, _mm_set1_ps(kSin9)));
+                p = _mm_add_ps(_mm_set1_ps(kSin5), _mm_mul_ps(x2, p));
+                p = _mm_add_ps(_mm_set1_ps(kSin3), _mm_mul_ps(x2, p));
+                p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, p));
+                return _mm_mul_ps(x, p);
+            }
+
+            // Corners of four markers at once; lane k of each array belongs to marker k
+            void RotatedCorners4(const float *px, const float *py, const float *hx, const float *hy, const float *angles, Corners out[4])
+            {
+                const __m128 x = _mm_loadu_ps(px), y = _mm_loadu_ps(py);
+                const __m128 w = _mm_loadu_ps(hx), h = _mm_loadu_ps(hy);
+                __m128 s = _mm_setzero_ps(), c = _mm_set1_ps(1.0f);
+                if (angles)
+                {
+                    const __m128 angle = _mm_loadu_ps(angles);
+                    s = SinPs(angle);
+                    c = SinPs(_mm_add_ps(angle, _mm_set1_ps(kHalfPi)));
+                }
+                const __m128 a = _mm_mul_ps(w, c), b = _mm_mul_ps(h, s), e = _mm_mul_ps(w, s), f = _mm_mul_ps(h, c);
+
+                alignas(16) float cx[4][4], cy[4][4];
+                _mm_store_ps(cx[0], _mm_add_ps(_mm_sub_ps(x, a), b));
+                _mm_store_ps(cy[0], _mm_sub_ps(_mm_sub_ps(y, e), f));
+                _mm_store_ps(cx[1], _mm_add_ps(_mm_add_ps(x, a), b));
+                _mm_store_ps(cy[1], _mm_sub_ps(_mm_add_ps(y, e), f));
+                _mm_store_ps(cx[2], _mm_sub_ps(_mm_add_ps(x, a), b));
+                _mm_store_ps(cy[2], _mm_add_ps(_mm_add_ps(y, e), f));
+                _mm_store_ps(cx[3], _mm_sub_ps(_mm_sub_ps(x, a), b));
+                _mm_store_ps(cy[3], _mm_add_ps(_mm_sub_ps(y, e), f));
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        out[lane].x[k] = cx[k][lane];
+                        out[lane].y[k] = cy[k][lane];
+                    }
+                }
+            }
+#endif
+
+            // Appends the markers within the clip rect grown by the largest symbol's radius
+            int Cull(const MarkerBatch &batch, int symbolCount, const ImVec2 &min, const ImVec2 &max)
+            {
+                if (static_cast<int>(g_Visible.size()) < batch.count)
+                {
+                    g_Visible.resize(batch.count);
+                }
+                int *visible = g_Visible.data();
+                int count = 0;
+                int i = 0;
+#ifdef IMGUI_XP_MARKERS_SSE2
+                const __m128 minX = _mm_set1_ps(min.x), minY = _mm_set1_ps(min.y);
+                const __m128 maxX = _mm_set1_ps(max.x), maxY = _mm_set1_ps(max.y);
+                for (; i + 4 <= batch.count; i += 4)
+                {
+                    const __m128 x = _mm_loadu_ps(batch.x + i), y = _mm_loadu_ps(batch.y + i);
+                    const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(x, minX), _mm_cmple_ps(x, maxX)),
+                                                     _mm_and_ps(_mm_cmpge_ps(y, minY), _mm_cmple_ps(y, maxY)));
+                    const int mask = _mm_movemask_ps(inside);
+                    if (!mask)
+                    {
+                        continue;
+                    }
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        if ((mask & (1 << k)) && batch.symbols[i + k] < symbolCount)
+                        {
+                            visible[count++] = i + k;
+                        }
+                    }
+                }
+#endif
+                for (; i < batch.count; ++i)
+                {
+                    const float x = batch.x[i], y = batch.y[i];
+                    if (x >= min.x && x <= max.x && y >= min.y && y <= max.y && batch.symbols[i] < symbolCount)
+                    {
+                        visible[count++] = i;
+                    }
+                }
+                return count;
+            }
+
+            void EmitQuads(ImDrawList *drawList, const MarkerBatch &batch, const MarkerSymbol *symbols, const int *visible, int count)
+            {
+                drawList->PrimReserve(count * 6, count * 4);
+                ImDrawVert *vtx = drawList->_VtxWritePtr;
+                ImDrawIdx *idx = drawList->_IdxWritePtr;
+                const unsigned int base = drawList->_VtxCurrentIdx;
+
+                int j = 0;
+#ifdef IMGUI_XP_MARKERS_SSE2
+                // Gathered into lanes, then four markers' corners per pass
+                alignas(16) float px[4], py[4], hx[4], hy[4], angles[4];
+                Corners corners[4];
+                for (; j + 4 <= count; j += 4)
+                {
+                    for (int lane = 0; lane < 4; ++lane)
+                    {
+                        const int i = visible[j + lane];
+                        const MarkerSymbol &symbol = symbols[batch.symbols[i]];
+                        px[lane] = batch.x[i];
+                        py[lane] = batch.y[i];
+                        hx[lane] = symbol.size.x * 0.5f;
+                        hy[lane] = symbol.size.y * 0.5f;
+                        angles[lane] = batch.rotations ? batch.rotations[i] : 0.0f;
+                    }
+                    RotatedCorners4(px, py, hx, hy, batch.rotations ? angles : nullptr, corners);
+                    for (int lane = 0; lane < 4; ++lane)
+                    {
+                        const int i = visible[j + lane];
+                        const int quad = j + lane;
+                        WriteQuad(vtx + quad * 4, idx + quad * 6, base + quad * 4, corners[lane], symbols[batch.symbols[i]], batch.colors ? batch.colors[i] : IM_COL32_WHITE);
+                    }
+                }
+#endif
+                for (; j < count; ++j)
+                {
+                    const int i = visible[j];
+                    const MarkerSymbol &symbol = symbols[batch.symbols[i]];
+                    const float angle = batch.rotations ? batch.rotations[i] : 0.0f;
+                    Corners corners;
+                    RotatedCorners(batch.x[i], batch.y[i], symbol.size.x * 0.5f, symbol.size.y * 0.5f, Sin(angle), Sin(angle + kHalfPi), corners);
+                    WriteQuad(vtx + j * 4, idx + j * 6, base + j * 4, corners, symbol, batch.colors ? batch.colors[i] : IM_COL32_WHITE);
+                }
+
+                drawList->_VtxWritePtr += count * 4;
+                drawList->_IdxWritePtr += count * 6;
+                drawList->_VtxCurrentIdx += static_cast<unsigned int>(count * 4);
+            }
+        } // namespace
+
+        MarkerSymbol SolidMarkerSymbol(const ImVec2 &size)
+        {
+            MarkerSymbol symbol;
+            symbol.size = size;
+            symbol.uv0 = symbol.uv1 = ImGui::GetIO().Fonts->TexUvWhitePixel;
+            return symbol;
+        }
+
+        int AddMarkers(ImDrawList *drawList, const MarkerBatch &batch, const MarkerSymbol *symbols, int symbolCount)
+        {
+            if (batch.count <= 0 || !batch.x || !batch.y || !batch.symbols || symbolCount <= 0)
+            {
+                return 0;
+            }
+
+            // A rotated symbol stays within its half diagonal of the position
+            float radius = 0.0f;
+            for (int s = 0; s < symbolCount; ++s)
+            {
+                radius = std::max(radius, 0.5f * std::sqrt(symbols[s].size.x * symbols[s].size.x + symbols[s].size.y * symbols[s].size.y));
+            }
+            const ImVec2 clipMin = drawList->GetClipRectMin(), clipMax = drawList->GetClipRectMax();
+            const int visible = Cull(batch, symbolCount, ImVec2(clipMin.x - radius, clipMin.y - radius), ImVec2(clipMax.x + radius, clipMax.y + radius));
+
+            for (int start = 0; start < visible; start += kQuadsPerReserve)
+            {
+                EmitQuads(drawList, batch, symbols, g_Visible.data() + start, std::min(kQuadsPerReserve, visible - start));
+            }
+            return visible;
+        }
+
+        int Markers(const MarkerBatch &batch, const MarkerSymbol *symbols, int symbolCount)
+        {
+            return AddMarkers(ImGui::GetWindowDrawList(), batch, symbols, symbolCount);
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
@@ -0,0 +1,59 @@
+#ifndef IMGUI_IMPL_XPLANE_MARKERS_H
+#define IMGUI_IMPL_XPLANE_MARKERS_H
+
+// ImGui
+#include "imgui.h"
+
+// Standard Library
+#include <cstdint>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // Bulk Markers
+        // Traffic and map displays draw thousands of rotated symbols a frame. Drawn one by one with
+        // AddImageQuad or AddPolyline, each pays for a call, its own trigonometry and its own buffer
+        // checks. AddMarkers() takes the whole set as parallel arrays instead and, in one pass:
+        //   - culls against the draw list's clip rect, four markers at a time with SSE2;
+        //   - reserves the vertices and indices of every visible marker at once;
+        //   - computes the rotated corners four markers at a time.
+        // Markers are textured quads in the draw list's current texture, normally the font atlas, so
+        // symbols come from atlas images (imgui_impl_xplane_atlas.h) and batch with the text around
+        // them. benchmarks/MarkerBenchmark compares it with per-item calls. Does not depend on the
+        // X-Plane SDK. Main thread only.
+
+        // A symbol is a quad of the given size centered on the marker position
+        struct MarkerSymbol
+        {
+            ImVec2 size = ImVec2(0.0f, 0.0f); // Pixels
+            ImVec2 uv0 = ImVec2(0.0f, 0.0f);
+            ImVec2 uv1 = ImVec2(0.0f, 0.0f);
+        };
+
+        // Untextured symbol: a solid quad using the atlas's white pixel, tinted by the marker color
+        MarkerSymbol SolidMarkerSymbol(const ImVec2 &size);
+
+        // Structure of arrays, count entries each. rotations and colors may be nullptr for no
+        // rotation and white. Markers with a symbol index outside the symbol table are skipped.
+        struct MarkerBatch
+        {
+            const float *x = nullptr;         // Screen position, pixels
+            const float *y = nullptr;
+            const float *rotations = nullptr; // Radians, clockwise on screen
+            const ImU32 *colors = nullptr;
+            const uint16_t *symbols = nullptr;
+            int count = 0;
+        };
+
+        // Returns the number of markers drawn after culling
+        int AddMarkers(ImDrawList *drawList, const MarkerBatch &batch, const MarkerSymbol *symbols, int symbolCount);
+
+        // Into the current window
+        int Markers(const MarkerBatch &batch, const MarkerSymbol *symbols, int symbolCount);
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_MARKERS_H
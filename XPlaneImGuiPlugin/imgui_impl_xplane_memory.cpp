@@ -0,0 +1,515 @@
+// Platform headers, for the resident set size
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX // Keep std::min and std::max usable
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "imgui_impl_xplane_memory.h"
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            // Pool
+
+            constexpr size_t kSizeClasses[] = {16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096};
+            constexpr int kClassCount = static_cast<int>(sizeof(kSizeClasses) / sizeof(kSizeClasses[0]));
+            constexpr uint32_t kLargeClass = kClassCount; // Served by malloc
+            constexpr size_t kMaxSmallSize = kSizeClasses[kClassCount - 1];
+
+            // Slabs the pool carves small blocks from
+            constexpr size_t kSlabSize = 256 * 1024;
+
+            // Blocks moved between a thread cache and the shared pool at a time
+            constexpr uint32_t kCacheBatch = 32;
+
+            // Precedes every block; 16 bytes so the payload keeps malloc's alignment
+            struct alignas(16) BlockHeader
+            {
+                uint32_t sizeClass;
+                uint32_t reserved;
+                uint64_t size; // Requested size, for the byte counters
+            };
+            static_assert(sizeof(BlockHeader) == 16, "BlockHeader must preserve 16-byte alignment");
+
+            struct FreeBlock
+            {
+                FreeBlock *next;
+            };
+
+            // Size class for each size rounded up to 16 bytes, so the lookup is one table read
+            const std::array<uint8_t, kMaxSmallSize / 16 + 1> g_ClassForSize = []
+            {
+                std::array<uint8_t, kMaxSmallSize / 16 + 1> table{};
+                int sizeClass = 0;
+                for (size_t i = 0; i < table.size(); ++i)
+                {
+                    while (kSizeClasses[sizeClass] < i * 16)
+                    {
+                        ++sizeClass;
+                    }
+                    table[i] = static_cast<uint8_t>(sizeClass);
+                }
+                return table;
+            }();
+
+            // Shared pool, refilled from and spilled to by the thread caches
+            std::mutex g_PoolMutex;
+            FreeBlock *g_PoolFreeLists[kClassCount] = {};
+            char *g_SlabCursor = nullptr;
+            char *g_SlabEnd = nullptr;
+            std::atomic<size_t> g_PoolBytesReserved{0};
+
+            // Every slab in order of allocation, so the last one is the slab being carved
+            struct Slab
+            {
+                char *data;
+                size_t carvedBytes; // Headers included
+                size_t freeBytes;   // Scratch for ReleaseFreeSlabsLocked()
+            };
+            std::vector<Slab> g_Slabs;
+
+            // Plain data with no destructor, so a cache left behind in an X-Plane thread is harmless
+            // when the plugin unloads. Blocks cached by a thread that exits are not reclaimed.
+            struct ThreadCache
+            {
+                FreeBlock *freeLists[kClassCount];
+                uint32_t counts[kClassCount];
+
+                // Counters not yet published to the frame counters, so the fast path has no atomics
+                uint64_t allocations;
+                uint64_t frees;
+                uint64_t bytesAllocated;
+                int64_t bytesInUseDelta;
+                int64_t peakBytesInUseDelta;
+            };
+            thread_local ThreadCache t_Cache;
+
+            // Counters for the frame in progress. Threads publish theirs on every cache refill or
+            // spill; the render thread also publishes at the start of each frame.
+            std::atomic<uint64_t> g_FrameAllocations{0};
+            std::atomic<uint64_t> g_FrameFrees{0};
+            std::atomic<uint64_t> g_FrameBytesAllocated{0};
+            std::atomic<size_t> g_BytesInUse{0};
+            std::atomic<size_t> g_FramePeakBytesInUse{0};
+
+            // Counters of the last completed frame
+            AllocatorStats g_LastFrameStats;
+
+            // Carve a block from the current slab, starting a new one if it is used up. Pool lock held.
+            FreeBlock *CarveBlockLocked(int sizeClass)
+            {
+                size_t blockSize = sizeof(BlockHeader) + kSizeClasses[sizeClass];
+                if (!g_SlabCursor || static_cast<size_t>(g_SlabEnd - g_SlabCursor) < blockSize)
+                {
+                    // The tail of the old slab is abandoned; at most one block's worth
+                    g_SlabCursor = static_cast<char *>(std::malloc(kSlabSize));
+                    if (!g_SlabCursor)
+                    {
+                        g_SlabEnd = nullptr;
+                        return nullptr;
+                    }
+                    g_SlabEnd = g_SlabCursor + kSlabSize;
+                    g_Slabs.push_back({g_SlabCursor, 0, 0});
+                    g_PoolBytesReserved.fetch_add(kSlabSize, std::memory_order_relaxed);
+                }
+
+                BlockHeader *header = reinterpret_cast<BlockHeader *>(g_SlabCursor);
+                header->sizeClass = static_cast<uint32_t>(sizeClass);
+                g_SlabCursor += blockSize;
+                g_Slabs.back().carvedBytes += blockSize;
+                return reinterpret_cast<FreeBlock *>(header + 1);
+            }
+
+            void PublishCounters(ThreadCache &cache)
+            {
+                g_FrameAllocations.fetch_add(cache.allocations, std::memory_order_relaxed);
+                g_FrameFrees.fetch_add(cache.frees, std::memory_order_relaxed);
+                g_FrameBytesAllocated.fetch_add(cache.bytesAllocated, std::memory_order_relaxed);
+                size_t inUseBefore = g_BytesInUse.fetch_add(static_cast<size_t>(cache.bytesInUseDelta), std::memory_order_relaxed);
+
+                // This thread's highest point since the last publish, on top of what was live before it
+                size_t peak = inUseBefore + static_cast<size_t>(cache.peakBytesInUseDelta);
+                size_t framePeak = g_FramePeakBytesInUse.load(std::memory_order_relaxed);
+                while (peak > framePeak && !g_FramePeakBytesInUse.compare_exchange_weak(framePeak, peak, std::memory_order_relaxed))
+                {
+                }
+
+                cache.allocations = 0;
+                cache.frees = 0;
+                cache.bytesAllocated = 0;
+                cache.bytesInUseDelta = 0;
+                cache.peakBytesInUseDelta = 0;
+            }
+
+            // Move a batch of blocks from the shared pool into this thread's cache
+            void RefillCache(int sizeClass)
+            {
+                ThreadCache &cache = t_Cache;
+                PublishCounters(cache);
+                std::lock_guard<std::mutex> lock(g_PoolMutex);
+                for (uint32_t i = 0; i < kCacheBatch; ++i)
+                {
+                    FreeBlock *block = g_PoolFreeLists[sizeClass];
+                    if (block)
+                    {
+                        g_PoolFreeLists[sizeClass] = block->next;
+                    }
+                    else if (!(block = CarveBlockLocked(sizeClass)))
+                    {
+                        break;
+                    }
+                    block->next = cache.freeLists[sizeClass];
+                    cache.freeLists[sizeClass] = block;
+                    ++cache.counts[sizeClass];
+                }
+            }
+
+            // Return a batch of blocks from this thread's cache to the shared pool
+            void SpillCache(int sizeClass)
+            {
+                ThreadCache &cache = t_Cache;
+                PublishCounters(cache);
+                std::lock_guard<std::mutex> lock(g_PoolMutex);
+                for (uint32_t i = 0; i < kCacheBatch && cache.freeLists[sizeClass]; ++i)
+                {
+                    FreeBlock *block = cache.freeLists[sizeClass];
+                    cache.freeLists[sizeClass] = block->next;
+                    --cache.counts[sizeClass];
+                    block->next = g_PoolFreeLists[sizeClass];
+                    g_PoolFreeLists[sizeClass] = block;
+                }
+            }
+
+            // Move every block in this thread's cache to the shared pool. Pool lock held.
+            void ReturnCacheLocked(ThreadCache &cache)
+            {
+                for (int sizeClass = 0; sizeClass < kClassCount; ++sizeClass)
+                {
+                    while (FreeBlock *block = cache.freeLists[sizeClass])
+                    {
+                        cache.freeLists[sizeClass] = block->next;
+                        block->next = g_PoolFreeLists[sizeClass];
+                        g_PoolFreeLists[sizeClass] = block;
+                    }
+                    cache.counts[sizeClass] = 0;
+                }
+            }
+
+            // Free the slabs whose every block is back in the shared pool. Blocks still cached by
+            // other threads keep their slab. Pool lock held.
+            void ReleaseFreeSlabsLocked()
+            {
+                if (g_Slabs.empty())
+                {
+                    return;
+                }
+
+                // Slabs by address, to find the one a block was carved from
+                std::vector<Slab *> byAddress;
+                byAddress.reserve(g_Slabs.size());
+                for (Slab &slab : g_Slabs)
+                {
+                    slab.freeBytes = 0;
+                    byAddress.push_back(&slab);
+                }
+                std::sort(byAddress.begin(), byAddress.end(), [](const Slab *a, const Slab *b)
+                          { return a->data < b->data; });
+                auto slabOf = [&byAddress](const FreeBlock *block)
+                {
+                    const char *address = reinterpret_cast<const char *>(block);
+                    auto it = std::upper_bound(byAddress.begin(), byAddress.end(), address, [](const char *a, const Slab *slab)
+                                               { return a < slab->data; });
+                    return *(it - 1);
+                };
+
+                for (int sizeClass = 0; sizeClass < kClassCount; ++sizeClass)
+                {
+                    for (FreeBlock *block = g_PoolFreeLists[sizeClass]; block; block = block->next)
+                    {
+                        slabOf(block)->freeBytes += sizeof(BlockHeader) + kSizeClasses[sizeClass];
+                    }
+                }
+
+                // Unlink the blocks of the slabs about to be freed
+                for (int sizeClass = 0; sizeClass < kClassCount; ++sizeClass)
+                {
+                    FreeBlock **link = &g_PoolFreeLists[sizeClass];
+                    while (*link)
+                    {
+                        const Slab *slab = slabOf(*link);
+                        if (slab->freeBytes == slab->carvedBytes)
+                        {
+                            *link = (*link)->next;
+                        }
+                        else
+                        {
+                            link = &(*link)->next;
+                        }
+                    }
+                }
+
+                if (g_Slabs.back().freeBytes == g_Slabs.back().carvedBytes)
+                {
+                    // The next allocation starts a new slab
+                    g_SlabCursor = nullptr;
+                    g_SlabEnd = nullptr;
+                }
+                size_t released = 0;
+                g_Slabs.erase(std::remove_if(g_Slabs.begin(), g_Slabs.end(), [&released](const Slab &slab)
+                                             {
+                                                 if (slab.freeBytes != slab.carvedBytes)
+                                                 {
+                                                     return false;
+                                                 }
+                                                 std::free(slab.data);
+                                                 ++released;
+                                                 return true;
+                                             }),
+                              g_Slabs.end());
+                g_PoolBytesReserved.fetch_sub(released * kSlabSize, std::memory_order_relaxed);
+            }
+
+            void CountAllocation(ThreadCache &cache, size_t size)
+            {
+                ++cache.allocations;
+                cache.bytesAllocated += size;
+                cache.bytesInUseDelta += static_cast<int64_t>(size);
+                cache.peakBytesInUseDelta = std::max(cache.peakBytesInUseDelta, cache.bytesInUseDelta);
+            }
+
+            void *PoolAlloc(size_t size, void * /*userData*/)
+            {
+                ThreadCache &cache = t_Cache;
+                BlockHeader *header;
+                if (size <= kMaxSmallSize)
+                {
+                    int sizeClass = g_ClassForSize[(size + 15) / 16];
+                    if (!cache.freeLists[sizeClass])
+                    {
+                        RefillCache(sizeClass);
+                        if (!cache.freeLists[sizeClass])
+                        {
+                            return nullptr;
+                        }
+                    }
+
+                    FreeBlock *block = cache.freeLists[sizeClass];
+                    cache.freeLists[sizeClass] = block->next;
+                    --cache.counts[sizeClass];
+                    header = reinterpret_cast<BlockHeader *>(block) - 1;
+                }
+                else
+                {
+                    header = static_cast<BlockHeader *>(std::malloc(sizeof(BlockHeader) + size));
+                    if (!header)
+                    {
+                        return nullptr;
+                    }
+                    header->sizeClass = kLargeClass;
+                }
+
+                header->size = size;
+                CountAllocation(cache, size);
+                return header + 1;
+            }
+
+            void PoolFree(void *ptr, void * /*userData*/)
+            {
+                if (!ptr)
+                {
+                    return;
+                }
+
+                BlockHeader *header = static_cast<BlockHeader *>(ptr) - 1;
+                ThreadCache &cache = t_Cache;
+                ++cache.frees;
+                cache.bytesInUseDelta -= static_cast<int64_t>(header->size);
+
+                if (header->sizeClass == kLargeClass)
+                {
+                    std::free(header);
+                    return;
+                }
+
+                // Freed blocks go to the freeing thread's cache, wherever they were allocated
+                int sizeClass = static_cast<int>(header->sizeClass);
+                FreeBlock *block = static_cast<FreeBlock *>(ptr);
+                block->next = cache.freeLists[sizeClass];
+                cache.freeLists[sizeClass] = block;
+                if (++cache.counts[sizeClass] > 2 * kCacheBatch)
+                {
+                    SpillCache(sizeClass);
+                }
+            }
+
+            // Frame arena
+
+            constexpr size_t kArenaBlockSize = 256 * 1024;
+
+            struct ArenaBlock
+            {
+                std::unique_ptr<char[]> data;
+                size_t size;
+            };
+
+            std::vector<ArenaBlock> g_ArenaBlocks;
+            size_t g_ArenaBlockIndex = 0;
+            size_t g_ArenaOffset = 0;
+            size_t g_ArenaBytesUsed = 0;
+        } // namespace
+
+        void InstallAllocator()
+        {
+            ImGui::SetAllocatorFunctions(PoolAlloc, PoolFree, nullptr);
+        }
+
+        void BeginFrameAllocator()
+        {
+            // Close the frame's counters, including what this (render) thread has not published yet
+            PublishCounters(t_Cache);
+            g_LastFrameStats.allocations = g_FrameAllocations.exchange(0, std::memory_order_relaxed);
+            g_LastFrameStats.frees = g_FrameFrees.exchange(0, std::memory_order_relaxed);
+            g_LastFrameStats.bytesAllocated = g_FrameBytesAllocated.exchange(0, std::memory_order_relaxed);
+            g_LastFrameStats.bytesInUse = g_BytesInUse.load(std::memory_order_relaxed);
+            g_LastFrameStats.peakBytesInUse = std::max(g_FramePeakBytesInUse.exchange(g_LastFrameStats.bytesInUse, std::memory_order_relaxed),
+                                                       g_LastFrameStats.bytesInUse);
+            g_LastFrameStats.poolBytesReserved = g_PoolBytesReserved.load(std::memory_order_relaxed);
+            g_LastFrameStats.frameArenaBytes = g_ArenaBytesUsed;
+
+            // If the frame spilled into more than one arena block, replace them with a single block
+            // that fits the whole frame, so later frames stay in one block
+            if (g_ArenaBlockIndex > 0)
+            {
+                size_t total = 0;
+                for (const ArenaBlock &block : g_ArenaBlocks)
+                {
+                    total += block.size;
+                }
+                g_ArenaBlocks.clear();
+                g_ArenaBlocks.push_back({std::unique_ptr<char[]>(new char[total]), total});
+            }
+            g_ArenaBlockIndex = 0;
+            g_ArenaOffset = 0;
+            g_ArenaBytesUsed = 0;
+        }
+
+        void TrimAllocator()
+        {
+            g_ArenaBlocks.clear();
+            g_ArenaBlocks.shrink_to_fit();
+            g_ArenaBlockIndex = 0;
+            g_ArenaOffset = 0;
+
+            std::lock_guard<std::mutex> lock(g_PoolMutex);
+            ReturnCacheLocked(t_Cache);
+            ReleaseFreeSlabsLocked();
+        }
+
+        size_t GetResidentMemoryBytes()
+        {
+#if defined(_WIN32)
+            PROCESS_MEMORY_COUNTERS counters{};
+            if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            {
+                return counters.WorkingSetSize;
+            }
+            return 0;
+#elif defined(__APPLE__)
+            mach_task_basic_info_data_t info{};
+            mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+            if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+            {
+                return info.resident_size;
+            }
+            return 0;
+#else
+            // Second field of statm: resident pages
+            unsigned long size = 0, resident = 0;
+            FILE *statm = std::fopen("/proc/self/statm", "r");
+            if (!statm)
+            {
+                return 0;
+            }
+            const bool read = std::fscanf(statm, "%lu %lu", &size, &resident) == 2;
+            std::fclose(statm);
+            return read ? static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#endif
+        }
+
+        AllocatorStats GetAllocatorStats()
+        {
+            return g_LastFrameStats;
+        }
+
+        void *FrameAlloc(size_t size, size_t alignment)
+        {
+            for (;;)
+            {
+                if (g_ArenaBlockIndex < g_ArenaBlocks.size())
+                {
+                    ArenaBlock &block = g_ArenaBlocks[g_ArenaBlockIndex];
+                    uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+                    uintptr_t aligned = (base + g_ArenaOffset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+                    if (aligned + size <= base + block.size)
+                    {
+                        g_ArenaOffset = aligned + size - base;
+                        g_ArenaBytesUsed += size;
+                        return reinterpret_cast<void *>(aligned);
+                    }
+
+                    // Continue in the next block
+                    ++g_ArenaBlockIndex;
+                    g_ArenaOffset = 0;
+                    continue;
+                }
+
+                size_t blockSize = std::max(kArenaBlockSize, size + alignment);
+                g_ArenaBlocks.push_back({std::unique_ptr<char[]>(new char[blockSize]), blockSize});
+            }
+        }
+
+        const char *FrameFormat(const char *fmt, ...)
+        {
+            va_list args;
+            va_start(args, fmt);
+            va_list argsCopy;
+            va_copy(argsCopy, args);
+            int length = std::vsnprintf(nullptr, 0, fmt, argsCopy);
+            va_end(argsCopy);
+
+            if (length < 0)
+            {
+                va_end(args);
+                return "";
+            }
+
+            char *text = static_cast<char *>(FrameAlloc(static_cast<size_t>(length) + 1, 1));
+            std::vsnprintf(text, static_cast<size_t>(length) + 1, fmt, args);
+            va_end(args);
+            return text;
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
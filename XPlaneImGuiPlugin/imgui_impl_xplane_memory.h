@@ -0,0 +1,66 @@
+#ifndef IMGUI_IMPL_XPLANE_MEMORY_H
+#define IMGUI_IMPL_XPLANE_MEMORY_H
+
+// ImGui
+#include "imgui.h"
+
+// Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // ImGui memory
+        // Init() routes every ImGui allocation through a size-class pool: small blocks come from
+        // per-thread free lists and only a cache refill or spill touches the shared pool's lock,
+        // so ImGui never contends with X-Plane's threads for the CRT heap. Larger blocks go to malloc.
+        // The pool lives as long as the plugin binary, since static ImVectors are freed after Shutdown().
+
+        // Allocation counters for one frame
+        struct AllocatorStats
+        {
+            uint64_t allocations = 0;     // ImGui allocations made during the frame
+            uint64_t frees = 0;           // ImGui frees made during the frame
+            uint64_t bytesAllocated = 0;  // Bytes requested during the frame
+            size_t bytesInUse = 0;        // Live ImGui bytes at the end of the frame
+            size_t peakBytesInUse = 0;    // Highest live byte count during the frame
+            size_t poolBytesReserved = 0; // Memory the pool holds for small blocks
+            size_t frameArenaBytes = 0;   // FrameAlloc bytes used during the frame
+        };
+
+        // Counters for the last completed frame
+        AllocatorStats GetAllocatorStats();
+
+        // Per-frame linear arena for temporary strings and arrays built by render callbacks.
+        // Allocation is a pointer bump; everything is released at once in BeginFrame(), so pointers
+        // must not be kept past the frame. Main (render) thread only.
+        void *FrameAlloc(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        // Uninitialized array of count elements from the frame arena. No destructors run on reset.
+        template <typename T>
+        T *FrameAllocArray(size_t count)
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "FrameAllocArray elements are never destroyed");
+            return static_cast<T *>(FrameAlloc(sizeof(T) * count, alignof(T)));
+        }
+
+        // printf into the frame arena; the returned string is valid until the next frame
+        const char *FrameFormat(const char *fmt, ...) IM_FMTARGS(1);
+
+        // Resident set size of the X-Plane process in bytes, 0 where it cannot be read
+        size_t GetResidentMemoryBytes();
+
+        // Used by imgui_impl_xplane.cpp
+        void InstallAllocator();    // Before the ImGui context is created
+        void BeginFrameAllocator(); // At the start of each frame: closes the frame's stats and resets the arena
+        void TrimAllocator();       // Between frames: frees the frame arena and the pool slabs with no block in use
+                                    // or cached by another thread
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_MEMORY_H
@@ -0,0 +1,519 @@
+#include "imgui_impl_xplane_table.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+// Project-specific headers
+#include "XPlaneProfiler.h"
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            constexpr double kResortInterval = 0.1; // Seconds between views while rows keep changing
+            constexpr size_t kMinIncrementalRows = 1024;
+
+            // Above this many changed rows a full sort is as cheap as removing and merging them
+            size_t IncrementalLimit(uint32_t rowCount)
+            {
+                return std::max(kMinIncrementalRows, static_cast<size_t>(rowCount / 64));
+            }
+
+            // Three-way comparison of two numbers for a sort in the given direction. NaN comes after
+            // every number in both directions and ties with another NaN, which keeps the order a
+            // strict weak ordering for std::sort and std::merge.
+            int CompareNumbers(double a, double b, bool ascending)
+            {
+                const bool aNan = std::isnan(a), bNan = std::isnan(b);
+                if (aNan || bNan)
+                {
+                    return aNan == bNan ? 0 : (aNan ? 1 : -1);
+                }
+                if (a < b)
+                {
+                    return ascending ? -1 : 1;
+                }
+                if (b < a)
+                {
+                    return ascending ? 1 : -1;
+                }
+                return 0;
+            }
+
+            template <typename T>
+            std::shared_ptr<T> ExchangeShared(std::shared_ptr<T> &target, std::shared_ptr<T> value)
+            {
+                return std::atomic_exchange(&target, std::move(value));
+            }
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+            template <typename T>
+            std::shared_ptr<T> ExchangeShared(std::atomic<std::shared_ptr<T>> &target, std::shared_ptr<T> value)
+            {
+                return target.exchange(std::move(value));
+            }
+#endif
+
+            std::string ToLower(const std::string &value)
+            {
+                std::string lower(value);
+                for (char &c : lower)
+                {
+                    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                }
+                return lower;
+            }
+
+            bool ContainsLower(const std::string &haystack, const std::string &lowerNeedle)
+            {
+                return std::search(haystack.begin(), haystack.end(), lowerNeedle.begin(), lowerNeedle.end(),
+                                   [](char a, char b)
+                                   { return std::tolower(static_cast<unsigned char>(a)) == b; }) != haystack.end();
+            }
+        } // namespace
+
+        DataTable::DataTable(std::vector<DataTableColumn> columns)
+            : m_columns(std::move(columns)), m_chunks(m_columns.size())
+        {
+            m_worker = std::thread(&DataTable::workerMain, this);
+        }
+
+        DataTable::~DataTable()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_one();
+            m_worker.join();
+        }
+
+        uint32_t DataTable::appendRow()
+        {
+            const uint32_t row = m_rowCount;
+            const bool newChunk = (row & (kChunkRows - 1)) == 0;
+            for (int column = 0; column < static_cast<int>(m_columns.size()); ++column)
+            {
+                if (newChunk)
+                {
+                    m_chunks[column].push_back(std::make_shared<Chunk>());
+                    m_chunks[column].back()->createdAt = m_submitted;
+                }
+                Chunk &chunk = newChunk ? *m_chunks[column].back() : writableChunk(column, row);
+                if (m_columns[column].type == DataTableColumnType::Number)
+                {
+                    chunk.numbers.push_back(0.0);
+                }
+                else
+                {
+                    chunk.texts.emplace_back();
+                }
+            }
+            ++m_rowCount;
+            markDirty(row);
+            return row;
+        }
+
+        void DataTable::setNumber(uint32_t row, int column, double value)
+        {
+            IM_ASSERT(row < m_rowCount && m_columns[column].type == DataTableColumnType::Number);
+            double &cell = writableChunk(column, row).numbers[row & (kChunkRows - 1)];
+            if (cell != value)
+            {
+                cell = value;
+                markDirty(row);
+            }
+        }
+
+        void DataTable::setText(uint32_t row, int column, const std::string &value)
+        {
+            IM_ASSERT(row < m_rowCount && m_columns[column].type == DataTableColumnType::Text);
+            std::string &cell = writableChunk(column, row).texts[row & (kChunkRows - 1)];
+            if (cell != value)
+            {
+                cell = value;
+                markDirty(row);
+            }
+        }
+
+        double DataTable::number(uint32_t row, int column) const
+        {
+            return m_chunks[column][row >> kChunkShift]->numbers[row & (kChunkRows - 1)];
+        }
+
+        const std::string &DataTable::text(uint32_t row, int column) const
+        {
+            return m_chunks[column][row >> kChunkShift]->texts[row & (kChunkRows - 1)];
+        }
+
+        void DataTable::clear()
+        {
+            for (auto &chunks : m_chunks)
+            {
+                chunks.clear();
+            }
+            m_rowCount = 0;
+            ++m_generation;
+            m_view.reset();
+            m_dirty.clear();
+            m_fullSortNeeded = true;
+            m_selectedRow = kNoRow;
+            m_stats.shownRows = 0;
+        }
+
+        void DataTable::setFilter(const std::string &filter)
+        {
+            std::string lower = ToLower(filter);
+            if (lower != m_filter)
+            {
+                m_filter = std::move(lower);
+                m_fullSortNeeded = true;
+            }
+        }
+
+        DataTable::Chunk &DataTable::writableChunk(int column, uint32_t row)
+        {
+            // A chunk made after the last submit is in no snapshot. An older one may be read by the
+            // worker until it reports the job's snapshot dropped under m_mutex; a use count of one
+            // does not order our write after its reads, so until then copy instead.
+            std::shared_ptr<Chunk> &chunk = m_chunks[column][row >> kChunkShift];
+            if (chunk->createdAt < m_submitted && !snapshotsReleased())
+            {
+                chunk = std::make_shared<Chunk>(*chunk);
+                chunk->createdAt = m_submitted;
+            }
+            return *chunk;
+        }
+
+        bool DataTable::snapshotsReleased()
+        {
+            if (m_releasedSeen != m_submitted)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_releasedSeen = m_released;
+            }
+            return m_releasedSeen == m_submitted;
+        }
+
+        void DataTable::markDirty(uint32_t row)
+        {
+            if (m_fullSortNeeded)
+            {
+                return;
+            }
+            m_dirty.push_back(row);
+            if (m_dirty.size() > IncrementalLimit(m_rowCount))
+            {
+                m_dirty.clear();
+                m_fullSortNeeded = true;
+            }
+        }
+
+        void DataTable::draw(const char *id, const ImVec2 &size)
+        {
+            // Pick up the view the worker finished, if any
+            if (std::shared_ptr<const View> ready = ExchangeShared(m_ready, std::shared_ptr<const View>()))
+            {
+                m_jobInFlight = false;
+                if (ready->generation == m_generation)
+                {
+                    m_view = std::move(ready);
+                    m_stats.shownRows = m_view->rows.size();
+                    m_stats.lastSortMs = m_view->ms;
+                    m_stats.lastIncremental = m_view->incremental;
+                    ++(m_view->incremental ? m_stats.incrementalSorts : m_stats.fullSorts);
+                }
+            }
+
+            const int columnCount = static_cast<int>(m_columns.size());
+            const ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_SortMulti | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg |
+                                          ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Hideable;
+            if (columnCount == 0 || !ImGui::BeginTable(id, columnCount, flags, size))
+            {
+                return;
+            }
+
+            ImGui::TableSetupScrollFreeze(0, 1);
+            for (const DataTableColumn &column : m_columns)
+            {
+                ImGui::TableSetupColumn(column.name.c_str(), column.width > 0.0f ? ImGuiTableColumnFlags_WidthFixed : ImGuiTableColumnFlags_WidthStretch, column.width);
+            }
+            ImGui::TableHeadersRow();
+
+            if (ImGuiTableSortSpecs *specs = ImGui::TableGetSortSpecs())
+            {
+                if (specs->SpecsDirty)
+                {
+                    m_sort.clear();
+                    for (int i = 0; i < specs->SpecsCount; ++i)
+                    {
+                        m_sort.push_back({specs->Specs[i].ColumnIndex, specs->Specs[i].SortDirection != ImGuiSortDirection_Descending});
+                    }
+                    specs->SpecsDirty = false;
+                    m_fullSortNeeded = true;
+                }
+            }
+
+            // One job at a time: a header click while sorting waits for the running job, then
+            // supersedes its view
+            if (!m_jobInFlight && (m_fullSortNeeded || (!m_dirty.empty() && ImGui::GetTime() - m_lastSubmitTime >= kResortInterval)))
+            {
+                submit();
+            }
+
+            if (m_view)
+            {
+                const std::vector<uint32_t> &rows = m_view->rows;
+                ImGuiListClipper clipper;
+                clipper.Begin(static_cast<int>(rows.size()));
+                while (clipper.Step())
+                {
+                    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+                    {
+                        const uint32_t row = rows[i];
+                        ImGui::TableNextRow();
+                        for (int column = 0; column < columnCount; ++column)
+                        {
+                            ImGui::TableSetColumnIndex(column);
+                            const DataTableColumn &info = m_columns[column];
+                            if (column == 0)
+                            {
+                                // The first cell carries the selection for the whole row. The label is
+                                // drawn separately, so "##" in user data neither hides text nor changes the ID.
+                                ImGui::PushID(static_cast<int>(row));
+                                if (ImGui::Selectable("##row", row == m_selectedRow, ImGuiSelectableFlags_SpanAllColumns))
+                                {
+                                    m_selectedRow = row;
+                                }
+                                ImGui::PopID();
+                                ImGui::SameLine();
+                            }
+                            if (info.type == DataTableColumnType::Number)
+                            {
+                                ImGui::Text(info.format, number(row, column));
+                            }
+                            else
+                            {
+                                ImGui::TextUnformatted(text(row, column).c_str());
+                            }
+                        }
+                    }
+                }
+            }
+
+            ImGui::EndTable();
+        }
+
+        void DataTable::submit()
+        {
+            auto job = std::make_unique<Job>();
+            job->snapshot.resize(m_chunks.size());
+            for (size_t column = 0; column < m_chunks.size(); ++column)
+            {
+                job->snapshot[column].assign(m_chunks[column].begin(), m_chunks[column].end());
+            }
+            job->rowCount = m_rowCount;
+            job->sort = m_sort;
+            job->filter = m_filter;
+            job->generation = m_generation;
+            job->sequence = ++m_submitted;
+
+            const bool incremental = !m_fullSortNeeded && m_view && m_view->sort == m_sort && m_view->filter == m_filter &&
+                                     m_dirty.size() <= IncrementalLimit(m_rowCount);
+            if (incremental)
+            {
+                job->base = m_view;
+                job->dirty.swap(m_dirty);
+            }
+            m_dirty.clear();
+            m_fullSortNeeded = false;
+            m_jobInFlight = true;
+            m_lastSubmitTime = ImGui::GetTime();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_job = std::move(job);
+            }
+            m_wake.notify_one();
+        }
+
+        void DataTable::workerMain()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                m_wake.wait(lock, [this]
+                            { return m_stop || m_job; });
+                if (m_stop)
+                {
+                    return;
+                }
+                std::unique_ptr<Job> job = std::move(m_job);
+                lock.unlock();
+
+                auto view = std::make_shared<View>(runJob(*job));
+                // Drop the snapshot and say so before publishing, so edits after the view lands write in place
+                const uint64_t sequence = job->sequence;
+                job.reset();
+                lock.lock();
+                m_released = sequence;
+                lock.unlock();
+                ExchangeShared(m_ready, std::shared_ptr<const View>(std::move(view)));
+
+                lock.lock();
+            }
+        }
+
+        DataTable::View DataTable::runJob(const Job &job) const
+        {
+            XP_PROFILE_SCOPE("DataTable::runJob");
+            const auto start = std::chrono::steady_clock::now();
+            const Snapshot &snapshot = job.snapshot;
+
+            auto numberAt = [&snapshot](int column, uint32_t row)
+            {
+                return snapshot[column][row >> kChunkShift]->numbers[row & (kChunkRows - 1)];
+            };
+            auto textAt = [&snapshot](int column, uint32_t row) -> const std::string &
+            {
+                return snapshot[column][row >> kChunkShift]->texts[row & (kChunkRows - 1)];
+            };
+
+            std::vector<int> textColumns;
+            for (int column = 0; column < static_cast<int>(m_columns.size()); ++column)
+            {
+                if (m_columns[column].type == DataTableColumnType::Text)
+                {
+                    textColumns.push_back(column);
+                }
+            }
+            auto matches = [&](uint32_t row)
+            {
+                if (job.filter.empty())
+                {
+                    return true;
+                }
+                for (int column : textColumns)
+                {
+                    if (ContainsLower(textAt(column, row), job.filter))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            // Ties fall back to the row index, so the order is total and a merge agrees with a sort
+            auto less = [&](uint32_t a, uint32_t b)
+            {
+                for (const SortKey &key : job.sort)
+                {
+                    if (m_columns[key.column].type == DataTableColumnType::Number)
+                    {
+                        const int order = CompareNumbers(numberAt(key.column, a), numberAt(key.column, b), key.ascending);
+                        if (order != 0)
+                        {
+                            return order < 0;
+                        }
+                    }
+                    else
+                    {
+                        const int order = textAt(key.column, a).compare(textAt(key.column, b));
+                        if (order != 0)
+                        {
+                            return key.ascending ? order < 0 : order > 0;
+                        }
+                    }
+                }
+                return a < b;
+            };
+
+            View view;
+            view.sort = job.sort;
+            view.filter = job.filter;
+            view.rowCount = job.rowCount;
+            view.generation = job.generation;
+
+            if (job.base)
+            {
+                // Take the changed rows out of the previous order, sort just them and merge them back
+                std::vector<uint8_t> changed(job.rowCount, 0);
+                std::vector<uint32_t> fresh;
+                for (uint32_t row : job.dirty)
+                {
+                    if (!changed[row])
+                    {
+                        changed[row] = 1;
+                        if (matches(row))
+                        {
+                            fresh.push_back(row);
+                        }
+                    }
+                }
+                std::sort(fresh.begin(), fresh.end(), less);
+
+                std::vector<uint32_t> kept;
+                kept.reserve(job.base->rows.size());
+                for (uint32_t row : job.base->rows)
+                {
+                    if (!changed[row])
+                    {
+                        kept.push_back(row);
+                    }
+                }
+
+                view.rows.resize(kept.size() + fresh.size());
+                std::merge(kept.begin(), kept.end(), fresh.begin(), fresh.end(), view.rows.begin(), less);
+                view.incremental = true;
+            }
+            else
+            {
+                view.rows.reserve(job.rowCount);
+                for (uint32_t row = 0; row < job.rowCount; ++row)
+                {
+                    if (matches(row))
+                    {
+                        view.rows.push_back(row);
+                    }
+                }
+
+                if (job.sort.size() == 1 && m_columns[job.sort[0].column].type == DataTableColumnType::Number)
+                {
+                    // The common case: sort (value, row) pairs, which keeps the keys next to each
+                    // other instead of chasing them through the chunks on every comparison
+                    const SortKey key = job.sort[0];
+                    std::vector<std::pair<double, uint32_t>> keyed;
+                    keyed.reserve(view.rows.size());
+                    for (uint32_t row : view.rows)
+                    {
+                        keyed.emplace_back(numberAt(key.column, row), row);
+                    }
+                    std::sort(keyed.begin(), keyed.end(), [&key](const std::pair<double, uint32_t> &a, const std::pair<double, uint32_t> &b)
+                              {
+                                  const int order = CompareNumbers(a.first, b.first, key.ascending);
+                                  return order != 0 ? order < 0 : a.second < b.second;
+                              });
+                    for (size_t i = 0; i < keyed.size(); ++i)
+                    {
+                        view.rows[i] = keyed[i].second;
+                    }
+                }
+                else if (!job.sort.empty())
+                {
+                    std::sort(view.rows.begin(), view.rows.end(), less);
+                }
+            }
+
+            view.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            return view;
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
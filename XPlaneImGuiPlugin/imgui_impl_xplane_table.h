@@ -0,0 +1,182 @@
+#ifndef IMGUI_IMPL_XPLANE_TABLE_H
+#define IMGUI_IMPL_XPLANE_TABLE_H
+
+// ImGui
+#include "imgui.h"
+
+// Standard Library
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // Data Table
+        // A table for render callbacks that stays responsive with millions of rows:
+        //   - values are stored column by column in chunks of 64k rows;
+        //   - only the rows in view are submitted, through ImGuiListClipper;
+        //   - sorting (from the column headers) and filtering run on the table's worker thread and
+        //     produce a view, a list of row indices, that the render thread picks up with one
+        //     atomic pointer swap. The previous view stays on screen meanwhile;
+        //   - when only a few rows changed since the last view, the worker removes them from it,
+        //     sorts just those and merges them back: O(n + k log k) instead of O(n log n).
+        // The worker reads a snapshot of the chunks: writing to a chunk it still holds copies the
+        // chunk first, so the render thread never waits for it. Main thread only.
+        //
+        //     static ImGui::XP::DataTable g_Navaids({{"Ident", ImGui::XP::DataTableColumnType::Text},
+        //                                            {"Frequency", ImGui::XP::DataTableColumnType::Number, "%.2f"}});
+        //     g_Navaids.draw("navaids");
+
+        enum class DataTableColumnType
+        {
+            Number,
+            Text
+        };
+
+        struct DataTableColumn
+        {
+            std::string name;
+            DataTableColumnType type = DataTableColumnType::Number;
+            const char *format = "%g"; // Numbers; a string literal
+            float width = 0.0f;        // 0: stretch
+        };
+
+        struct DataTableStats
+        {
+            size_t shownRows = 0; // Rows in the current view
+            double lastSortMs = 0.0;
+            bool lastIncremental = false;
+            uint64_t fullSorts = 0;
+            uint64_t incrementalSorts = 0;
+        };
+
+        class DataTable
+        {
+        public:
+            using Stats = DataTableStats;
+            static constexpr uint32_t kNoRow = 0xFFFFFFFFu;
+
+            explicit DataTable(std::vector<DataTableColumn> columns);
+            ~DataTable();
+
+            DataTable(const DataTable &) = delete;
+            DataTable &operator=(const DataTable &) = delete;
+
+            // Rows. New rows hold 0 and empty strings; they appear once the next view is ready.
+            uint32_t appendRow();
+            void setNumber(uint32_t row, int column, double value);
+            void setText(uint32_t row, int column, const std::string &value);
+            double number(uint32_t row, int column) const;
+            const std::string &text(uint32_t row, int column) const;
+            size_t rowCount() const { return m_rowCount; }
+            void clear();
+
+            // Case-insensitive substring of any text column; empty shows every row
+            void setFilter(const std::string &filter);
+
+            // Draws the table as an item of the current window, filling the remaining content region
+            // if size is zero. Clicking a row selects it.
+            void draw(const char *id, const ImVec2 &size = ImVec2(0.0f, 0.0f));
+
+            uint32_t selectedRow() const { return m_selectedRow; }
+            bool busy() const { return m_jobInFlight; } // A sort or filter is running
+            const Stats &stats() const { return m_stats; }
+
+        private:
+            static constexpr uint32_t kChunkShift = 16;
+            static constexpr uint32_t kChunkRows = 1u << kChunkShift;
+
+            // Rows [n * kChunkRows, (n + 1) * kChunkRows) of one column
+            struct Chunk
+            {
+                std::vector<double> numbers;
+                std::vector<std::string> texts;
+                uint64_t createdAt = 0; // m_submitted when made: snapshots of later jobs may share it
+            };
+            using Snapshot = std::vector<std::vector<std::shared_ptr<const Chunk>>>; // [column][chunk]
+
+            struct SortKey
+            {
+                int column;
+                bool ascending;
+
+                bool operator==(const SortKey &other) const { return column == other.column && ascending == other.ascending; }
+            };
+
+            // Rows to show, in order
+            struct View
+            {
+                std::vector<uint32_t> rows;
+                std::vector<SortKey> sort;
+                std::string filter;
+                uint32_t rowCount = 0;   // Rows of the snapshot it was built from
+                uint64_t generation = 0; // m_generation when submitted
+                double ms = 0.0;
+                bool incremental = false;
+            };
+
+            struct Job
+            {
+                Snapshot snapshot;
+                uint32_t rowCount = 0;
+                std::vector<SortKey> sort;
+                std::string filter;
+                std::shared_ptr<const View> base; // For an incremental job
+                std::vector<uint32_t> dirty;      // Rows changed or added since base
+                uint64_t generation = 0;
+                uint64_t sequence = 0; // m_submitted after this job
+            };
+
+            Chunk &writableChunk(int column, uint32_t row);
+            void markDirty(uint32_t row);
+            bool snapshotsReleased();
+            void submit();
+            void workerMain();
+            View runJob(const Job &job) const;
+
+            std::vector<DataTableColumn> m_columns;
+            std::vector<std::vector<std::shared_ptr<Chunk>>> m_chunks; // [column][chunk]
+            uint32_t m_rowCount = 0;
+            uint64_t m_generation = 0; // Bumped by clear(), so views of the old rows are dropped
+
+            // Main thread
+            std::shared_ptr<const View> m_view;
+            std::vector<SortKey> m_sort;
+            std::string m_filter;
+            std::vector<uint32_t> m_dirty;
+            bool m_fullSortNeeded = true;
+            bool m_jobInFlight = false;
+            double m_lastSubmitTime = -1.0;
+            uint32_t m_selectedRow = kNoRow;
+            uint64_t m_submitted = 0;    // Jobs submitted
+            uint64_t m_releasedSeen = 0; // Last m_released read under the lock
+            Stats m_stats;
+
+            // Shared with the worker
+            std::mutex m_mutex;
+            std::condition_variable m_wake;
+            std::unique_ptr<Job> m_job;         // Waiting for the worker
+            uint64_t m_released = 0;            // Sequence of the last job whose snapshot the worker dropped
+            // Swapped atomically. The free std::atomic_* functions on shared_ptr are deprecated in C++20,
+            // which has std::atomic<std::shared_ptr> instead; ExchangeShared() in the .cpp takes either.
+#if defined(__cpp_lib_atomic_shared_ptr)
+            std::atomic<std::shared_ptr<const View>> m_ready;
+#else
+            std::shared_ptr<const View> m_ready;
+#endif
+            bool m_stop = false;
+            std::thread m_worker;
+        };
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_TABLE_H
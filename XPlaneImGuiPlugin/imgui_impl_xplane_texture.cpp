@@ -0,0 +1,670 @@
+#include "imgui_impl_xplane_texture.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+// Optional PNG/JPEG decoding (CMake STB_IMAGE_DIR)
+#ifdef IMGUI_XP_STB_IMAGE
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#define STBI_ONLY_JPEG
+#include "stb_image.h"
+#endif
+
+// Project-specific headers
+#include "XPlaneLog.h"
+#include "XPlaneMetrics.h"
+#include "XPlaneProfiler.h"
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            ImageDecoder g_ImageDecoder;
+
+            // DDS
+
+            constexpr uint32_t FourCC(char a, char b, char c, char d)
+            {
+                return static_cast<uint32_t>(static_cast<unsigned char>(a)) | (static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8) |
+                       (static_cast<uint32_t>(static_cast<unsigned char>(c)) << 16) | (static_cast<uint32_t>(static_cast<unsigned char>(d)) << 24);
+            }
+
+            constexpr uint32_t kDdsMagic = FourCC('D', 'D', 'S', ' ');
+            constexpr size_t kDdsHeaderSize = 4 + 124; // Magic, DDS_HEADER
+            constexpr uint32_t kDdpfAlphaPixels = 0x1;
+            constexpr uint32_t kDdpfFourCC = 0x4;
+            constexpr uint32_t kDdpfRgb = 0x40;
+
+            uint32_t ReadU32(const unsigned char *p)
+            {
+                return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+            }
+
+            uint16_t ReadU16(const unsigned char *p)
+            {
+                return static_cast<uint16_t>(p[0] | (p[1] << 8));
+            }
+
+            void Rgb565ToRgba(uint16_t c, unsigned char *out)
+            {
+                const unsigned r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+                out[0] = static_cast<unsigned char>((r << 3) | (r >> 2));
+                out[1] = static_cast<unsigned char>((g << 2) | (g >> 4));
+                out[2] = static_cast<unsigned char>((b << 3) | (b >> 2));
+                out[3] = 255;
+            }
+
+            // Color part of a BC1/2/3 block into a 4x4 RGBA tile. BC2 and BC3 always use four colors.
+            void DecodeColorBlock(const unsigned char *block, bool allowTransparent, unsigned char tile[16][4])
+            {
+                const uint16_t c0 = ReadU16(block), c1 = ReadU16(block + 2);
+                unsigned char colors[4][4];
+                Rgb565ToRgba(c0, colors[0]);
+                Rgb565ToRgba(c1, colors[1]);
+                for (int i = 0; i < 3; ++i)
+                {
+                    if (c0 > c1 || !allowTransparent)
+                    {
+                        colors[2][i] = static_cast<unsigned char>((2 * colors[0][i] + colors[1][i]) / 3);
+                        colors[3][i] = static_cast<unsigned char>((colors[0][i] + 2 * colors[1][i]) / 3);
+                    }
+                    else
+                    {
+                        colors[2][i] = static_cast<unsigned char>((colors[0][i] + colors[1][i]) / 2);
+                        colors[3][i] = 0;
+                    }
+                }
+                colors[2][3] = 255;
+                colors[3][3] = (c0 > c1 || !allowTransparent) ? 255 : 0;
+
+                const uint32_t indices = ReadU32(block + 4);
+                for (int i = 0; i < 16; ++i)
+                {
+                    std::memcpy(tile[i], colors[(indices >> (2 * i)) & 3], 4);
+                }
+            }
+
+            // BC3 interpolated alpha
+            void DecodeAlphaBlock(const unsigned char *block, unsigned char tile[16][4])
+            {
+                const unsigned a0 = block[0], a1 = block[1];
+                unsigned char alphas[8] = {static_cast<unsigned char>(a0), static_cast<unsigned char>(a1)};
+                if (a0 > a1)
+                {
+                    for (unsigned i = 1; i < 7; ++i)
+                    {
+                        alphas[i + 1] = static_cast<unsigned char>(((7 - i) * a0 + i * a1) / 7);
+                    }
+                }
+                else
+                {
+                    for (unsigned i = 1; i < 5; ++i)
+                    {
+                        alphas[i + 1] = static_cast<unsigned char>(((5 - i) * a0 + i * a1) / 5);
+                    }
+                    alphas[6] = 0;
+                    alphas[7] = 255;
+                }
+
+                uint64_t indices = 0;
+                for (int i = 0; i < 6; ++i)
+                {
+                    indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+                }
+                for (int i = 0; i < 16; ++i)
+                {
+                    tile[i][3] = alphas[(indices >> (3 * i)) & 7];
+                }
+            }
+
+            bool DecodeBlockCompressed(const unsigned char *data, size_t size, int width, int height, uint32_t fourCC, DecodedImage &out)
+            {
+                const size_t blockBytes = fourCC == FourCC('D', 'X', 'T', '1') ? 8 : 16;
+                const int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+                if (size < static_cast<size_t>(blocksX) * blocksY * blockBytes)
+                {
+                    return false;
+                }
+
+                unsigned char tile[16][4];
+                for (int by = 0; by < blocksY; ++by)
+                {
+                    for (int bx = 0; bx < blocksX; ++bx)
+                    {
+                        const unsigned char *block = data + (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+                        if (fourCC == FourCC('D', 'X', 'T', '1'))
+                        {
+                            DecodeColorBlock(block, true, tile);
+                        }
+                        else if (fourCC == FourCC('D', 'X', 'T', '3'))
+                        {
+                            DecodeColorBlock(block + 8, false, tile);
+                            for (int i = 0; i < 16; ++i)
+                            {
+                                const unsigned nibble = (block[i / 2] >> (4 * (i & 1))) & 0xF;
+                                tile[i][3] = static_cast<unsigned char>(nibble * 17);
+                            }
+                        }
+                        else
+                        {
+                            DecodeColorBlock(block + 8, false, tile);
+                            DecodeAlphaBlock(block, tile);
+                        }
+
+                        // Blocks on the right and bottom edges may hang over the image
+                        for (int y = 0; y < 4 && by * 4 + y < height; ++y)
+                        {
+                            for (int x = 0; x < 4 && bx * 4 + x < width; ++x)
+                            {
+                                std::memcpy(&out.pixels[(static_cast<size_t>(by * 4 + y) * width + bx * 4 + x) * 4], tile[y * 4 + x], 4);
+                            }
+                        }
+                    }
+                }
+                return true;
+            }
+
+            // Position of the lowest set bit, for the channel masks
+            int MaskShift(uint32_t mask)
+            {
+                int shift = 0;
+                while (mask && !(mask & 1))
+                {
+                    mask >>= 1;
+                    ++shift;
+                }
+                return shift;
+            }
+
+            unsigned char Channel(uint32_t pixel, uint32_t mask)
+            {
+                if (!mask)
+                {
+                    return 255;
+                }
+                const uint32_t value = (pixel & mask) >> MaskShift(mask);
+                const uint32_t max = mask >> MaskShift(mask);
+                return static_cast<unsigned char>(max == 255 ? value : value * 255 / max);
+            }
+
+            bool DecodeUncompressed(const unsigned char *data, size_t size, int width, int height, const unsigned char *format, DecodedImage &out)
+            {
+                const uint32_t flags = ReadU32(format + 4);
+                const uint32_t bitCount = ReadU32(format + 12);
+                const uint32_t rMask = ReadU32(format + 16), gMask = ReadU32(format + 20), bMask = ReadU32(format + 24);
+                const uint32_t aMask = (flags & kDdpfAlphaPixels) ? ReadU32(format + 28) : 0;
+                if (bitCount != 24 && bitCount != 32)
+                {
+                    return false;
+                }
+
+                const size_t bytesPerPixel = bitCount / 8;
+                if (size < static_cast<size_t>(width) * height * bytesPerPixel)
+                {
+                    return false;
+                }
+                for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i)
+                {
+                    const unsigned char *p = data + i * bytesPerPixel;
+                    const uint32_t pixel = bytesPerPixel == 4 ? ReadU32(p) : (static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16));
+                    unsigned char *o = &out.pixels[i * 4];
+                    o[0] = Channel(pixel, rMask);
+                    o[1] = Channel(pixel, gMask);
+                    o[2] = Channel(pixel, bMask);
+                    o[3] = Channel(pixel, aMask);
+                }
+                return true;
+            }
+
+            // Top mip level only; DX10 extended headers are not supported
+            bool DecodeDds(const unsigned char *data, size_t size, DecodedImage &out, std::string *error)
+            {
+                if (size < kDdsHeaderSize)
+                {
+                    *error = "truncated DDS header";
+                    return false;
+                }
+                const unsigned char *header = data + 4;
+                const int height = static_cast<int>(ReadU32(header + 8));
+                const int width = static_cast<int>(ReadU32(header + 12));
+                const unsigned char *format = header + 72; // DDS_PIXELFORMAT
+                const uint32_t flags = ReadU32(format + 4);
+                const uint32_t fourCC = ReadU32(format + 8);
+                if (width <= 0 || height <= 0 || width > 16384 || height > 16384)
+                {
+                    *error = "bad DDS size";
+                    return false;
+                }
+
+                out.width = width;
+                out.height = height;
+                out.pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+                const unsigned char *pixels = data + kDdsHeaderSize;
+                const size_t pixelBytes = size - kDdsHeaderSize;
+
+                bool decoded = false;
+                if (flags & kDdpfFourCC)
+                {
+                    if (fourCC == FourCC('D', 'X', 'T', '1') || fourCC == FourCC('D', 'X', 'T', '3') || fourCC == FourCC('D', 'X', 'T', '5'))
+                    {
+                        decoded = DecodeBlockCompressed(pixels, pixelBytes, width, height, fourCC, out);
+                    }
+                    else
+                    {
+                        *error = "unsupported DDS compression";
+                        return false;
+                    }
+                }
+                else if (flags & kDdpfRgb)
+                {
+                    decoded = DecodeUncompressed(pixels, pixelBytes, width, height, format, out);
+                }
+                if (!decoded)
+                {
+                    *error = "unsupported or truncated DDS data";
+                }
+                return decoded;
+            }
+
+            // Backend cache
+
+            std::string g_BaseFolder;
+            std::unique_ptr<TextureUploader> g_Uploader;
+            std::unique_ptr<TextureCache> g_Cache;
+            int g_MetricsCollector = 0;
+
+            void CollectTextureMetrics()
+            {
+                static XPlaneMetrics::Gauge &residentBytes = XPlaneMetrics::gauge("imgui.textures.resident_bytes", "Bytes of resident ImGui::XP textures");
+                static XPlaneMetrics::Gauge &resident = XPlaneMetrics::gauge("imgui.textures.resident", "Resident ImGui::XP textures");
+                static XPlaneMetrics::Gauge &queued = XPlaneMetrics::gauge("imgui.textures.queued", "Texture files waiting to be decoded");
+                static XPlaneMetrics::Counter &uploads = XPlaneMetrics::counter("imgui.textures.uploads", "Textures uploaded");
+                static XPlaneMetrics::Counter &evictions = XPlaneMetrics::counter("imgui.textures.evictions", "Textures evicted over the VRAM budget");
+                if (g_Cache)
+                {
+                    const TextureCache::Stats stats = g_Cache->stats();
+                    residentBytes.set(static_cast<double>(stats.residentBytes));
+                    resident.set(static_cast<double>(stats.residentCount));
+                    queued.set(static_cast<double>(stats.queuedDecodes));
+                    uploads.syncTotal(stats.uploads);
+                    evictions.syncTotal(stats.evictions);
+                }
+            }
+
+            bool ReadWholeFile(const std::string &path, std::vector<unsigned char> &out)
+            {
+                std::ifstream in(path, std::ios::binary);
+                if (!in)
+                {
+                    return false;
+                }
+                out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                return true;
+            }
+        } // namespace
+
+        bool DecodeImage(const unsigned char *data, size_t size, DecodedImage &out, std::string *error)
+        {
+            std::string ignored;
+            std::string &message = error ? *error : ignored;
+            if (size >= 4 && ReadU32(data) == kDdsMagic)
+            {
+                return DecodeDds(data, size, out, &message);
+            }
+            if (g_ImageDecoder && g_ImageDecoder(data, size, out))
+            {
+                return true;
+            }
+#ifdef IMGUI_XP_STB_IMAGE
+            int width, height, channels;
+            unsigned char *pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 4);
+            if (pixels)
+            {
+                out.width = width;
+                out.height = height;
+                out.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+                stbi_image_free(pixels);
+                return true;
+            }
+            message = stbi_failure_reason();
+#else
+            message = "unsupported image format";
+#endif
+            return false;
+        }
+
+        void SetImageDecoder(ImageDecoder decoder)
+        {
+            g_ImageDecoder = std::move(decoder);
+        }
+
+        TextureCache::TextureCache(TextureUploader &uploader, const Options &options, FileReader reader)
+            : m_uploader(uploader), m_options(options), m_reader(reader ? std::move(reader) : FileReader(ReadWholeFile))
+        {
+            for (int i = 0; i < std::max(1, options.workerThreads); ++i)
+            {
+                m_workers.emplace_back(&TextureCache::workerMain, this);
+            }
+        }
+
+        TextureCache::~TextureCache()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            for (std::thread &worker : m_workers)
+            {
+                worker.join();
+            }
+            clear();
+        }
+
+        void TextureCache::workerMain()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                m_wake.wait(lock, [this]
+                            { return m_stop || !m_queue.empty(); });
+                if (m_stop)
+                {
+                    return;
+                }
+                Job job = std::move(m_queue.front());
+                m_queue.pop_front();
+                lock.unlock();
+
+                Result result;
+                result.path = std::move(job.path);
+                result.id = job.id;
+                {
+                    XP_PROFILE_SCOPE("DecodeTexture");
+                    std::vector<unsigned char> bytes;
+                    if (!m_reader(result.path, bytes))
+                    {
+                        result.error = "cannot read the file";
+                    }
+                    else
+                    {
+                        result.ok = DecodeImage(bytes.data(), bytes.size(), result.image, &result.error);
+                    }
+                }
+
+                lock.lock();
+                m_results.push_back(std::move(result));
+            }
+        }
+
+        ImTextureID TextureCache::request(const std::string &path, ImVec2 *outSize, bool *outFailed)
+        {
+            auto it = m_entries.find(path);
+            if (it == m_entries.end())
+            {
+                auto entry = std::make_unique<Entry>();
+                entry->path = path;
+                entry->id = ++m_nextId;
+                entry->lastUsedFrame = m_frame;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_queue.push_back({path, entry->id});
+                }
+                m_wake.notify_one();
+                m_entries.emplace(path, std::move(entry));
+                if (outFailed)
+                {
+                    *outFailed = false;
+                }
+                return ImTextureID();
+            }
+
+            Entry &entry = *it->second;
+            entry.lastUsedFrame = m_frame;
+            if (outSize && entry.state != State::Queued)
+            {
+                *outSize = entry.size;
+            }
+            if (outFailed)
+            {
+                *outFailed = entry.state == State::Failed;
+            }
+            if (entry.state != State::Resident)
+            {
+                return ImTextureID();
+            }
+            m_lru.splice(m_lru.begin(), m_lru, entry.lru);
+            return entry.texture;
+        }
+
+        void TextureCache::update()
+        {
+            XP_PROFILE_SCOPE("TextureCache::update");
+            ++m_frame;
+
+            // Decode results
+            std::vector<Result> results;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                results.swap(m_results);
+            }
+            for (Result &result : results)
+            {
+                auto it = m_entries.find(result.path);
+                if (it == m_entries.end() || it->second->id != result.id)
+                {
+                    continue; // Cleared or pruned meanwhile
+                }
+                Entry &entry = *it->second;
+                if (result.ok)
+                {
+                    entry.image = std::move(result.image);
+                    entry.size = ImVec2(static_cast<float>(entry.image.width), static_cast<float>(entry.image.height));
+                    entry.state = State::Decoded;
+                    m_uploads.push_back(it->first);
+                }
+                else
+                {
+                    entry.state = State::Failed;
+                    ++m_stats.failures;
+                    XPLOG_WARN("Texture {}: {}", result.path, result.error);
+                }
+            }
+
+            // Uploads, time-sliced
+            size_t uploadedBytes = 0;
+            size_t uploaded = 0;
+            for (; uploaded < m_uploads.size() && (uploaded == 0 || uploadedBytes < m_options.uploadBytesPerFrame); ++uploaded)
+            {
+                auto it = m_entries.find(m_uploads[uploaded]);
+                if (it == m_entries.end() || it->second->state != State::Decoded)
+                {
+                    continue;
+                }
+                Entry &entry = *it->second;
+                entry.texture = m_uploader.upload(entry.image);
+                entry.bytes = entry.image.pixels.size();
+                entry.image = DecodedImage();
+                if (entry.texture == ImTextureID())
+                {
+                    entry.state = State::Failed;
+                    ++m_stats.failures;
+                    continue;
+                }
+                entry.state = State::Resident;
+                m_lru.push_front(&entry);
+                entry.lru = m_lru.begin();
+                m_residentBytes += entry.bytes;
+                uploadedBytes += entry.bytes;
+                ++m_stats.uploads;
+            }
+            m_uploads.erase(m_uploads.begin(), m_uploads.begin() + static_cast<std::ptrdiff_t>(uploaded));
+
+            // Files nobody asked for in a while: drop them before decoding, or their pixels before upload
+            auto stale = [this](const std::string &path)
+            {
+                auto it = m_entries.find(path);
+                return it != m_entries.end() && it->second->lastUsedFrame + static_cast<uint64_t>(m_options.staleFrames) < m_frame;
+            };
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), [&](const Job &job)
+                                             {
+                                                 if (!stale(job.path))
+                                                 {
+                                                     return false;
+                                                 }
+                                                 m_entries.erase(job.path);
+                                                 return true; }),
+                              m_queue.end());
+            }
+            m_uploads.erase(std::remove_if(m_uploads.begin(), m_uploads.end(), [&](const std::string &path)
+                                           {
+                                               if (!stale(path))
+                                               {
+                                                   return false;
+                                               }
+                                               m_entries.erase(path);
+                                               return true; }),
+                            m_uploads.end());
+
+            evictOverBudget();
+        }
+
+        void TextureCache::evictOverBudget()
+        {
+            // Least recently used first; stop at textures the last two frames drew
+            while (m_residentBytes > m_options.vramBudget && !m_lru.empty())
+            {
+                Entry *entry = m_lru.back();
+                if (entry->lastUsedFrame + 1 >= m_frame)
+                {
+                    break;
+                }
+                m_lru.pop_back();
+                m_uploader.destroy(entry->texture);
+                m_residentBytes -= entry->bytes;
+                ++m_stats.evictions;
+                m_entries.erase(entry->path);
+            }
+        }
+
+        void TextureCache::clear()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_queue.clear();
+                m_results.clear();
+            }
+            for (Entry *entry : m_lru)
+            {
+                m_uploader.destroy(entry->texture);
+            }
+            m_lru.clear();
+            m_uploads.clear();
+            m_entries.clear();
+            m_residentBytes = 0;
+        }
+
+        TextureCache::Stats TextureCache::stats() const
+        {
+            Stats stats = m_stats;
+            stats.residentBytes = m_residentBytes;
+            stats.residentCount = m_lru.size();
+            stats.pendingUploads = m_uploads.size();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            stats.queuedDecodes = m_queue.size();
+            stats.finishedDecodes = m_results.size();
+            return stats;
+        }
+
+        Texture GetTexture(const std::string &path)
+        {
+            Texture texture;
+            if (g_Cache)
+            {
+                texture.id = g_Cache->request(path, &texture.size, &texture.failed);
+                texture.ready = texture.id != ImTextureID();
+            }
+            return texture;
+        }
+
+        TextureCache *GetTextureCache()
+        {
+            return g_Cache.get();
+        }
+
+        void Image(const Texture &texture, const ImVec2 &size, const ImVec2 &uv0, const ImVec2 &uv1)
+        {
+            if (texture.ready)
+            {
+                ImGui::Image(texture.id, size, uv0, uv1);
+                return;
+            }
+
+            // Placeholder, so the layout does not jump when the texture arrives
+            const ImVec2 min = ImGui::GetCursorScreenPos();
+            const ImVec2 max(min.x + size.x, min.y + size.y);
+            ImGui::Dummy(size);
+            if (!ImGui::IsItemVisible())
+            {
+                return;
+            }
+            ImDrawList *drawList = ImGui::GetWindowDrawList();
+            drawList->AddRectFilled(min, max, ImGui::GetColorU32(ImGuiCol_FrameBg));
+            if (texture.failed)
+            {
+                const ImU32 color = ImGui::GetColorU32(ImGuiCol_TextDisabled);
+                drawList->AddLine(min, max, color);
+                drawList->AddLine(ImVec2(min.x, max.y), ImVec2(max.x, min.y), color);
+            }
+        }
+
+        void InitTextures(const std::string &baseFolder)
+        {
+            g_BaseFolder = baseFolder;
+            g_Uploader = CreateOpenGLTextureUploader();
+            // Relative paths are relative to the plugin folder
+            g_Cache = std::make_unique<TextureCache>(*g_Uploader, TextureCache::Options(), [](const std::string &path, std::vector<unsigned char> &out)
+                                                     {
+                                                         std::filesystem::path file(path);
+                                                         return ReadWholeFile(file.is_relative() ? (std::filesystem::path(g_BaseFolder) / file).string() : path, out); });
+            g_MetricsCollector = XPlaneMetrics::addCollector(CollectTextureMetrics);
+        }
+
+        void UpdateTextures()
+        {
+            if (g_Cache)
+            {
+                g_Cache->update();
+            }
+        }
+
+        void TrimTextures()
+        {
+            if (g_Cache)
+            {
+                g_Cache->clear();
+            }
+        }
+
+        void ShutdownTextures()
+        {
+            if (g_Cache)
+            {
+                XPlaneMetrics::removeCollector(g_MetricsCollector);
+            }
+            g_Cache.reset();
+            g_Uploader.reset();
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
@@ -0,0 +1,206 @@
+#ifndef IMGUI_IMPL_XPLANE_TEXTURE_H
+#define IMGUI_IMPL_XPLANE_TEXTURE_H
+
+// ImGui
+#include "imgui.h"
+
+// Standard Library
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // Textures
+        // Image files for ImGui::Image, loaded without stalling the sim:
+        //   - worker threads read and decode the files;
+        //   - the main thread uploads at most uploadBytesPerFrame per frame;
+        //   - resident textures are evicted least recently used first once their total size
+        //     exceeds vramBudget;
+        //   - until a texture is ready, Image() draws a placeholder.
+        // DDS (DXT1/3/5, 24 and 32-bit uncompressed) is decoded built in. PNG and JPEG need
+        // stb_image.h (CMake STB_IMAGE_DIR) or a decoder set with SetImageDecoder().
+        //
+        //     ImGui::XP::Image(ImGui::XP::GetTexture("charts/KSEA.dds"), ImVec2(512, 512));
+
+        // Decoded image, tightly packed RGBA8, top row first
+        struct DecodedImage
+        {
+            int width = 0;
+            int height = 0;
+            std::vector<unsigned char> pixels;
+        };
+
+        // Decodes a file's contents; false with *error set if the format is unknown or broken.
+        // Called on worker threads.
+        bool DecodeImage(const unsigned char *data, size_t size, DecodedImage &out, std::string *error = nullptr);
+
+        // Decoder for formats not handled built in. Must be thread-safe. Set before loading textures.
+        using ImageDecoder = std::function<bool(const unsigned char *data, size_t size, DecodedImage &out)>;
+        void SetImageDecoder(ImageDecoder decoder);
+
+        // Turns decoded images into textures ImGui can draw; main thread only.
+        // The renderer's implementation uploads through pixel buffer objects; tests can substitute a mock.
+        class TextureUploader
+        {
+        public:
+            virtual ~TextureUploader() = default;
+            virtual ImTextureID upload(const DecodedImage &image) = 0;
+            virtual void destroy(ImTextureID texture) = 0;
+        };
+
+        // OpenGL uploader (imgui_impl_xplane_texture_gl.cpp); needs the OpenGL3 backend initialized
+        std::unique_ptr<TextureUploader> CreateOpenGLTextureUploader();
+
+        struct TextureCacheOptions
+        {
+            size_t vramBudget = 256u * 1024u * 1024u;       // Bytes of resident textures
+            size_t uploadBytesPerFrame = 8u * 1024u * 1024u; // At least one upload per frame
+            int workerThreads = 2;
+            int staleFrames = 120; // Files not requested for this long are dropped before upload
+        };
+
+        struct TextureCacheStats
+        {
+            size_t residentBytes = 0;
+            size_t residentCount = 0;
+            size_t queuedDecodes = 0;
+            size_t finishedDecodes = 0; // Decoded or failed, waiting for update()
+            size_t pendingUploads = 0;
+            uint64_t uploads = 0;
+            uint64_t evictions = 0;
+            uint64_t failures = 0;
+        };
+
+        // Loads and keeps the textures; request() and update() on the main thread only
+        class TextureCache
+        {
+        public:
+            using Options = TextureCacheOptions;
+            using Stats = TextureCacheStats;
+
+            // File contents for a path; the default reads the file. Called on worker threads.
+            using FileReader = std::function<bool(const std::string &path, std::vector<unsigned char> &out)>;
+
+            TextureCache(TextureUploader &uploader, const Options &options = Options(), FileReader reader = nullptr);
+            ~TextureCache();
+
+            TextureCache(const TextureCache &) = delete;
+            TextureCache &operator=(const TextureCache &) = delete;
+
+            // The texture if resident, else nullptr-like (ImTextureID()) and the file is queued.
+            // Marks the texture as used in this frame; outSize receives the image size once known.
+            ImTextureID request(const std::string &path, ImVec2 *outSize = nullptr, bool *outFailed = nullptr);
+
+            // Once per frame, before the render callbacks: uploads decoded images and evicts over budget.
+            // Textures used in this or the previous frame are never evicted, since their draw data may
+            // still be drawn again.
+            void update();
+
+            // Destroys every texture and drops queued work; files load again on request
+            void clear();
+
+            Stats stats() const;
+
+        private:
+            enum class State
+            {
+                Queued, // Waiting for or being decoded
+                Decoded,
+                Resident,
+                Failed
+            };
+
+            struct Entry
+            {
+                std::string path;
+                uint64_t id = 0; // Tells a decode result apart from one for an earlier, dropped entry
+                State state = State::Queued;
+                DecodedImage image; // Decoded, until uploaded
+                ImTextureID texture = ImTextureID();
+                ImVec2 size = ImVec2(0.0f, 0.0f);
+                size_t bytes = 0;
+                uint64_t lastUsedFrame = 0;
+                std::list<Entry *>::iterator lru; // Resident entries only
+            };
+
+            // Workers only see jobs and results, never entries, so the main thread can drop entries freely
+            struct Job
+            {
+                std::string path;
+                uint64_t id = 0;
+            };
+
+            struct Result
+            {
+                std::string path;
+                uint64_t id = 0;
+                bool ok = false;
+                DecodedImage image;
+                std::string error;
+            };
+
+            void workerMain();
+            void evictOverBudget();
+
+            TextureUploader &m_uploader;
+            Options m_options;
+            FileReader m_reader;
+
+            // Main thread
+            std::unordered_map<std::string, std::unique_ptr<Entry>> m_entries;
+            std::list<Entry *> m_lru;           // Resident, most recently used first
+            std::vector<std::string> m_uploads; // Decoded, to upload in this order
+            uint64_t m_frame = 0;
+            uint64_t m_nextId = 0;
+            size_t m_residentBytes = 0;
+            Stats m_stats;
+
+            // Shared with the workers
+            mutable std::mutex m_mutex;
+            std::condition_variable m_wake;
+            std::deque<Job> m_queue;      // To decode, oldest request first
+            std::vector<Result> m_results; // To pick up on the main thread
+            bool m_stop = false;
+            std::vector<std::thread> m_workers;
+        };
+
+        // Texture handle for one frame
+        struct Texture
+        {
+            ImTextureID id = ImTextureID();
+            ImVec2 size = ImVec2(0.0f, 0.0f); // Pixels, once decoded
+            bool ready = false;
+            bool failed = false;
+        };
+
+        // From the backend's cache, created with the OpenGL3 backend. Relative paths are resolved
+        // against the plugin folder. Inside render callbacks only.
+        Texture GetTexture(const std::string &path);
+        TextureCache *GetTextureCache();
+
+        // ImGui::Image, or a placeholder of the same size while the texture loads
+        void Image(const Texture &texture, const ImVec2 &size, const ImVec2 &uv0 = ImVec2(0, 0), const ImVec2 &uv1 = ImVec2(1, 1));
+
+        // Used by imgui_impl_xplane.cpp
+        void InitTextures(const std::string &baseFolder);
+        void UpdateTextures(); // In BeginFrame
+        void TrimTextures();   // From TrimMemory
+        void ShutdownTextures();
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_TEXTURE_H
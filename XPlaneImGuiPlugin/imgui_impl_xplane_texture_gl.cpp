@@ -0,0 +1,155 @@
+#include "imgui_impl_xplane_texture.h"
+
+// Standard library headers
+#include <cstdint>
+#include <cstring>
+
+// ImGui
+#include <backends/imgui_impl_opengl3_loader.h>
+
+// Not in every version of the loader
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER_BINDING
+#define GL_PIXEL_UNPACK_BUFFER_BINDING 0x88EF
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+#ifndef GL_TEXTURE_WRAP_S
+#define GL_TEXTURE_WRAP_S 0x2802
+#endif
+#ifndef GL_TEXTURE_WRAP_T
+#define GL_TEXTURE_WRAP_T 0x2803
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            // The loader does not declare buffer mapping, so it is looked up once
+            typedef void *(APIENTRY *MapBufferRangeProc)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+            typedef GLboolean(APIENTRY *UnmapBufferProc)(GLenum target);
+
+            // Stages each image in one of two pixel buffer objects, written through a mapping of freshly
+            // orphaned storage, so neither the copy nor glTexImage2D waits for the GPU to finish the
+            // previous upload. Without buffer mapping the pixels go straight to glTexImage2D. X-Plane's
+            // texture and unpack state is restored afterwards.
+            class OpenGLTextureUploader : public TextureUploader
+            {
+            public:
+                OpenGLTextureUploader()
+                    : m_mapBufferRange(reinterpret_cast<MapBufferRangeProc>(imgl3wGetProcAddress("glMapBufferRange"))),
+                      m_unmapBuffer(reinterpret_cast<UnmapBufferProc>(imgl3wGetProcAddress("glUnmapBuffer")))
+                {
+                }
+
+                ~OpenGLTextureUploader() override
+                {
+                    if (m_buffers[0])
+                    {
+                        glDeleteBuffers(2, m_buffers);
+                    }
+                }
+
+                ImTextureID upload(const DecodedImage &image) override
+                {
+                    GLint lastTexture, lastUnpackBuffer, lastAlignment, lastRowLength;
+                    glGetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+                    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &lastUnpackBuffer);
+                    glGetIntegerv(GL_UNPACK_ALIGNMENT, &lastAlignment);
+                    glGetIntegerv(GL_UNPACK_ROW_LENGTH, &lastRowLength);
+
+                    const void *pixels = stage(image);
+                    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+                    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+                    GLuint texture = 0;
+                    glGenTextures(1, &texture);
+                    glBindTexture(GL_TEXTURE_2D, texture);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, static_cast<GLuint>(lastUnpackBuffer));
+                    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(lastTexture));
+                    glPixelStorei(GL_UNPACK_ALIGNMENT, lastAlignment);
+                    glPixelStorei(GL_UNPACK_ROW_LENGTH, lastRowLength);
+                    return (ImTextureID)(intptr_t)texture;
+                }
+
+                void destroy(ImTextureID texture) override
+                {
+                    GLuint name = static_cast<GLuint>((intptr_t)texture);
+                    glDeleteTextures(1, &name);
+                }
+
+            private:
+                // Binds the unpack buffer for glTexImage2D and returns its pixel argument: offset 0 of
+                // the next staging buffer, or the image itself if it could not be staged
+                const void *stage(const DecodedImage &image)
+                {
+                    if (!m_mapBufferRange || !m_unmapBuffer)
+                    {
+                        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                        return image.pixels.data();
+                    }
+                    if (!m_buffers[0])
+                    {
+                        glGenBuffers(2, m_buffers);
+                    }
+                    m_next ^= 1;
+                    const GLsizeiptr size = static_cast<GLsizeiptr>(image.pixels.size());
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffers[m_next]);
+                    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+                    void *mapped = m_mapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+                    if (!mapped)
+                    {
+                        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                        return image.pixels.data();
+                    }
+                    std::memcpy(mapped, image.pixels.data(), image.pixels.size());
+                    if (!m_unmapBuffer(GL_PIXEL_UNPACK_BUFFER))
+                    {
+                        // The store was lost while mapped (e.g. a mode switch); its contents are undefined
+                        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                        return image.pixels.data();
+                    }
+                    return nullptr;
+                }
+
+                MapBufferRangeProc m_mapBufferRange;
+                UnmapBufferProc m_unmapBuffer;
+                GLuint m_buffers[2] = {};
+                int m_next = 0;
+            };
+        } // namespace
+
+        std::unique_ptr<TextureUploader> CreateOpenGLTextureUploader()
+        {
+            return std::make_unique<OpenGLTextureUploader>();
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
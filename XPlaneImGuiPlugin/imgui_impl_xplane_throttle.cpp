@@ -0,0 +1,174 @@
+#include "imgui_impl_xplane_throttle.h"
+
+// Standard library headers
+#include <chrono>
+#include <cstdint>
+
+// X-Plane SDK
+#include <XPLMPlanes.h>
+#include <XPLMPlugin.h>
+
+// Project-specific headers
+#include "imgui_impl_xplane_xplm.h"
+#include "XPlaneLog.h"
+#include "XPlaneMetrics.h"
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace
+        {
+            using Clock = std::chrono::steady_clock;
+
+            ThrottlePolicy g_Policy;
+
+            bool g_Loading = false;
+            Clock::time_point g_LoadStart;
+            Clock::time_point g_SettleUntil;
+            Clock::time_point g_BoostUntil;
+            Clock::time_point g_LastBuild;
+            SimState g_LastState = SimState::Running; // As of the last ShouldBuildFrame()
+
+            XPLMDataRef g_PausedRef = nullptr;
+            XPLMDataRef g_ReplayRef = nullptr;
+            bool g_DataRefsFound = false;
+
+            XPlaneMetrics::Counter &RedrawnFramesMetric()
+            {
+                static XPlaneMetrics::Counter &counter = XPlaneMetrics::counter("imgui.throttle.redrawn_frames", "Sim frames that redrew the last ImGui frame instead of building one");
+                return counter;
+            }
+
+            XPlaneMetrics::Counter &LoadSuspendsMetric()
+            {
+                static XPlaneMetrics::Counter &counter = XPlaneMetrics::counter("imgui.throttle.load_suspends", "Loads that suspended ImGui frames");
+                return counter;
+            }
+
+            XPlaneMetrics::Counter &InputWakeupsMetric()
+            {
+                static XPlaneMetrics::Counter &counter = XPlaneMetrics::counter("imgui.throttle.input_wakeups", "Throttled periods cut short by input");
+                return counter;
+            }
+
+            std::chrono::duration<float> Seconds(float seconds)
+            {
+                return std::chrono::duration<float>(seconds);
+            }
+
+            bool LoadInProgress(Clock::time_point now)
+            {
+                if (g_Loading && now - g_LoadStart > Seconds(g_Policy.maxLoadSeconds))
+                {
+                    g_Loading = false;
+                    XPLOG_WARN("No load message {} s after the aircraft unloaded, resuming ImGui frames", g_Policy.maxLoadSeconds);
+                }
+                return g_Loading;
+            }
+
+            SimState ReadState(Clock::time_point now)
+            {
+                if (LoadInProgress(now))
+                {
+                    return SimState::Loading;
+                }
+                if (now < g_SettleUntil)
+                {
+                    return SimState::Settling;
+                }
+
+                if (!g_DataRefsFound)
+                {
+                    g_PausedRef = Xplm::FindDataRef("sim/time/paused");
+                    g_ReplayRef = Xplm::FindDataRef("sim/time/is_in_replay");
+                    g_DataRefsFound = true;
+                }
+                if (g_ReplayRef && Xplm::GetDatai(g_ReplayRef))
+                {
+                    return SimState::Replay;
+                }
+                if (g_PausedRef && Xplm::GetDatai(g_PausedRef))
+                {
+                    return SimState::Paused;
+                }
+                return SimState::Running;
+            }
+        } // namespace
+
+        void SetThrottlePolicy(const ThrottlePolicy &policy)
+        {
+            g_Policy = policy;
+        }
+
+        void HandleSimMessage(XPLMPluginID /*from*/, int message, void *param)
+        {
+            const Clock::time_point now = Clock::now();
+            const bool userAircraft = reinterpret_cast<intptr_t>(param) == XPLM_USER_AIRCRAFT;
+            switch (message)
+            {
+            case XPLM_MSG_PLANE_UNLOADED:
+                // Start of a new flight or aircraft change: the new aircraft and its scenery follow
+                if (userAircraft && !g_Loading)
+                {
+                    g_Loading = true;
+                    g_LoadStart = now;
+                    LoadSuspendsMetric().add();
+                    XPLOG_DEBUG("User aircraft unloaded, suspending ImGui frames");
+                }
+                break;
+            case XPLM_MSG_PLANE_LOADED:
+                if (!userAircraft)
+                {
+                    break;
+                }
+                // Fall through
+            case XPLM_MSG_AIRPORT_LOADED:
+            case XPLM_MSG_SCENERY_LOADED:
+                // The sim keeps loading in the background for a while
+                g_Loading = false;
+                g_SettleUntil = now + std::chrono::duration_cast<Clock::duration>(Seconds(g_Policy.settleSeconds));
+                break;
+            default:
+                break;
+            }
+        }
+
+        SimState GetSimState()
+        {
+            return g_LastState;
+        }
+
+        bool SimSuspendsFrames()
+        {
+            // Input wakes frames during a load too, so a window clicked while scenery loads responds
+            const Clock::time_point now = Clock::now();
+            return LoadInProgress(now) && now >= g_BoostUntil;
+        }
+
+        bool ShouldBuildFrame()
+        {
+            const Clock::time_point now = Clock::now();
+            g_LastState = ReadState(now);
+            if (g_LastState == SimState::Running || g_Policy.reducedRate <= 0.0f || now < g_BoostUntil || now - g_LastBuild >= Seconds(1.0f / g_Policy.reducedRate))
+            {
+                g_LastBuild = now;
+                return true;
+            }
+            RedrawnFramesMetric().add();
+            return false;
+        }
+
+        void NotifyInput()
+        {
+            const Clock::time_point now = Clock::now();
+            if (g_LastState != SimState::Running && now >= g_BoostUntil)
+            {
+                InputWakeupsMetric().add();
+            }
+            g_BoostUntil = now + std::chrono::duration_cast<Clock::duration>(Seconds(g_Policy.inputBoostSeconds));
+        }
+
+    } // namespace XP
+
+} // namespace ImGui
@@ -0,0 +1,55 @@
+#ifndef IMGUI_IMPL_XPLANE_THROTTLE_H
+#define IMGUI_IMPL_XPLANE_THROTTLE_H
+
+// X-Plane SDK
+#include <XPLMDefs.h>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // Sim-state throttling
+        // The UI rarely needs 60 Hz while the sim is paused, in replay, or finishing a load.
+        //   - Throttled: new ImGui frames are built at ThrottlePolicy::reducedRate, and the sim frames
+        //     in between redraw the last frame's draw data.
+        //   - Suspended: from the unload of the user's aircraft until X-Plane reports the new aircraft,
+        //     airport or scenery loaded.
+        //   - Mouse or keyboard input restores the full rate at once, for inputBoostSeconds. During a
+        //     load it resumes suspended frames for that long.
+        // Throttling is counted in imgui.throttle.redrawn_frames, imgui.throttle.load_suspends and
+        // imgui.throttle.input_wakeups.
+        enum class SimState
+        {
+            Running,
+            Paused,   // sim/time/paused
+            Replay,   // sim/time/is_in_replay
+            Loading,  // Frames suspended
+            Settling, // settleSeconds after a load finished
+        };
+
+        struct ThrottlePolicy
+        {
+            float reducedRate = 10.0f;      // ImGui frames per second when throttled; 0 or less: never throttle
+            float settleSeconds = 3.0f;     // Throttled after a load message
+            float inputBoostSeconds = 2.0f; // Full rate after input
+            float maxLoadSeconds = 120.0f;  // Resume anyway if no load message follows an unload
+        };
+
+        void SetThrottlePolicy(const ThrottlePolicy &policy);
+
+        // Call from XPluginReceiveMessage
+        void HandleSimMessage(XPLMPluginID from, int message, void *param);
+
+        // As of this sim frame's ShouldBuildFrame(), so asking does not read the datarefs again
+        SimState GetSimState();
+
+        // Used by imgui_impl_xplane.cpp
+        bool SimSuspendsFrames(); // A load is in progress and no input boost is running
+        bool ShouldBuildFrame();  // Once per sim frame; false: redraw the last frame instead
+        void NotifyInput();       // From the mouse and keyboard handlers
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_THROTTLE_H
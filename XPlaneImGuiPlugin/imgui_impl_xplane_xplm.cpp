@@ -0,0 +1,305 @@
+#include "imgui_impl_xplane_xplm.h"
+
+// Standard library headers
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+// X-Plane SDK
+#include <XPLMPlugin.h>
+
+// Project-specific headers
+#include "XPlaneMetrics.h"
+
+namespace ImGui
+{
+    namespace XP
+    {
+        namespace Xplm
+        {
+            namespace
+            {
+                enum Function
+                {
+                    Function_GetScreenSize,
+                    Function_GetScreenBoundsGlobal,
+                    Function_GetWindowGeometry,
+                    Function_SetWindowGeometry,
+                    Function_HasKeyboardFocus,
+                    Function_TakeKeyboardFocus,
+                    Function_BringWindowToFront,
+                    Function_SetWindowIsVisible,
+                    Function_GetMouseLocationGlobal,
+                    Function_RegisterDrawCallback,
+                    Function_UnregisterDrawCallback,
+                    Function_CreateWindowEx,
+                    Function_DestroyWindow,
+                    Function_FindDataRef,
+                    Function_GetDatai,
+                    Function_GetDataf,
+                    Function_GetPluginInfo,
+                    Function_RegisterFlightLoopCallback,
+                    Function_UnregisterFlightLoopCallback,
+                    Function_SetFlightLoopCallbackInterval,
+                    Function_Count
+                };
+
+                const char *const kFunctionNames[Function_Count] = {
+                    "XPLMGetScreenSize",
+                    "XPLMGetScreenBoundsGlobal",
+                    "XPLMGetWindowGeometry",
+                    "XPLMSetWindowGeometry",
+                    "XPLMHasKeyboardFocus",
+                    "XPLMTakeKeyboardFocus",
+                    "XPLMBringWindowToFront",
+                    "XPLMSetWindowIsVisible",
+                    "XPLMGetMouseLocationGlobal",
+                    "XPLMRegisterDrawCallback",
+                    "XPLMUnregisterDrawCallback",
+                    "XPLMCreateWindowEx",
+                    "XPLMDestroyWindow",
+                    "XPLMFindDataRef",
+                    "XPLMGetDatai",
+                    "XPLMGetDataf",
+                    "XPLMGetPluginInfo",
+                    "XPLMRegisterFlightLoopCallback",
+                    "XPLMUnregisterFlightLoopCallback",
+                    "XPLMSetFlightLoopCallbackInterval",
+                };
+
+                // The cached focus is checked against the sim this often, in case it changed
+                // without a losing-focus event
+                constexpr int kFocusCheckFrames = 60;
+
+                struct FunctionMetrics
+                {
+                    XPlaneMetrics::Counter *calls = nullptr;
+                    XPlaneMetrics::Histogram *time = nullptr;
+                };
+
+                FunctionMetrics g_Metrics[Function_Count];
+                uint64_t g_CallCount = 0;
+
+                int g_ScreenWidth = 0;
+                int g_ScreenHeight = 0;
+                XPLMWindowID g_FocusedWindow = nullptr; // Our window holding keyboard focus, if any
+                int g_FramesSinceFocusCheck = 0;
+                std::unordered_map<std::string, XPLMDataRef> g_DataRefs;
+                std::string g_PluginPath;
+
+                // Counts and times one XPLM call
+                class CallScope
+                {
+                public:
+                    explicit CallScope(Function function) : m_function(function), m_start(std::chrono::steady_clock::now())
+                    {
+                        FunctionMetrics &metrics = g_Metrics[function];
+                        if (!metrics.calls)
+                        {
+                            const std::string name = kFunctionNames[function];
+                            metrics.calls = &XPlaneMetrics::counter("xplm.calls." + name, "Calls to " + name + " by the ImGui backend");
+                            metrics.time = &XPlaneMetrics::histogram("xplm.call_time." + name, "ns", "Time spent in " + name);
+                        }
+                        metrics.calls->add();
+                        ++g_CallCount;
+                    }
+
+                    ~CallScope()
+                    {
+                        g_Metrics[m_function].time->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count()));
+                    }
+
+                    CallScope(const CallScope &) = delete;
+                    CallScope &operator=(const CallScope &) = delete;
+
+                private:
+                    Function m_function;
+                    std::chrono::steady_clock::time_point m_start;
+                };
+            } // namespace
+
+            bool BeginFrame()
+            {
+                int width, height;
+                {
+                    CallScope scope(Function_GetScreenSize);
+                    XPLMGetScreenSize(&width, &height);
+                }
+                const bool changed = width != g_ScreenWidth || height != g_ScreenHeight;
+                g_ScreenWidth = width;
+                g_ScreenHeight = height;
+
+                if (g_FocusedWindow && ++g_FramesSinceFocusCheck >= kFocusCheckFrames)
+                {
+                    g_FramesSinceFocusCheck = 0;
+                    CallScope scope(Function_HasKeyboardFocus);
+                    if (!XPLMHasKeyboardFocus(g_FocusedWindow))
+                    {
+                        g_FocusedWindow = nullptr;
+                    }
+                }
+                return changed;
+            }
+
+            void GetScreenSize(int *outWidth, int *outHeight)
+            {
+                if (g_ScreenWidth == 0)
+                {
+                    // Before the first frame
+                    CallScope scope(Function_GetScreenSize);
+                    XPLMGetScreenSize(&g_ScreenWidth, &g_ScreenHeight);
+                }
+                *outWidth = g_ScreenWidth;
+                *outHeight = g_ScreenHeight;
+            }
+
+            bool HasKeyboardFocus(XPLMWindowID window)
+            {
+                return window && g_FocusedWindow == window;
+            }
+
+            XPLMWindowID GetFocusedWindow()
+            {
+                return g_FocusedWindow;
+            }
+
+            void TakeKeyboardFocus(XPLMWindowID window)
+            {
+                CallScope scope(Function_TakeKeyboardFocus);
+                XPLMTakeKeyboardFocus(window);
+                g_FocusedWindow = window;
+                g_FramesSinceFocusCheck = 0;
+            }
+
+            void KeyboardFocusLost(XPLMWindowID window)
+            {
+                if (g_FocusedWindow == window)
+                {
+                    g_FocusedWindow = nullptr;
+                }
+            }
+
+            XPLMDataRef FindDataRef(const char *name)
+            {
+                auto it = g_DataRefs.find(name);
+                if (it == g_DataRefs.end())
+                {
+                    CallScope scope(Function_FindDataRef);
+                    it = g_DataRefs.emplace(name, XPLMFindDataRef(name)).first;
+                }
+                return it->second;
+            }
+
+            int GetDatai(XPLMDataRef dataRef)
+            {
+                CallScope scope(Function_GetDatai);
+                return XPLMGetDatai(dataRef);
+            }
+
+            float GetDataf(XPLMDataRef dataRef)
+            {
+                CallScope scope(Function_GetDataf);
+                return XPLMGetDataf(dataRef);
+            }
+
+            const std::string &GetPluginPath()
+            {
+                if (g_PluginPath.empty())
+                {
+                    char path[512] = {};
+                    CallScope scope(Function_GetPluginInfo);
+                    XPLMGetPluginInfo(XPLMGetMyID(), nullptr, path, nullptr, nullptr);
+                    g_PluginPath = path;
+                }
+                return g_PluginPath;
+            }
+
+            void GetScreenBoundsGlobal(int *outLeft, int *outTop, int *outRight, int *outBottom)
+            {
+                CallScope scope(Function_GetScreenBoundsGlobal);
+                XPLMGetScreenBoundsGlobal(outLeft, outTop, outRight, outBottom);
+            }
+
+            void GetWindowGeometry(XPLMWindowID window, int *outLeft, int *outTop, int *outRight, int *outBottom)
+            {
+                CallScope scope(Function_GetWindowGeometry);
+                XPLMGetWindowGeometry(window, outLeft, outTop, outRight, outBottom);
+            }
+
+            void SetWindowGeometry(XPLMWindowID window, int left, int top, int right, int bottom)
+            {
+                CallScope scope(Function_SetWindowGeometry);
+                XPLMSetWindowGeometry(window, left, top, right, bottom);
+            }
+
+            void BringWindowToFront(XPLMWindowID window)
+            {
+                CallScope scope(Function_BringWindowToFront);
+                XPLMBringWindowToFront(window);
+            }
+
+            void SetWindowIsVisible(XPLMWindowID window, int visible)
+            {
+                CallScope scope(Function_SetWindowIsVisible);
+                XPLMSetWindowIsVisible(window, visible);
+            }
+
+            void GetMouseLocationGlobal(int *outX, int *outY)
+            {
+                CallScope scope(Function_GetMouseLocationGlobal);
+                XPLMGetMouseLocationGlobal(outX, outY);
+            }
+
+            void RegisterDrawCallback(XPLMDrawCallback_f callback, XPLMDrawingPhase phase, int wantsBefore)
+            {
+                CallScope scope(Function_RegisterDrawCallback);
+                XPLMRegisterDrawCallback(callback, phase, wantsBefore, nullptr);
+            }
+
+            void UnregisterDrawCallback(XPLMDrawCallback_f callback, XPLMDrawingPhase phase, int wantsBefore)
+            {
+                CallScope scope(Function_UnregisterDrawCallback);
+                XPLMUnregisterDrawCallback(callback, phase, wantsBefore, nullptr);
+            }
+
+            XPLMWindowID CreateXPLMWindow(XPLMCreateWindow_t *params)
+            {
+                CallScope scope(Function_CreateWindowEx);
+                return XPLMCreateWindowEx(params);
+            }
+
+            void DestroyXPLMWindow(XPLMWindowID window)
+            {
+                CallScope scope(Function_DestroyWindow);
+                KeyboardFocusLost(window);
+                XPLMDestroyWindow(window);
+            }
+
+            void RegisterFlightLoopCallback(XPLMFlightLoop_f callback, float interval)
+            {
+                CallScope scope(Function_RegisterFlightLoopCallback);
+                XPLMRegisterFlightLoopCallback(callback, interval, nullptr);
+            }
+
+            void UnregisterFlightLoopCallback(XPLMFlightLoop_f callback)
+            {
+                CallScope scope(Function_UnregisterFlightLoopCallback);
+                XPLMUnregisterFlightLoopCallback(callback, nullptr);
+            }
+
+            void SetFlightLoopCallbackInterval(XPLMFlightLoop_f callback, float interval, int relativeToNow)
+            {
+                CallScope scope(Function_SetFlightLoopCallbackInterval);
+                XPLMSetFlightLoopCallbackInterval(callback, interval, relativeToNow, nullptr);
+            }
+
+            uint64_t GetCallCount()
+            {
+                return g_CallCount;
+            }
+
+        } // namespace Xplm
+
+    } // namespace XP
+
+} // namespace ImGui
@@ -0,0 +1,71 @@
+#ifndef IMGUI_IMPL_XPLANE_XPLM_H
+#define IMGUI_IMPL_XPLANE_XPLM_H
+
+// X-Plane SDK
+#include <XPLMDataAccess.h>
+#include <XPLMDisplay.h>
+#include <XPLMProcessing.h>
+
+// Standard Library
+#include <cstdint>
+#include <string>
+
+namespace ImGui
+{
+    namespace XP
+    {
+        // XPLM calls made by the ImGui backend
+        // Every XPLM call crosses into the sim, so the backend makes them through this layer, which
+        // answers frame-invariant queries from a cache and counts and times each call by function
+        // (XPlaneMetrics counter "xplm.calls.<function>" and histogram "xplm.call_time.<function>").
+        // Main thread only.
+        namespace Xplm
+        {
+            // Refresh the per-frame cache: one XPLMGetScreenSize call, plus a periodic check of the
+            // cached keyboard focus. Returns true when the screen size changed since the last frame.
+            bool BeginFrame();
+
+            // Screen size as of BeginFrame()
+            void GetScreenSize(int *outWidth, int *outHeight);
+
+            // Keyboard focus is tracked from our own TakeKeyboardFocus calls and the losing-focus
+            // key events X-Plane sends, so asking does not call into the sim
+            bool HasKeyboardFocus(XPLMWindowID window);
+            XPLMWindowID GetFocusedWindow(); // Our window holding keyboard focus, or nullptr
+            void TakeKeyboardFocus(XPLMWindowID window);
+            void KeyboardFocusLost(XPLMWindowID window); // From a key callback with losing_focus set
+
+            // Datarefs are looked up once per name; a name that was not found stays null
+            XPLMDataRef FindDataRef(const char *name);
+            int GetDatai(XPLMDataRef dataRef);
+            float GetDataf(XPLMDataRef dataRef);
+
+            // Path of this plugin's binary, asked of the sim once
+            const std::string &GetPluginPath();
+
+            // Uncached, counted pass-throughs (the window functions are not named after XPLM's to
+            // stay clear of the Win32 CreateWindowEx macro)
+            void GetScreenBoundsGlobal(int *outLeft, int *outTop, int *outRight, int *outBottom);
+            void GetWindowGeometry(XPLMWindowID window, int *outLeft, int *outTop, int *outRight, int *outBottom);
+            void SetWindowGeometry(XPLMWindowID window, int left, int top, int right, int bottom);
+            void BringWindowToFront(XPLMWindowID window);
+            void SetWindowIsVisible(XPLMWindowID window, int visible);
+            void GetMouseLocationGlobal(int *outX, int *outY);
+            void RegisterDrawCallback(XPLMDrawCallback_f callback, XPLMDrawingPhase phase, int wantsBefore);
+            void UnregisterDrawCallback(XPLMDrawCallback_f callback, XPLMDrawingPhase phase, int wantsBefore);
+            XPLMWindowID CreateXPLMWindow(XPLMCreateWindow_t *params);
+            void DestroyXPLMWindow(XPLMWindowID window);
+            void RegisterFlightLoopCallback(XPLMFlightLoop_f callback, float interval);
+            void UnregisterFlightLoopCallback(XPLMFlightLoop_f callback);
+            void SetFlightLoopCallbackInterval(XPLMFlightLoop_f callback, float interval, int relativeToNow);
+
+            // XPLM calls made through this layer so far
+            uint64_t GetCallCount();
+
+        } // namespace Xplm
+
+    } // namespace XP
+
+} // namespace ImGui
+
+#endif // IMGUI_IMPL_XPLANE_XPLM_H
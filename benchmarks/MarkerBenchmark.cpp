@@ -0,0 +1,166 @@
+// Microbenchmark for ImGui::XP::AddMarkers.
+// Draws the same set of rotated symbols, about half of them off screen, per item with
+// AddImageQuad, per item with AddPolyline, and in bulk with AddMarkers, and reports the time
+// per frame and per marker of each. AddMarkers culls against the clip rect, so each per-item
+// baseline runs both without culling and with the same cull done per symbol.
+
+// Standard Library Headers
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Third-Party Library Headers
+#include <imgui.h>
+
+// Project-Specific Headers
+#include "imgui_impl_xplane_markers.h"
+
+struct Scene
+{
+    std::vector<float> x, y, rotations;
+    std::vector<ImU32> colors;
+    std::vector<uint16_t> symbols;
+};
+
+static Scene MakeScene(int count, const ImVec2 &display)
+{
+    Scene scene;
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> x(-display.x * 0.5f, display.x * 1.5f), y(-display.y * 0.5f, display.y * 1.5f), angle(0.0f, 6.2831853f);
+    for (int i = 0; i < count; ++i)
+    {
+        scene.x.push_back(x(random));
+        scene.y.push_back(y(random));
+        scene.rotations.push_back(angle(random));
+        scene.colors.push_back(IM_COL32(255, 200, static_cast<int>(i & 255), 255));
+        scene.symbols.push_back(static_cast<uint16_t>(i & 1));
+    }
+    return scene;
+}
+
+// The cull AddMarkers does: the position within the clip rect grown by the symbol's radius
+static bool OnScreen(const ImDrawList *drawList, float x, float y, const ImGui::XP::MarkerSymbol &symbol)
+{
+    const float radius = 0.5f * std::sqrt(symbol.size.x * symbol.size.x + symbol.size.y * symbol.size.y);
+    const ImVec2 min = drawList->GetClipRectMin(), max = drawList->GetClipRectMax();
+    return x >= min.x - radius && x <= max.x + radius && y >= min.y - radius && y <= max.y + radius;
+}
+
+// What a traffic display does today: rotate the corners of each symbol, then one call per symbol
+template <bool Cull>
+static void DrawImageQuads(ImDrawList *drawList, const Scene &scene, const ImGui::XP::MarkerSymbol *symbols)
+{
+    for (size_t i = 0; i < scene.x.size(); ++i)
+    {
+        const ImGui::XP::MarkerSymbol &symbol = symbols[scene.symbols[i]];
+        if (Cull && !OnScreen(drawList, scene.x[i], scene.y[i], symbol))
+        {
+            continue;
+        }
+        const float c = std::cos(scene.rotations[i]), s = std::sin(scene.rotations[i]);
+        const float hx = symbol.size.x * 0.5f, hy = symbol.size.y * 0.5f;
+        const ImVec2 p(scene.x[i], scene.y[i]);
+        drawList->AddImageQuad(ImGui::GetIO().Fonts->TexID,
+                               ImVec2(p.x - hx * c + hy * s, p.y - hx * s - hy * c), ImVec2(p.x + hx * c + hy * s, p.y + hx * s - hy * c),
+                               ImVec2(p.x + hx * c - hy * s, p.y + hx * s + hy * c), ImVec2(p.x - hx * c - hy * s, p.y - hx * s + hy * c),
+                               symbol.uv0, ImVec2(symbol.uv1.x, symbol.uv0.y), symbol.uv1, ImVec2(symbol.uv0.x, symbol.uv1.y), scene.colors[i]);
+    }
+}
+
+// Outlined chevrons, one polyline per symbol
+template <bool Cull>
+static void DrawPolylines(ImDrawList *drawList, const Scene &scene, const ImGui::XP::MarkerSymbol *symbols)
+{
+    for (size_t i = 0; i < scene.x.size(); ++i)
+    {
+        const ImGui::XP::MarkerSymbol &symbol = symbols[scene.symbols[i]];
+        if (Cull && !OnScreen(drawList, scene.x[i], scene.y[i], symbol))
+        {
+            continue;
+        }
+        const float c = std::cos(scene.rotations[i]), s = std::sin(scene.rotations[i]);
+        const float hx = symbol.size.x * 0.5f, hy = symbol.size.y * 0.5f;
+        const ImVec2 local[4] = {ImVec2(0.0f, -hy), ImVec2(hx, hy), ImVec2(0.0f, hy * 0.5f), ImVec2(-hx, hy)};
+        ImVec2 points[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            points[k] = ImVec2(scene.x[i] + local[k].x * c - local[k].y * s, scene.y[i] + local[k].x * s + local[k].y * c);
+        }
+        drawList->AddPolyline(points, 4, scene.colors[i], ImDrawFlags_Closed, 1.0f);
+    }
+}
+
+static void DrawMarkers(ImDrawList *drawList, const Scene &scene, const ImGui::XP::MarkerSymbol *symbols)
+{
+    ImGui::XP::MarkerBatch batch;
+    batch.x = scene.x.data();
+    batch.y = scene.y.data();
+    batch.rotations = scene.rotations.data();
+    batch.colors = scene.colors.data();
+    batch.symbols = scene.symbols.data();
+    batch.count = static_cast<int>(scene.x.size());
+    ImGui::XP::AddMarkers(drawList, batch, symbols, 2);
+}
+
+template <typename Draw>
+static void RunBenchmark(const char *name, const Scene &scene, const ImGui::XP::MarkerSymbol *symbols, int frames, Draw draw)
+{
+    double seconds = 0.0;
+    int vertices = 0;
+    for (int frame = 0; frame < frames + 10; ++frame)
+    {
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+        ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+        ImGui::Begin("Traffic", nullptr, ImGuiWindowFlags_NoDecoration);
+        ImDrawList *drawList = ImGui::GetWindowDrawList();
+        const int verticesBefore = drawList->VtxBuffer.Size;
+
+        const auto start = std::chrono::steady_clock::now();
+        draw(drawList, scene, symbols);
+        const auto end = std::chrono::steady_clock::now();
+
+        // The first frames warm up caches and let the draw list reach its working size
+        if (frame >= 10)
+        {
+            seconds += std::chrono::duration<double>(end - start).count();
+        }
+        vertices = drawList->VtxBuffer.Size - verticesBefore;
+        ImGui::End();
+        ImGui::EndFrame();
+    }
+
+    const double usPerFrame = seconds * 1e6 / frames;
+    std::printf("%-18s %10.1f us/frame %8.1f ns/marker %8d vertices\n", name, usPerFrame, usPerFrame * 1000.0 / scene.x.size(), vertices);
+}
+
+int main(int argc, char **argv)
+{
+    const int count = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    ImGui::CreateContext();
+    ImGuiIO &io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+    io.DeltaTime = 1.0f / 60.0f;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset; // As the OpenGL3 backend sets on GL 3.2+
+    unsigned char *pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    ImGui::XP::MarkerSymbol symbols[2] = {ImGui::XP::SolidMarkerSymbol(ImVec2(12.0f, 16.0f)), ImGui::XP::SolidMarkerSymbol(ImVec2(8.0f, 8.0f))};
+    const Scene scene = MakeScene(count, io.DisplaySize);
+    std::printf("%d markers, %d frames\n", count, frames);
+
+    RunBenchmark("AddImageQuad", scene, symbols, frames, DrawImageQuads<false>);
+    RunBenchmark("AddImageQuad+cull", scene, symbols, frames, DrawImageQuads<true>);
+    RunBenchmark("AddPolyline", scene, symbols, frames, DrawPolylines<false>);
+    RunBenchmark("AddPolyline+cull", scene, symbols, frames, DrawPolylines<true>);
+    RunBenchmark("AddMarkers", scene, symbols, frames, DrawMarkers);
+
+    ImGui::DestroyContext();
+    return 0;
+}
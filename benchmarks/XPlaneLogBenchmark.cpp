@@ -0,0 +1,104 @@
+// Microbenchmark for the XPlaneLog formatter.
+// Reports messages/sec and heap allocations/message for the previous per-message
+// pattern formatter and the precompiled per-level XPlaneLog::Formatter.
+
+// Standard Library Headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// Third-Party Library Headers
+#include <spdlog/details/log_msg.h>
+#include <spdlog/pattern_formatter.h>
+
+// Project-Specific Headers
+#include "XPlaneLog.h"
+
+// Global allocation counter, fed by the replacement operators below. Every form of new and
+// delete is replaced together, so each allocation is freed by its matching function.
+static std::atomic<size_t> g_allocations{0};
+
+static void *CountedAlloc(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size) { return CountedAlloc(size); }
+void *operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+
+// The formatter as it was before levels were precompiled, kept here as the baseline
+class LegacyFormatter : public spdlog::formatter
+{
+public:
+    void format(const spdlog::details::log_msg &msg, spdlog::memory_buf_t &dest) override
+    {
+        std::string log_level = spdlog::level::to_string_view(msg.level).data();
+        std::transform(log_level.begin(), log_level.end(), log_level.begin(), ::toupper);
+        std::string pattern = "[%Y-%m-%d %H:%M:%S.%e] [%n] [" + log_level + "] %v";
+        spdlog::pattern_formatter formatter(pattern);
+        formatter.format(msg, dest);
+        std::string formatted_str = fmt::to_string(dest);
+        if (!formatted_str.empty())
+        {
+            formatted_str.erase(std::remove(formatted_str.begin(), formatted_str.end(), '\r'), formatted_str.end());
+            formatted_str.erase(std::remove(formatted_str.begin(), formatted_str.end(), '\n'), formatted_str.end());
+            formatted_str += '\n';
+        }
+        dest.clear();
+        fmt::format_to(std::back_inserter(dest), "{}", formatted_str);
+    }
+    std::unique_ptr<spdlog::formatter> clone() const override { return std::make_unique<LegacyFormatter>(*this); }
+};
+
+static void RunBenchmark(const char *name, spdlog::formatter &formatter, size_t iterations)
+{
+    const spdlog::details::log_msg msg("XPlaneImGuiPlugin", spdlog::level::debug, "Unrecognized virtual key: 42");
+    spdlog::memory_buf_t dest;
+
+    // Warm up caches and let the buffer reach its working size
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        dest.clear();
+        formatter.format(msg, dest);
+    }
+
+    const size_t allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        dest.clear();
+        formatter.format(msg, dest);
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    const size_t allocations = g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+    const double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::printf("%-24s %12.0f msgs/sec %8.2f allocs/msg\n", name, iterations / seconds,
+                static_cast<double>(allocations) / iterations);
+}
+
+int main(int argc, char **argv)
+{
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    LegacyFormatter legacy;
+    XPlaneLog::Formatter precompiled;
+
+    RunBenchmark("legacy formatter", legacy, iterations);
+    RunBenchmark("XPlaneLog::Formatter", precompiled, iterations);
+
+    return 0;
+}
@@ -0,0 +1,413 @@
+// Tests for ImGui::XP::TextureCache, driven with a fake uploader and file reader.
+// Checks least-recently-used eviction at the byte budget, that stale, cleared and failed loads are
+// dropped, and that uploads are sliced to uploadBytesPerFrame. Returns non-zero on failure.
+
+// Standard Library Headers
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Project-Specific Headers
+#include "imgui_impl_xplane_texture.h"
+#include "XPlaneLog.h"
+#include "XPlaneMetrics.h"
+
+using ImGui::XP::DecodedImage;
+using ImGui::XP::TextureCache;
+using ImGui::XP::TextureUploader;
+
+// Stand-ins for what the texture cache links against in the plugin: no logger (XPlaneLog::should_log()
+// is false without one), metrics that go nowhere, and no OpenGL
+std::shared_ptr<spdlog::logger> XPlaneLog::logger = nullptr;
+
+XPlaneMetrics::Counter &XPlaneMetrics::counter(const std::string &, const std::string &)
+{
+    static Counter counter;
+    return counter;
+}
+
+XPlaneMetrics::Gauge &XPlaneMetrics::gauge(const std::string &, const std::string &)
+{
+    static Gauge gauge;
+    return gauge;
+}
+
+int XPlaneMetrics::addCollector(std::function<void()>) { return 0; }
+void XPlaneMetrics::removeCollector(int) {}
+void XPlaneMetrics::Counter::syncTotal(uint64_t) {}
+
+std::unique_ptr<TextureUploader> ImGui::XP::CreateOpenGLTextureUploader() { return nullptr; }
+
+static int g_failures = 0;
+
+#define CHECK(condition)                                                              \
+    do                                                                                \
+    {                                                                                 \
+        if (!(condition))                                                             \
+        {                                                                             \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++g_failures;                                                             \
+        }                                                                             \
+    } while (0)
+
+// Files are "<width> <height>" in text, decoded by the decoder installed in main() to that many
+// RGBA8 pixels; "bad" does not decode. A path can be gated, so its read blocks until opened.
+class FakeFiles
+{
+public:
+    void add(const std::string &path, const std::string &contents)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_files[path] = contents;
+    }
+
+    void gate(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_gated.insert(path);
+    }
+
+    void open(const std::string &path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_gated.erase(path);
+        }
+        m_changed.notify_all();
+    }
+
+    // Blocks until a gated read has started
+    void waitForRead(const std::string &path)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [&]
+                       { return m_reads.count(path) != 0; });
+    }
+
+    int reads(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_reads.find(path);
+        return it == m_reads.end() ? 0 : it->second;
+    }
+
+    TextureCache::FileReader reader()
+    {
+        return [this](const std::string &path, std::vector<unsigned char> &out)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_reads[path];
+            m_changed.notify_all();
+            m_changed.wait(lock, [&]
+                           { return m_gated.count(path) == 0; });
+            auto it = m_files.find(path);
+            if (it == m_files.end())
+            {
+                return false;
+            }
+            out.assign(it->second.begin(), it->second.end());
+            return true;
+        };
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::map<std::string, std::string> m_files;
+    std::map<std::string, int> m_reads;
+    std::set<std::string> m_gated;
+};
+
+static bool DecodeFakeImage(const unsigned char *data, size_t size, DecodedImage &out)
+{
+    int width = 0, height = 0;
+    const std::string text(reinterpret_cast<const char *>(data), size);
+    if (std::sscanf(text.c_str(), "%d %d", &width, &height) != 2)
+    {
+        return false;
+    }
+    out.width = width;
+    out.height = height;
+    out.pixels.assign(static_cast<size_t>(width) * height * 4, 0xff);
+    return true;
+}
+
+// Hands out increasing ids and remembers what is alive. Images 3 pixels wide fail to upload.
+class FakeUploader : public TextureUploader
+{
+public:
+    ImTextureID upload(const DecodedImage &image) override
+    {
+        ++uploads;
+        if (image.width == 3)
+        {
+            return ImTextureID();
+        }
+        const intptr_t id = ++m_nextId;
+        alive[id] = image.pixels.size();
+        return (ImTextureID)id;
+    }
+
+    void destroy(ImTextureID texture) override
+    {
+        alive.erase((intptr_t)texture);
+        ++destroys;
+    }
+
+    int uploads = 0;
+    int destroys = 0;
+    std::map<intptr_t, size_t> alive;
+
+private:
+    intptr_t m_nextId = 0;
+};
+
+// Waits until the workers have queued count results for update(), counting failed reads and
+// decodes too. The timeout only keeps a broken cache from hanging the test.
+static void WaitForResults(const TextureCache &cache, size_t count)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (cache.stats().finishedDecodes < count)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            std::printf("Timed out waiting for %zu decode results\n", count);
+            ++g_failures;
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+static bool Resident(TextureCache &cache, const std::string &path)
+{
+    return cache.request(path) != ImTextureID();
+}
+
+// Budget of three 4x4 images; the fourth pushes the least recently used one out
+static void TestEvictsLeastRecentlyUsed()
+{
+    FakeFiles files;
+    for (const char *path : {"a", "b", "c", "d"})
+    {
+        files.add(path, "4 4");
+    }
+    FakeUploader uploader;
+    TextureCache::Options options;
+    options.vramBudget = 3 * 64;
+    options.workerThreads = 1;
+    TextureCache cache(uploader, options, files.reader());
+
+    for (const char *path : {"a", "b", "c", "d"})
+    {
+        cache.request(path);
+    }
+    WaitForResults(cache, 4);
+    for (const char *path : {"a", "b", "c", "d"})
+    {
+        cache.request(path);
+    }
+    cache.update();
+    CHECK(cache.stats().uploads == 4);
+    // Over budget, but everything was drawn in the last two frames
+    CHECK(cache.stats().evictions == 0);
+    CHECK(cache.stats().residentBytes == 4 * 64);
+
+    // b drops out of use; a, the oldest upload, stays because it is still drawn
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        for (const char *path : {"a", "c", "d"})
+        {
+            CHECK(Resident(cache, path));
+        }
+        cache.update();
+    }
+    const TextureCache::Stats stats = cache.stats();
+    CHECK(stats.evictions == 1);
+    CHECK(stats.residentCount == 3);
+    CHECK(stats.residentBytes == options.vramBudget);
+    CHECK(uploader.alive.size() == 3);
+    // Evicted textures load again on request
+    CHECK(!Resident(cache, "b"));
+    WaitForResults(cache, 1);
+    CHECK(files.reads("b") == 2);
+}
+
+// Files nobody asks for any more are dropped while queued or while waiting to upload
+static void TestDropsStaleLoads()
+{
+    FakeFiles files;
+    for (const char *path : {"blocker", "queued", "p1", "p2", "p3"})
+    {
+        files.add(path, "4 4");
+    }
+    FakeUploader uploader;
+    TextureCache::Options options;
+    options.workerThreads = 1;
+    options.staleFrames = 1;
+    options.uploadBytesPerFrame = 1; // One upload per frame
+    {
+        TextureCache cache(uploader, options, files.reader());
+
+        // The only worker is stuck on "blocker", so "queued" waits in the queue
+        files.gate("blocker");
+        cache.request("blocker");
+        files.waitForRead("blocker");
+        cache.request("queued");
+        CHECK(cache.stats().queuedDecodes == 1);
+        cache.update();
+        cache.update();
+        CHECK(cache.stats().queuedDecodes == 0);
+        files.open("blocker");
+        WaitForResults(cache, 1);
+        CHECK(files.reads("queued") == 0);
+    }
+    {
+        TextureCache cache(uploader, options, files.reader());
+        cache.request("p1");
+        cache.request("p2");
+        cache.request("p3");
+        WaitForResults(cache, 3);
+        const int uploadsBefore = uploader.uploads;
+        cache.update(); // p1 uploaded
+        cache.update(); // p2 uploaded; p3 has gone stale waiting for its turn
+        CHECK(uploader.uploads - uploadsBefore == 2);
+        CHECK(cache.stats().pendingUploads == 0);
+        cache.update();
+        CHECK(uploader.uploads - uploadsBefore == 2);
+        // Dropped, so asking again reads the file again
+        CHECK(!Resident(cache, "p3"));
+        WaitForResults(cache, 1);
+        CHECK(files.reads("p3") == 2);
+    }
+    CHECK(uploader.alive.empty());
+}
+
+// A decode that finishes after clear() belongs to an entry that no longer exists
+static void TestDropsResultsFromBeforeClear()
+{
+    FakeFiles files;
+    files.add("slow", "4 4");
+    FakeUploader uploader;
+    TextureCache::Options options;
+    options.workerThreads = 1;
+    TextureCache cache(uploader, options, files.reader());
+
+    files.gate("slow");
+    cache.request("slow");
+    files.waitForRead("slow");
+    cache.clear();
+    cache.request("slow"); // A new entry, queued behind the first read
+    files.open("slow");
+    WaitForResults(cache, 2);
+    cache.request("slow");
+    cache.update();
+    CHECK(uploader.uploads == 1);
+    CHECK(cache.stats().residentCount == 1);
+    CHECK(files.reads("slow") == 2);
+}
+
+// Unreadable, undecodable and unuploadable files fail once and stay failed
+static void TestFailedLoads()
+{
+    FakeFiles files;
+    files.add("bad", "bad");
+    files.add("no_upload", "3 3");
+    FakeUploader uploader;
+    TextureCache::Options options;
+    options.workerThreads = 2;
+    TextureCache cache(uploader, options, files.reader());
+
+    for (const char *path : {"missing", "bad", "no_upload"})
+    {
+        cache.request(path);
+    }
+    WaitForResults(cache, 3);
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        for (const char *path : {"missing", "bad", "no_upload"})
+        {
+            bool failed = false;
+            CHECK(cache.request(path, nullptr, &failed) == ImTextureID());
+        }
+        cache.update();
+    }
+    for (const char *path : {"missing", "bad", "no_upload"})
+    {
+        bool failed = false;
+        cache.request(path, nullptr, &failed);
+        CHECK(failed);
+        CHECK(files.reads(path) == 1);
+    }
+    CHECK(cache.stats().failures == 3);
+    CHECK(cache.stats().residentCount == 0);
+    CHECK(uploader.uploads == 1); // Only no_upload got as far as the uploader
+}
+
+// Each frame uploads until uploadBytesPerFrame is reached, and always at least one image
+static void TestUploadTimeSlice()
+{
+    FakeFiles files;
+    const std::vector<std::string> paths = {"s1", "s2", "s3", "s4", "s5", "s6"};
+    for (const std::string &path : paths)
+    {
+        files.add(path, "4 4");
+    }
+    files.add("large", "64 64");
+    FakeUploader uploader;
+    TextureCache::Options options;
+    options.uploadBytesPerFrame = 2 * 64;
+    TextureCache cache(uploader, options, files.reader());
+
+    for (const std::string &path : paths)
+    {
+        cache.request(path);
+    }
+    WaitForResults(cache, paths.size());
+    std::vector<int> perFrame;
+    while (uploader.uploads < static_cast<int>(paths.size()) && perFrame.size() < 10)
+    {
+        const int before = uploader.uploads;
+        for (const std::string &path : paths)
+        {
+            cache.request(path);
+        }
+        cache.update();
+        perFrame.push_back(uploader.uploads - before);
+    }
+    CHECK(perFrame == std::vector<int>({2, 2, 2}));
+
+    // An image larger than the slice still goes up, on its own
+    cache.request("large");
+    cache.request("s1");
+    WaitForResults(cache, 1);
+    const int before = uploader.uploads;
+    cache.request("large");
+    cache.update();
+    CHECK(uploader.uploads - before == 1);
+    CHECK(Resident(cache, "large"));
+}
+
+int main()
+{
+    ImGui::XP::SetImageDecoder(DecodeFakeImage);
+
+    for (void (*test)() : {TestEvictsLeastRecentlyUsed, TestDropsStaleLoads, TestDropsResultsFromBeforeClear, TestFailedLoads, TestUploadTimeSlice})
+    {
+        test();
+    }
+
+    if (g_failures)
+    {
+        std::printf("%d checks failed\n", g_failures);
+        return 1;
+    }
+    std::printf("All TextureCache tests passed\n");
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Decodes a crash flight recorder file (<plugin>.flight or <plugin>.flight.prev) written by
+// XPlaneLogFlightRecorderSink and prints its records oldest first, in the XPlaneLog text format.
+//
+// Usage: FlightRecorderDecode <file.flight> [max records]
+
+// Standard Library Headers
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <vector>
+
+// Project-Specific Headers
+#include "XPlaneFlightRecorder.h"
+
+using namespace XPlaneFlightRecorderFormat;
+
+// Same order as spdlog::level::level_enum
+static const char *kLevelNames[] = {"TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL", "OFF"};
+
+struct DecodedRecord
+{
+    uint64_t sequence;
+    const RecordHeader *header;
+    const char *payload;
+};
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <file.flight> [max records]\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(FileHeader))
+    {
+        std::fprintf(stderr, "File too small to be a flight recording\n");
+        return 1;
+    }
+
+    const FileHeader *header = reinterpret_cast<const FileHeader *>(data.data());
+    if (header->magic != kMagic || header->version != kVersion)
+    {
+        std::fprintf(stderr, "Not a version %u flight recording\n", kVersion);
+        return 1;
+    }
+    if (header->slotSize < sizeof(RecordHeader) || data.size() < sizeof(FileHeader) + static_cast<size_t>(header->slotCount) * header->slotSize)
+    {
+        std::fprintf(stderr, "Truncated flight recording\n");
+        return 1;
+    }
+
+    // Collect every committed record whose sequence number matches the slot it is in
+    std::vector<DecodedRecord> records;
+    size_t torn = 0;
+    const char *slots = data.data() + sizeof(FileHeader);
+    for (uint32_t i = 0; i < header->slotCount; ++i)
+    {
+        const char *slot = slots + static_cast<size_t>(i) * header->slotSize;
+        const RecordHeader *record = reinterpret_cast<const RecordHeader *>(slot);
+        const uint64_t committed = record->committed.load(std::memory_order_relaxed);
+        if (committed == 0)
+        {
+            continue;
+        }
+
+        const uint64_t sequence = committed - 1;
+        if (sequence % header->slotCount != i || record->length > header->slotSize - sizeof(RecordHeader))
+        {
+            ++torn;
+            continue;
+        }
+        records.push_back({sequence, record, slot + sizeof(RecordHeader)});
+    }
+
+    std::sort(records.begin(), records.end(), [](const DecodedRecord &a, const DecodedRecord &b)
+              { return a.sequence < b.sequence; });
+
+    size_t first = 0;
+    if (argc > 2)
+    {
+        const size_t maxRecords = std::strtoull(argv[2], nullptr, 10);
+        if (records.size() > maxRecords)
+        {
+            first = records.size() - maxRecords;
+        }
+    }
+
+    for (size_t i = first; i < records.size(); ++i)
+    {
+        const RecordHeader *record = records[i].header;
+
+        const time_t seconds = static_cast<time_t>(record->timestampNs / 1000000000);
+        const int milliseconds = static_cast<int>((record->timestampNs / 1000000) % 1000);
+        char timeText[32];
+        std::strftime(timeText, sizeof(timeText), "%Y-%m-%d %H:%M:%S", std::localtime(&seconds));
+
+        const char *levelName = record->level < sizeof(kLevelNames) / sizeof(kLevelNames[0]) ? kLevelNames[record->level] : "?";
+        std::printf("[%s.%03d] [%llu] [%s] %.*s\n", timeText, milliseconds, static_cast<unsigned long long>(record->threadId),
+                    levelName, static_cast<int>(record->length), records[i].payload);
+    }
+
+    std::fprintf(stderr, "%zu records (%llu written in total), %zu incomplete\n", records.size(),
+                 static_cast<unsigned long long>(header->nextSequence.load(std::memory_order_relaxed)), torn);
+    return 0;
+}
@@ -0,0 +1,209 @@
+// Decodes a binary structured log (<plugin>.binlog) written by XPlaneLogStructured and prints
+// one text line per record, formatting each registered format string with its recorded arguments.
+// Records are printed in file order, which is per-thread chunk order; pass --sort to order by time.
+//
+// Usage: StructuredLogDecode <file.binlog> [--sort]
+
+// Standard Library Headers
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Third-Party Library Headers
+#include <spdlog/fmt/fmt.h>
+#if defined(SPDLOG_FMT_EXTERNAL)
+#include <fmt/args.h>
+#else
+#include <spdlog/fmt/bundled/args.h>
+#endif
+
+// Project-Specific Headers
+#include "XPlaneStructuredLog.h"
+
+using namespace XPlaneStructuredLogFormat;
+
+struct FormatDefinition
+{
+    std::string argTypes;
+    std::string format;
+};
+
+struct DecodedLine
+{
+    int64_t timestampNs;
+    uint64_t threadId;
+    std::string text;
+};
+
+template <typename T>
+static T Read(const char *data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+// Formats one record; returns false if it does not match its definition
+static bool DecodeRecord(const FormatDefinition &definition, const char *args, const char *end, std::string &text)
+{
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+
+    for (char type : definition.argTypes)
+    {
+        size_t size = 0;
+        switch (type)
+        {
+        case Arg_Int32:
+        case Arg_UInt32:
+        case Arg_Float:
+            size = 4;
+            break;
+        case Arg_Int64:
+        case Arg_UInt64:
+        case Arg_Double:
+            size = 8;
+            break;
+        case Arg_Bool:
+        case Arg_Char:
+            size = 1;
+            break;
+        case Arg_String:
+            if (args + sizeof(uint16_t) > end)
+                return false;
+            size = sizeof(uint16_t) + Read<uint16_t>(args);
+            break;
+        default:
+            return false;
+        }
+        if (args + size > end)
+        {
+            return false;
+        }
+
+        switch (type)
+        {
+        case Arg_Int32: store.push_back(Read<int32_t>(args)); break;
+        case Arg_UInt32: store.push_back(Read<uint32_t>(args)); break;
+        case Arg_Int64: store.push_back(Read<int64_t>(args)); break;
+        case Arg_UInt64: store.push_back(Read<uint64_t>(args)); break;
+        case Arg_Float: store.push_back(Read<float>(args)); break;
+        case Arg_Double: store.push_back(Read<double>(args)); break;
+        case Arg_Bool: store.push_back(*args != 0); break;
+        case Arg_Char: store.push_back(*args); break;
+        case Arg_String: store.push_back(std::string(args + sizeof(uint16_t), size - sizeof(uint16_t))); break;
+        }
+        args += size;
+    }
+
+    try
+    {
+        text = fmt::vformat(definition.format, store);
+    }
+    catch (const fmt::format_error &error)
+    {
+        text = definition.format + "  <format error: " + error.what() + ">";
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <file.binlog> [--sort]\n", argv[0]);
+        return 1;
+    }
+    const bool sortByTime = argc > 2 && std::strcmp(argv[2], "--sort") == 0;
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(FileHeader) || Read<FileHeader>(data.data()).magic != kMagic || Read<FileHeader>(data.data()).version != kVersion)
+    {
+        std::fprintf(stderr, "Not a version %u structured log\n", kVersion);
+        return 1;
+    }
+
+    std::unordered_map<uint32_t, FormatDefinition> definitions;
+    std::vector<DecodedLine> lines;
+    size_t malformed = 0;
+
+    const char *cursor = data.data() + sizeof(FileHeader);
+    const char *fileEnd = data.data() + data.size();
+    while (cursor + sizeof(BlockHeader) <= fileEnd)
+    {
+        const BlockHeader block = Read<BlockHeader>(cursor);
+        const char *payload = cursor + sizeof(BlockHeader);
+        const char *blockEnd = payload + block.size;
+        if (blockEnd > fileEnd)
+        {
+            std::fprintf(stderr, "Truncated block at offset %zu\n", static_cast<size_t>(cursor - data.data()));
+            break;
+        }
+
+        if (block.type == Block_FormatDefinition)
+        {
+            const uint32_t id = Read<uint32_t>(payload);
+            const uint32_t argCount = Read<uint32_t>(payload + 4);
+            const char *argTypes = payload + 8;
+            const uint32_t formatLength = Read<uint32_t>(argTypes + argCount);
+            definitions[id] = {std::string(argTypes, argCount), std::string(argTypes + argCount + 4, formatLength)};
+        }
+        else if (block.type == Block_Records)
+        {
+            const char *record = payload;
+            while (record + sizeof(RecordHeader) <= blockEnd)
+            {
+                const RecordHeader header = Read<RecordHeader>(record);
+                if (header.size < sizeof(RecordHeader) || record + header.size > blockEnd)
+                {
+                    ++malformed;
+                    break;
+                }
+
+                DecodedLine line{header.timestampNs, block.threadId, {}};
+                auto definition = definitions.find(header.formatId);
+                if (definition == definitions.end() ||
+                    !DecodeRecord(definition->second, record + sizeof(RecordHeader), record + header.size, line.text))
+                {
+                    ++malformed;
+                }
+                else
+                {
+                    lines.push_back(std::move(line));
+                }
+                record += header.size;
+            }
+        }
+
+        cursor = blockEnd;
+    }
+
+    if (sortByTime)
+    {
+        std::stable_sort(lines.begin(), lines.end(), [](const DecodedLine &a, const DecodedLine &b)
+                         { return a.timestampNs < b.timestampNs; });
+    }
+
+    for (const DecodedLine &line : lines)
+    {
+        const time_t seconds = static_cast<time_t>(line.timestampNs / 1000000000);
+        const int microseconds = static_cast<int>((line.timestampNs / 1000) % 1000000);
+        char timeText[32];
+        std::strftime(timeText, sizeof(timeText), "%Y-%m-%d %H:%M:%S", std::localtime(&seconds));
+        std::printf("[%s.%06d] [%llu] %s\n", timeText, microseconds, static_cast<unsigned long long>(line.threadId), line.text.c_str());
+    }
+
+    std::fprintf(stderr, "%zu records, %zu formats, %zu malformed\n", lines.size(), definitions.size(), malformed);
+    return 0;
+}
@@ -0,0 +1,237 @@
+// Prints the metrics a running plugin publishes to its shared-memory telemetry segment
+// (XPlaneTelemetryPublisher). Reads the mapped segment directly; the plugin is never blocked.
+//
+// Usage: TelemetryReader <plugin name> [--watch ms] [filter]
+//   --watch ms  Reprint every ms milliseconds until the plugin stops
+//   filter      Only print metrics whose name contains this text
+
+// Platform Headers
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX // Keep std::min and std::max usable
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Standard Library Headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Project-Specific Headers
+#include "XPlaneTelemetry.h"
+
+using namespace XPlaneTelemetryFormat;
+
+// Read-only mapping of a segment created by the plugin
+class SharedSegment
+{
+public:
+    ~SharedSegment()
+    {
+#ifdef _WIN32
+        if (m_data)
+            UnmapViewOfFile(m_data);
+        if (m_mapping)
+            CloseHandle(m_mapping);
+#else
+        if (m_data)
+            munmap(const_cast<void *>(m_data), m_size);
+#endif
+    }
+
+    bool open(const std::string &name)
+    {
+#ifdef _WIN32
+        m_mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+        if (!m_mapping)
+            return false;
+        m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!m_data)
+            return false;
+        MEMORY_BASIC_INFORMATION info;
+        VirtualQuery(m_data, &info, sizeof(info));
+        m_size = info.RegionSize;
+#else
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SegmentHeader)))
+        {
+            ::close(fd);
+            return false;
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        void *data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+            return false;
+        m_data = data;
+#endif
+        return true;
+    }
+
+    const void *data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const void *m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    HANDLE m_mapping = nullptr;
+#endif
+};
+
+// Copies a consistent set of entries, retrying while the plugin is mid-publish.
+// Returns false if no consistent copy was obtained.
+static bool ReadEntries(const SegmentHeader *header, const Entry *entries, std::vector<Entry> &out, int64_t &publishTimeNs)
+{
+    for (int attempt = 0; attempt < 1000; ++attempt)
+    {
+        const uint64_t before = header->sequence.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const uint32_t count = std::min(header->entryCount.load(std::memory_order_acquire), header->entryCapacity);
+        out.assign(entries, entries + count);
+        publishTimeNs = header->publishTimeNs;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header->sequence.load(std::memory_order_relaxed) == before)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char *KindName(Kind kind)
+{
+    switch (kind)
+    {
+    case Kind::Counter:
+        return "counter";
+    case Kind::Gauge:
+        return "gauge";
+    case Kind::Histogram:
+        return "histogram";
+    }
+    return "?";
+}
+
+static void PrintEntries(const SegmentHeader *header, const std::vector<Entry> &entries, int64_t publishTimeNs, const char *filter)
+{
+    const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::printf("%s (pid %u), published %.1f s ago, %zu metrics\n", header->pluginName, header->processId, (nowNs - publishTimeNs) / 1e9, entries.size());
+    for (const Entry &entry : entries)
+    {
+        char name[sizeof(entry.name) + 1] = {};
+        char unit[sizeof(entry.unit) + 1] = {};
+        std::memcpy(name, entry.name, sizeof(entry.name));
+        std::memcpy(unit, entry.unit, sizeof(entry.unit));
+        if (filter && !std::strstr(name, filter))
+        {
+            continue;
+        }
+        std::printf("  %-48s %-9s %16.3f %s\n", name, KindName(entry.kind), entry.value, unit);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <plugin name> [--watch ms] [filter]\n", argv[0]);
+        return 1;
+    }
+
+    int watchMs = 0;
+    const char *filter = nullptr;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--watch") == 0 && i + 1 < argc)
+        {
+            watchMs = std::max(1, std::atoi(argv[++i]));
+        }
+        else
+        {
+            filter = argv[i];
+        }
+    }
+
+    const std::string name = SegmentName(argv[1]);
+    SharedSegment segment;
+    if (!segment.open(name))
+    {
+        std::fprintf(stderr, "Cannot open telemetry segment %s; is the plugin running?\n", name.c_str());
+        return 1;
+    }
+
+    const SegmentHeader *header = static_cast<const SegmentHeader *>(segment.data());
+    if (header->magic != kMagic || header->version != kVersion || header->headerSize != sizeof(SegmentHeader) || header->entrySize != sizeof(Entry))
+    {
+        std::fprintf(stderr, "%s is not a version %u telemetry segment\n", name.c_str(), kVersion);
+        return 1;
+    }
+    if (segment.size() < SegmentSize(header->entryCapacity))
+    {
+        std::fprintf(stderr, "Telemetry segment %s is truncated\n", name.c_str());
+        return 1;
+    }
+
+    const Entry *entries = reinterpret_cast<const Entry *>(static_cast<const char *>(segment.data()) + sizeof(SegmentHeader));
+    std::vector<Entry> copy;
+    int64_t publishTimeNs = 0;
+    int64_t lastPublishTimeNs = 0;
+    auto lastChange = std::chrono::steady_clock::now();
+    while (true)
+    {
+        if (!ReadEntries(header, entries, copy, publishTimeNs))
+        {
+            std::fprintf(stderr, "Could not get a consistent read of %s\n", name.c_str());
+            return 1;
+        }
+        PrintEntries(header, copy, publishTimeNs, filter);
+
+        if (header->closed.load(std::memory_order_acquire))
+        {
+            std::printf("Plugin stopped; these are its last values\n");
+            return 0;
+        }
+        if (watchMs == 0)
+        {
+            return 0;
+        }
+
+        // A segment replaced by a new session, or left by a crashed one, stops updating
+        auto now = std::chrono::steady_clock::now();
+        if (publishTimeNs != lastPublishTimeNs)
+        {
+            lastPublishTimeNs = publishTimeNs;
+            lastChange = now;
+        }
+        else if (now - lastChange > std::chrono::milliseconds(10 * std::max<uint32_t>(header->publishIntervalMs, 100)))
+        {
+            std::printf("No updates for a while; the plugin may have crashed or restarted\n");
+            return 0;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+        std::printf("\n");
+    }
+}